@@ -356,4 +356,82 @@ BOOST_FIXTURE_TEST_CASE(storage_benchmark, CommunicationFixture)
             }
         }
     }
-}
\ No newline at end of file
+}
+
+BOOST_FIXTURE_TEST_CASE(simulated_network_propagation, CommunicationFixture)
+{
+    // links with 50 ms latency, up to 20 ms of jitter and 10 MB/s bandwidth
+    simulatedNetwork = std::make_shared<SimulatedNetwork>(1, SimulatedLink{
+        .latency = chrono::milliseconds(50),
+        .jitter = chrono::milliseconds(20),
+        .bandwidth = 10 * 1024 * 1024
+    });
+
+    {
+        TimeTester p("Adding 50 instances");
+        addInstances(50);
+    }
+
+    // mine kMinersQueueSize blocks to change next miner
+    mineAndAddBlock(blockchains[0]->getLatestBlockId() + kMinersQueueSize);
+    BOOST_TEST_REQUIRE(synchronizeInstances(120));
+
+    for (size_t i = 0; i < 10; ++i) {
+        TimeTester p("Block propagation to 50 instances, round "s + std::to_string(i + 1) + " of 10"s);
+        BOOST_TEST_REQUIRE(mineAndAddBlock(blockchains[0]->getLatestBlockId() + 1));
+        BOOST_TEST_REQUIRE(synchronizeInstances(60));
+    }
+
+    std::vector<Transaction_cptr> transactions;
+    for (auto& privateKey : PrivateKey::generate(1024)) {
+        auto transaction = CreateUserTransaction::create(blockchains[0]->getExpectedBlockId(), -1,
+                                                         privateKey.publicKey(), kUserMinFreeTransactions)->
+            setUserId(blockchains[0]->getUserId())->sign({ blockchains[0]->getMinerKey() });
+        transactions.push_back(transaction);
+    }
+
+    {
+        TimeTester p("Transaction propagation of "s + std::to_string(transactions.size()) + " transactions"s);
+        BOOST_TEST_REQUIRE(blockchains[0]->postTransactions(transactions));
+        BOOST_TEST_REQUIRE(synchronizeTransactions(60, transactions));
+    }
+
+    // split network into two halves, blocks mined in one half aren't seen in other, so they create forks
+    std::vector<Endpoint> firstHalf(endpoints.begin(), endpoints.begin() + endpoints.size() / 2);
+    std::vector<Endpoint> secondHalf(endpoints.begin() + endpoints.size() / 2, endpoints.end());
+    simulatedNetwork->partition({ firstHalf, secondHalf });
+
+    for (size_t i = 1, blockId = blockchains[0]->getLatestBlockId(); i <= 10; ++i) {
+        BOOST_TEST_REQUIRE(mineAndAddBlock(blockId + i));
+    }
+    std::this_thread::sleep_for(chrono::seconds(5));
+
+    std::vector<Hash> headHashes;
+    for (auto& blockchain : blockchains) {
+        headHashes.push_back(blockchain->getBlockTree().getActiveBranch().back().block->getHeaderHash());
+    }
+
+    simulatedNetwork->heal();
+    for (auto& communication : communications) {
+        communication->closeAllConnections();
+    }
+
+    {
+        TimeTester p("Synchronizing instances after partition");
+        BOOST_TEST_REQUIRE(synchronizeInstances(120));
+    }
+
+    // instances which had to change branch were on a fork
+    std::set<Hash> activeBranch;
+    for (auto& node : blockchains[0]->getBlockTree().getActiveBranch()) {
+        activeBranch.insert(node.getHeaderHash());
+    }
+    size_t forkedInstances = 0;
+    for (auto& headHash : headHashes) {
+        if (!activeBranch.contains(headHash)) {
+            forkedInstances += 1;
+        }
+    }
+    BOOST_TEST_MESSAGE("Instances on abandoned fork: "s << forkedInstances << " of "s << blockchains.size());
+    BOOST_TEST_MESSAGE("Simulated network: "s << simulatedNetwork->getDebugInfo().dump());
+}
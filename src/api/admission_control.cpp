@@ -0,0 +1,132 @@
+#include "pch.h"
+
+#include "admission_control.h"
+
+namespace logpass {
+
+AdmissionControl::AdmissionControl(size_t addressRate, size_t userRate) :
+    m_addressRate(addressRate), m_userRate(userRate)
+{}
+
+template<typename Key>
+AdmissionControl::Bucket& AdmissionControl::getBucket(std::map<Key, Bucket>& buckets, const Key& key, size_t rate,
+                                                      chrono::steady_clock::time_point now)
+{
+    double capacity = (double)(rate * BURST_SECONDS);
+    auto [it, inserted] = buckets.try_emplace(key, Bucket{ .tokens = capacity, .lastUpdate = now });
+    Bucket& bucket = it->second;
+    if (!inserted && now > bucket.lastUpdate) {
+        double elapsed = chrono::duration<double>(now - bucket.lastUpdate).count();
+        bucket.tokens = std::min(capacity, bucket.tokens + elapsed * rate);
+        bucket.lastUpdate = now;
+    }
+    return bucket;
+}
+
+template<typename Key>
+void AdmissionControl::removeFullBuckets(std::map<Key, Bucket>& buckets, size_t rate,
+                                         chrono::steady_clock::time_point now)
+{
+    double capacity = (double)(rate * BURST_SECONDS);
+    std::erase_if(buckets, [&](const auto& it) {
+        double elapsed = chrono::duration<double>(now - it.second.lastUpdate).count();
+        return it.second.tokens + elapsed * rate >= capacity;
+    });
+}
+
+AdmissionControl::Result AdmissionControl::admit(const std::string& address, const std::vector<UserId>& userIds,
+                                                 size_t maxInFlight, size_t maxTransactions,
+                                                 chrono::steady_clock::time_point now)
+{
+    auto reject = [&](Result result) {
+        m_rejected[(size_t)result] += 1;
+        return result;
+    };
+
+    std::map<UserId, size_t> userTransactions;
+    if (m_userRate != 0) {
+        for (auto& userId : userIds) {
+            userTransactions[userId] += 1;
+        }
+    }
+
+    // such transactions would be rejected even by full buckets or idle node
+    if (userIds.size() > maxTransactions) {
+        return reject(Result::EXCEEDS_CAPACITY);
+    }
+    if (m_addressRate != 0 && userIds.size() > getAddressCapacity()) {
+        return reject(Result::EXCEEDS_CAPACITY);
+    }
+    for (auto& [userId, transactions] : userTransactions) {
+        if (transactions > getUserCapacity()) {
+            return reject(Result::EXCEEDS_CAPACITY);
+        }
+    }
+
+    std::lock_guard lock(m_mutex);
+    if (now - m_lastCleanup >= CLEANUP_INTERVAL) {
+        removeFullBuckets(m_addressBuckets, m_addressRate, now);
+        removeFullBuckets(m_userBuckets, m_userRate, now);
+        m_lastCleanup = now;
+    }
+
+    // tokens are taken only when every check passes, tokens of users are taken after verification
+    Bucket* addressBucket = nullptr;
+    if (m_addressRate != 0) {
+        addressBucket = &getBucket(m_addressBuckets, address, m_addressRate, now);
+        if (addressBucket->tokens < userIds.size()) {
+            return reject(Result::ADDRESS_RATE_LIMITED);
+        }
+    }
+
+    for (auto& [userId, transactions] : userTransactions) {
+        if (getBucket(m_userBuckets, userId, m_userRate, now).tokens < transactions) {
+            return reject(Result::USER_RATE_LIMITED);
+        }
+    }
+
+    if (m_inFlight + userIds.size() > maxInFlight) {
+        return reject(Result::TOO_MANY_IN_FLIGHT);
+    }
+
+    if (addressBucket) {
+        addressBucket->tokens -= userIds.size();
+    }
+    m_inFlight += userIds.size();
+    m_admitted += userIds.size();
+    return Result::ADMITTED;
+}
+
+void AdmissionControl::chargeUsers(const std::vector<UserId>& userIds, chrono::steady_clock::time_point now)
+{
+    if (m_userRate == 0 || userIds.empty()) {
+        return;
+    }
+
+    std::lock_guard lock(m_mutex);
+    for (auto& userId : userIds) {
+        getBucket(m_userBuckets, userId, m_userRate, now).tokens -= 1;
+    }
+}
+
+void AdmissionControl::release(size_t transactions)
+{
+    ASSERT(m_inFlight >= transactions);
+    m_inFlight -= transactions;
+}
+
+json AdmissionControl::getDebugInfo() const
+{
+    return {
+        {"in_flight", m_inFlight.load()},
+        {"admitted", m_admitted.load()},
+        {"rejected", {
+            {"address_rate", m_rejected[(size_t)Result::ADDRESS_RATE_LIMITED].load()},
+            {"user_rate", m_rejected[(size_t)Result::USER_RATE_LIMITED].load()},
+            {"in_flight", m_rejected[(size_t)Result::TOO_MANY_IN_FLIGHT].load()},
+            {"capacity", m_rejected[(size_t)Result::EXCEEDS_CAPACITY].load()}
+        }}
+    };
+}
+
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+namespace logpass {
+
+// thread-safe admission of posted transactions, checked on api thread before transactions are passed to blockchain,
+// limits rate of transactions from single address and single user (token buckets) and number of transactions
+// posted to blockchain which didn't get result yet
+class AdmissionControl {
+public:
+    enum class Result : uint8_t {
+        ADMITTED,
+        ADDRESS_RATE_LIMITED,
+        USER_RATE_LIMITED,
+        TOO_MANY_IN_FLIGHT,
+        // more transactions than bucket can ever hold, they will never be admitted
+        EXCEEDS_CAPACITY
+    };
+
+    // bucket holds tokens for BURST_SECONDS of transactions
+    static constexpr size_t BURST_SECONDS = 5;
+    // min interval between removals of full buckets
+    static constexpr chrono::seconds CLEANUP_INTERVAL = chrono::seconds(10);
+
+    // rates are numbers of transactions per second, 0 means unlimited
+    AdmissionControl(size_t addressRate, size_t userRate);
+    AdmissionControl(const AdmissionControl&) = delete;
+    AdmissionControl& operator=(const AdmissionControl&) = delete;
+
+    // admits transactions of given users (one id per transaction) posted from given address, transactions are
+    // admitted only if all of them can be admitted, maxInFlight is limit of admitted transactions which were not
+    // released yet, every admitted transaction must be released, EXCEEDS_CAPACITY is returned for transactions
+    // which can't be admitted at any time, e.g. more than maxTransactions
+    // tokens of users are only checked, user ids are not verified yet, so they are taken later by chargeUsers
+    Result admit(const std::string& address, const std::vector<UserId>& userIds, size_t maxInFlight,
+                 size_t maxTransactions, chrono::steady_clock::time_point now = chrono::steady_clock::now());
+    // takes tokens of users of admitted transactions with verified signatures, bucket can go below zero
+    void chargeUsers(const std::vector<UserId>& userIds,
+                     chrono::steady_clock::time_point now = chrono::steady_clock::now());
+    // releases admitted transactions which got result
+    void release(size_t transactions);
+
+    size_t getInFlight() const
+    {
+        return m_inFlight.load();
+    }
+
+    // max number of transactions from single address admitted at once, 0 means unlimited
+    size_t getAddressCapacity() const
+    {
+        return m_addressRate * BURST_SECONDS;
+    }
+
+    // max number of transactions of single user admitted at once, 0 means unlimited
+    size_t getUserCapacity() const
+    {
+        return m_userRate * BURST_SECONDS;
+    }
+
+    json getDebugInfo() const;
+
+private:
+    struct Bucket {
+        double tokens;
+        chrono::steady_clock::time_point lastUpdate;
+    };
+
+    // returns bucket with tokens refilled up to given time, new bucket is full
+    template<typename Key>
+    Bucket& getBucket(std::map<Key, Bucket>& buckets, const Key& key, size_t rate,
+                      chrono::steady_clock::time_point now);
+    // removes buckets which would be full, they are the same as new ones
+    template<typename Key>
+    void removeFullBuckets(std::map<Key, Bucket>& buckets, size_t rate, chrono::steady_clock::time_point now);
+
+    const size_t m_addressRate;
+    const size_t m_userRate;
+
+    std::mutex m_mutex;
+    std::map<std::string, Bucket> m_addressBuckets;
+    std::map<UserId, Bucket> m_userBuckets;
+    chrono::steady_clock::time_point m_lastCleanup;
+
+    std::atomic<size_t> m_inFlight = 0;
+    std::atomic<uint64_t> m_admitted = 0;
+    // number of rejections for every result other than ADMITTED
+    std::array<std::atomic<uint64_t>, 5> m_rejected{};
+};
+
+}
@@ -2,12 +2,16 @@
 
 #include "api.h"
 #include <blockchain/transactions/storage/add_entry.h>
+#include <blockchain/transactions/storage/create_prefix.h>
+#include <blockchain/transactions/storage/update_prefix.h>
 
 namespace logpass {
 
 Api::Api(const ApiOptions& options, const std::shared_ptr<Blockchain>& blockchain,
          const std::shared_ptr<const Database>& database, const std::shared_ptr<const Communication>& communication) :
-    m_options(options), m_blockchain(blockchain), m_database(database), m_communication(communication)
+    m_options(options), m_blockchain(blockchain), m_database(database), m_communication(communication),
+    m_responseCache(options.cacheSize * 1024 * 1024),
+    m_admissionControl(options.addressTransactionsRate, options.userTransactionsRate)
 {
     ASSERT(m_options.port != 0);
 
@@ -20,41 +24,27 @@ void Api::start()
 {
     std::unique_lock<std::shared_mutex> lock(m_mutex);
     std::condition_variable_any cv;
+    size_t startedWorkers = 0;
 
-    m_thread = std::thread([this, &cv] {
-        SET_THREAD_NAME("api");
-        m_mutex.lock();
-        m_loop = uWS::Loop::get();
-
-        ApiServer server = configureServer().listen(m_options.host, m_options.port, [this](bool success) {
-            if (success) {
-                LOG_CLASS(info) << "API started on " << m_options.host << ":" << m_options.port;
-            } else {
-                LOG_CLASS(error) << "API can not start on " << m_options.host << ":" << m_options.port;
-            }
-        });
-        m_server = &server;
-
-        m_eventsListener = m_blockchain->registerEventsListener(EventsListenerCallbacks{
-            .onBlocks = [this](auto blocks, bool didChangeBranch) {
-                m_loop->defer(std::bind(&Api::onBlocks, this, blocks, didChangeBranch));
-            },
-            .onNewTransactions = [this](auto transactions) {
-                m_loop->defer(std::bind(&Api::onNewTransactions, this, transactions));
-            }
+    for (size_t i = 0; i < m_options.threads; ++i) {
+        auto& worker = *m_workers.emplace_back(std::make_unique<ApiWorker>());
+        m_workerThreads.emplace_back([this, &worker, &cv, &startedWorkers] {
+            runWorker(worker, cv, startedWorkers);
         });
+    }
 
-        cv.notify_all();
-        m_mutex.unlock();
-
-        server.run();
+    cv.wait(lock, [this, &startedWorkers] {return startedWorkers == m_workers.size(); });
 
-        std::lock_guard lock(m_mutex);
-        m_server = nullptr;
-        m_loop = nullptr;
+    // events are handled by first worker, messages are published to all of them
+    uWS::Loop* loop = m_workers.front()->loop;
+    m_eventsListener = m_blockchain->registerEventsListener(EventsListenerCallbacks{
+        .onBlocks = [this, loop](auto blocks, bool didChangeBranch) {
+            loop->defer(std::bind(&Api::onBlocks, this, blocks, didChangeBranch));
+        },
+        .onNewTransactions = [this, loop](auto transactions) {
+            loop->defer(std::bind(&Api::onNewTransactions, this, transactions));
+        }
     });
-
-    cv.wait(lock, [this] {return m_loop != nullptr; });
 }
 
 void Api::stop()
@@ -62,35 +52,106 @@ void Api::stop()
     m_mutex.lock();
     m_stopped = true;
     m_eventsListener = nullptr;
-    m_websockets.clear();
-    if (m_server) {
-        m_server->close();
+    for (auto& worker : m_workers) {
+        worker->websockets.clear();
+        if (worker->server) {
+            // timer must be closed while loop is running, closed timers are freed by next iteration of loop
+            worker->loop->defer([worker = worker.get()] {
+                if (worker->timer) {
+                    us_timer_close(worker->timer);
+                    worker->timer = nullptr;
+                }
+                worker->server->close();
+            });
+        }
     }
     m_mutex.unlock();
+    for (auto& thread : m_workerThreads) {
+        thread.join();
+    }
+    // all waiting transactions are timed out
+    checkCommitWaiters();
     Thread::stop();
 }
 
-ApiServer Api::configureServer()
+void Api::runWorker(ApiWorker& worker, std::condition_variable_any& cv, size_t& startedWorkers)
+{
+    SET_THREAD_NAME("api");
+    m_mutex.lock();
+    worker.loop = uWS::Loop::get();
+
+    // every worker listens on the same port, uSockets sets SO_REUSEPORT on listen sockets, so kernel spreads
+    // connections between workers and slow request blocks only one of them
+    ApiServer server = configureServer(worker).listen(m_options.host, m_options.port, [this](bool success) {
+        if (success) {
+            LOG_CLASS(info) << "API started on " << m_options.host << ":" << m_options.port;
+        } else {
+            LOG_CLASS(error) << "API can not start on " << m_options.host << ":" << m_options.port;
+        }
+    });
+    worker.server = &server;
+
+    // first worker checks timeouts of transactions waiting for commit, timer with fallthrough doesn't keep loop
+    // running when server is closed, it's closed in stop
+    if (&worker == m_workers.front().get()) {
+        worker.timer = us_create_timer((us_loop_t*)worker.loop, 1, sizeof(Api*));
+        *(Api**)us_timer_ext(worker.timer) = this;
+        us_timer_set(worker.timer, [](us_timer_t* timer) {
+            (*(Api**)us_timer_ext(timer))->checkCommitWaiters();
+        }, COMMIT_WAITERS_CHECK_INTERVAL, COMMIT_WAITERS_CHECK_INTERVAL);
+    }
+
+    startedWorkers += 1;
+    cv.notify_all();
+    m_mutex.unlock();
+
+    server.run();
+
+    std::lock_guard lock(m_mutex);
+    worker.server = nullptr;
+    worker.loop = nullptr;
+}
+
+ApiServer Api::configureServer(ApiWorker& worker)
 {
     ApiServer::WebSocketBehavior webSocketBehavior = {
         .maxPayloadLength = 1024 + kTransactionMaxSize * 2,
-        .maxBackpressure = 2 * 1024 * 1024
+        .maxBackpressure = 2 * 1024 * 1024,
+        // subscriber which can't keep up is disconnected instead of silently missing messages
+        .closeOnBackpressureLimit = true
     };
-    webSocketBehavior.open = [this](ApiServer::WebSocket* ws) {
-        m_websockets.insert(ws);
+    webSocketBehavior.open = [this, &worker](ApiServer::WebSocket* ws) {
+        worker.websockets.insert(ws);
+        m_websocketFormats[(size_t)ws->getUserData()->format] += 1;
     };
-    webSocketBehavior.message = [this](ApiServer::WebSocket* ws, std::string_view message, uWS::OpCode opCode) {
+    webSocketBehavior.message = [this, &worker](ApiServer::WebSocket* ws, std::string_view message,
+                                                uWS::OpCode opCode) {
         if (message.size() > kTransactionMaxSize * 2) {
             return ws->end(0, "Too long data");
         }
-        auto data = json::parse(message.begin(), message.end(), nullptr, false);
+        // binary messages are encoded in format selected by websocket
+        json data;
+        auto format = ws->getUserData()->format;
+        if (opCode != uWS::BINARY) {
+            data = json::parse(message.begin(), message.end(), nullptr, false);
+        } else if (format == ApiServer::Format::CBOR) {
+            data = json::from_cbor(message, true, false);
+        } else if (format == ApiServer::Format::MSGPACK) {
+            data = json::from_msgpack(message, true, false);
+        } else {
+            data = json::value_t::discarded;
+        }
         if (data == json::value_t::discarded) {
             return ws->end(0, "Invalid data");
         }
-        onWebsocketMessage(ws, data);
+        onWebsocketMessage(worker, ws, data);
     };
-    webSocketBehavior.close = [this](ApiServer::WebSocket* ws, int code, std::string_view message) {
-        m_websockets.erase(ws);
+    webSocketBehavior.close = [this, &worker](ApiServer::WebSocket* ws, int code, std::string_view message) {
+        worker.websockets.erase(ws);
+        m_websocketFormats[(size_t)ws->getUserData()->format] -= 1;
+        for (auto& topic : ws->getUserData()->topics) {
+            updateSubscriptions(topic, false);
+        }
     };
 
     return ApiServer().ws("/", std::move(webSocketBehavior)).options("/*", [this](auto* req) {
@@ -105,36 +166,56 @@ ApiServer Api::configureServer()
         return readiness();
     }).get("/health/liveness", [this](auto* req) {
         return liveness();
-    }).get("/blocks/:id", [this](auto* req) {
-        return getBlock(toU32(req->getParameter(0)));
-    }).get("/blocks/:id/body", [this](auto* req) {
-        return getBlockBody(toU32(req->getParameter(0)));
+    }).get("/blocks/:id", [this](ApiServer::HttpResponse* res, ApiServer::HttpRequest* req) {
+        uint32_t blockId = toU32(req->getParameter(0));
+        writeCachedResponse(res, req, "blocks/"s + std::to_string(blockId), [this, blockId] {
+            return std::make_pair(getBlock(blockId), blockId);
+        }, [this, blockId] {
+            return getSerializedBlock(blockId);
+        });
+    }).get("/blocks/:id/body", [this](ApiServer::HttpResponse* res, ApiServer::HttpRequest* req) {
+        uint32_t blockId = toU32(req->getParameter(0));
+        writeCachedResponse(res, req, "blocks/body/"s + std::to_string(blockId), [this, blockId] {
+            return std::make_pair(getBlockBody(blockId), blockId);
+        });
     }).get("/blocks/:id/header", [this](auto* req) {
         return getBlockHeader(toU32(req->getParameter(0)));
     }).get("/blocks/:id/header/next", [this](auto* req) {
         return getNextBlockHeader(toU32(req->getParameter(0)));
-    }).get("/blocks/:id/transactions/:chunk", [this](auto* req) {
-        return getBlockTransactionIds(toU32(req->getParameter(0)), toU32(req->getParameter(1)));
+    }).get("/blocks/:id/transactions/:chunk", [this](ApiServer::HttpResponse* res, ApiServer::HttpRequest* req) {
+        uint32_t blockId = toU32(req->getParameter(0)), chunk = toU32(req->getParameter(1));
+        writeCachedResponse(res, req, "blocks/transactions/"s + std::to_string(blockId) + "/"s + std::to_string(chunk),
+                            [this, blockId, chunk] {
+            return std::make_pair(getBlockTransactionIds(blockId, chunk), blockId);
+        });
     }).get("/blocks/:id/users", [this](auto* req) {
         return getUsersUpdatedInBlockCount(toU32(req->getParameter(0)));
     }).get("/blocks/:id/users/:page", [this](auto* req) {
         return getUsersUpdatedInBlock(toU32(req->getParameter(0)), toU32(req->getParameter(1)));
     }).get("/blocks/first", [this](auto* req) {
         return getFirstBlock();
-    }).get("/blocks/latest", [this](auto* req) {
-        return getLatestBlocks();
+    }).get("/blocks/latest", [this](ApiServer::HttpResponse* res, ApiServer::HttpRequest* req) {
+        writeCommittedResponse(res, req, "blocks/latest");
+    }).stream("/export/blocks", [this](auto* req) {
+        return exportBlocks(req);
     }).get("/miners/:id", [this](auto* req) {
         return getMiner(MinerId(req->getParameter(0)), onlyConfirmed(req));
-    }).get("/miners/queue", [this](auto* req) {
-        return getMinersQueue();
-    }).get("/miners/top", [this](auto* req) {
-        return getTopMiners();
+    }).get("/miners/queue", [this](ApiServer::HttpResponse* res, ApiServer::HttpRequest* req) {
+        writeCommittedResponse(res, req, "miners/queue");
+    }).get("/miners/top", [this](ApiServer::HttpResponse* res, ApiServer::HttpRequest* req) {
+        writeCommittedResponse(res, req, "miners/top");
     }).get("/miners/trusted", [this](auto* req) {
         return getTrustedMiners();
     }).get("/status", [this](auto* req) {
         return status();
     }).get("/storage/prefixes/:id", [this](auto* req) {
         return getPrefix(std::string(req->getParameter(0)), onlyConfirmed(req));
+    }).get("/storage/prefixes/:id/transactions", [this](auto* req) {
+        auto cursor = getCursor(req);
+        if (!cursor) {
+            return json(400);
+        }
+        return getTransactionsForPrefix(std::string(req->getParameter(0)), *cursor, onlyConfirmed(req));
     }).get("/storage/prefixes/:id/transactions/:page", [this](auto* req) {
         return getTransactionsForPrefix(std::string(req->getParameter(0)), toU32(req->getParameter(1)));
     }).get("/storage/entries/:id", [this](auto* req) {
@@ -142,28 +223,68 @@ ApiServer Api::configureServer()
     }).get("/storage/entries/:prefix/:id", [this](auto* req) {
         return getStorageEntry(std::string(req->getParameter(0)), std::string(req->getParameter(1)),
                                onlyConfirmed(req));
-    }).get("/transactions/:id", [this](auto* req) {
-        return getTransaction(TransactionId(req->getParameter(0)), onlyConfirmed(req));
+    }).get("/transactions/batch", [this](auto* req) {
+        auto ids = getBatchIds(req);
+        if (ids.empty()) {
+            return json(400);
+        }
+        return getTransactions(std::vector<TransactionId>(ids.begin(), ids.end()), onlyConfirmed(req));
+    }).get("/transactions/:id", [this](ApiServer::HttpResponse* res, ApiServer::HttpRequest* req) {
+        TransactionId transactionId(req->getParameter(0));
+        bool confirmed = onlyConfirmed(req);
+        // committed transaction has the same response for confirmed and unconfirmed state
+        writeCachedResponse(res, req, "transactions/"s + transactionId.toString(), [this, transactionId, confirmed] {
+            json j = getTransaction(transactionId, confirmed);
+            uint32_t blockId = j.is_object() ? j["committed_in"].get<uint32_t>() : 0;
+            return std::make_pair(std::move(j), blockId);
+        }, [this, transactionId, confirmed] {
+            return getSerializedTransaction(transactionId, confirmed);
+        });
+    }).get("/users/batch", [this](auto* req) {
+        auto ids = getBatchIds(req);
+        if (ids.empty()) {
+            return json(400);
+        }
+        return getUsers(std::vector<UserId>(ids.begin(), ids.end()), onlyConfirmed(req));
     }).get("/users/:id", [this](auto* req) {
         return getUser(UserId(req->getParameter(0)), onlyConfirmed(req));
     }).get("/users/:id/history", [this](auto* req) {
-        return getUserHistory(UserId(req->getParameter(0)), 0);
+        if (!isCursorRequest(req)) {
+            return getUserHistory(UserId(req->getParameter(0)), 0);
+        }
+        auto cursor = getCursor(req);
+        if (!cursor) {
+            return json(400);
+        }
+        return getUserHistory(UserId(req->getParameter(0)), *cursor, onlyConfirmed(req));
     }).get("/users/:id/history/:page", [this](auto* req) {
         return getUserHistory(UserId(req->getParameter(0)), toU32(req->getParameter(1)), onlyConfirmed(req));
     }).get("/users/:id/sponsors", [this](auto* req) {
-        return getUserSponsors(UserId(req->getParameter(0)), 0);
+        if (!isCursorRequest(req)) {
+            return getUserSponsors(UserId(req->getParameter(0)), 0);
+        }
+        auto cursor = getCursor(req);
+        if (!cursor) {
+            return json(400);
+        }
+        return getUserSponsors(UserId(req->getParameter(0)), *cursor, onlyConfirmed(req));
     }).get("/users/:id/sponsors/:page", [this](auto* req) {
         return getUserSponsors(UserId(req->getParameter(0)), toU32(req->getParameter(1)), onlyConfirmed(req));
     }).get("/debug", [this](auto* req, SafeCallback<json>&& handler) {
         return getDebugInfo(std::move(handler));
-    }).post("/transactions", [this](auto* req, auto serializer, auto handler) {
-        postTransaction(*serializer, std::move(handler));
-    }).any("/*", [this](auto* req) {
+    }).post("/transactions", [this](std::string_view query, std::string_view address, auto serializer,
+                                    auto handler) {
+        postTransaction(*serializer, address, std::move(handler),
+                        ApiServer::getQueryValue(query, "wait") == "committed");
+    }).post("/transactions/batch", [this](std::string_view query, std::string_view address, auto serializer,
+                                          auto handler) {
+        postTransactions(*serializer, address, std::move(handler));
+    }, MAX_BATCH_BODY_SIZE).any("/*", [this](auto* req) {
         return 404;
     });
 }
 
-void Api::onWebsocketMessage(ApiServer::WebSocket* ws, const json& data)
+void Api::onWebsocketMessage(ApiWorker& worker, ApiServer::WebSocket* ws, const json& data)
 {
     json response = {
         {"type", "response"}
@@ -174,17 +295,44 @@ void Api::onWebsocketMessage(ApiServer::WebSocket* ws, const json& data)
         }
     } catch (const json::exception& exception) {
         response["error"] = "JSON _id parse exception: "s + exception.what();
-        ws->send(response.dump(), uWS::TEXT);
+        ApiServer::send(ws, response);
         return;
     }
 
     try {
         bool unconfirmed = data.contains("unconfirmed") && (data["unconfirmed"].get<bool>() == true);
         std::string type = data["type"];
+        auto userData = ws->getUserData();
         if (type == "subscribe") {
-            ws->subscribe(data["topic"].get<std::string>());
+            auto topic = getSubscriptionTopic(data["topic"].get<std::string>());
+            if (!topic) {
+                response["error"] = "Invalid topic";
+            } else if (userData->topics.size() >= MAX_SUBSCRIPTIONS) {
+                response["error"] = "Too many subscriptions";
+            } else if (userData->topics.insert(*topic).second) {
+                updateSubscriptions(*topic, true);
+                ws->subscribe(getFormatTopic(*topic, userData->format));
+            }
         } else if (type == "unsubscribe") {
-            ws->unsubscribe(data["topic"].get<std::string>());
+            auto topic = getSubscriptionTopic(data["topic"].get<std::string>());
+            if (topic && userData->topics.erase(*topic) > 0) {
+                updateSubscriptions(*topic, false);
+                ws->unsubscribe(getFormatTopic(*topic, userData->format));
+            }
+        } else if (type == "format") {
+            // response to this request is already sent in new format
+            auto format = ApiServer::getFormat(data["format"].get<std::string>());
+            if (!format || format == ApiServer::Format::BINARY) {
+                response["error"] = "Invalid format";
+            } else {
+                for (auto& topic : userData->topics) {
+                    ws->unsubscribe(getFormatTopic(topic, userData->format));
+                    ws->subscribe(getFormatTopic(topic, *format));
+                }
+                m_websocketFormats[(size_t)userData->format] -= 1;
+                m_websocketFormats[(size_t)*format] += 1;
+                userData->format = *format;
+            }
         } else if (type == "status") {
             response["data"] = status();
         } else if (type == "user") {
@@ -205,9 +353,10 @@ void Api::onWebsocketMessage(ApiServer::WebSocket* ws, const json& data)
                 response["data"] = getTransaction(TransactionId(transaction), unconfirmed);
             } else {
                 auto serializer = Serializer::fromBase64(transaction);
+                bool waitForCommit = data.contains("wait") && data["wait"].get<std::string>() == "committed";
                 auto weakSelf = weak_from_this();
-                postTransaction(serializer, (SafeCallback<json>)
-                                [this, ws, response, weakSelf](const std::shared_ptr<json>& data) mutable {
+                postTransaction(serializer, ws->getRemoteAddressAsText(), (SafeCallback<json>)
+                                [this, &worker, ws, response, weakSelf](const std::shared_ptr<json>& data) mutable {
                     auto self = weakSelf.lock();
                     if (!self) {
                         return;
@@ -216,14 +365,14 @@ void Api::onWebsocketMessage(ApiServer::WebSocket* ws, const json& data)
                     if (m_stopped) {
                         return;
                     }
-                    m_loop->defer([this, ws, response, data]() mutable {
-                        if (m_websockets.find(ws) == m_websockets.end()) {
+                    worker.loop->defer([&worker, ws, response, data]() mutable {
+                        if (worker.websockets.find(ws) == worker.websockets.end()) {
                             return;
                         }
                         response["data"] = *data;
-                        ws->send(response.dump(), uWS::TEXT);
+                        ApiServer::send(ws, response);
                     });
-                });
+                }, waitForCommit);
                 return;
             }
         } else {
@@ -234,11 +383,15 @@ void Api::onWebsocketMessage(ApiServer::WebSocket* ws, const json& data)
     } catch (const SerializerException& exception) {
         response["error"] = "Serializer exception: "s + exception.what();
     }
-    ws->send(response.dump(), uWS::TEXT);
+    ApiServer::send(ws, response);
 }
 
 void Api::onBlocks(const std::vector<Block_cptr>& blocks, bool didChangeBranch)
 {
+    updateCommittedState();
+    cacheCommittedBlocks();
+    checkCommitWaiters(blocks);
+
     json blocksJSON;
     for (auto& block : blocks) {
         blocksJSON.push_back(json{
@@ -249,7 +402,7 @@ void Api::onBlocks(const std::vector<Block_cptr>& blocks, bool didChangeBranch)
         });
     }
 
-    m_server->publish("new_blocks", {
+    publish("new_blocks", {
         {"type", "subscription"},
         {"topic", "new_blocks"},
         {"data", {
@@ -257,6 +410,88 @@ void Api::onBlocks(const std::vector<Block_cptr>& blocks, bool didChangeBranch)
             {"did_change_branch", didChangeBranch}
         }}
     });
+
+    publishBlockUpdates(blocks);
+}
+
+void Api::publishBlockUpdates(const std::vector<Block_cptr>& blocks)
+{
+    {
+        std::lock_guard lock(m_subscriptionsMutex);
+        if (m_subscriptions.empty() || blocks.empty()) {
+            return;
+        }
+    }
+
+    // users are taken from index of users updated in blocks, only state after last block is known, so every user
+    // is published once with id of last block
+    std::set<UserId> userIds;
+    for (auto& block : blocks) {
+        uint32_t blockId = block->getId();
+        uint32_t updatedUsers = db()->users.getUpdatedUserIdsCount(blockId);
+        for (uint32_t page = 0; page * database::UserUpdatesColumn::PAGE_SIZE < updatedUsers; ++page) {
+            for (auto& userId : db()->users.getUpdatedUserIds(blockId, page)) {
+                userIds.insert(userId);
+            }
+        }
+    }
+    uint32_t lastBlockId = blocks.back()->getId();
+    for (auto& userId : userIds) {
+        std::string topic = "users/"s + userId.toString();
+        if (hasSubscribers(topic)) {
+            publish(topic, makeBlockUpdateMessage(topic, {{"user", getUser(userId)}}, lastBlockId));
+        }
+    }
+
+    for (auto& block : blocks) {
+        publishTransactionUpdates(block);
+    }
+}
+
+json Api::makeBlockUpdateMessage(const std::string& topic, json&& data, uint32_t blockId)
+{
+    data["block_id"] = blockId;
+    return json{
+        {"type", "subscription"},
+        {"topic", topic},
+        {"data", std::move(data)}
+    };
+}
+
+void Api::publishTransactionUpdates(const Block_cptr& block)
+{
+    uint32_t blockId = block->getId();
+    uint64_t committedAt = m_blockchain->getInitializationTime() + blockId * m_blockchain->getBlockInterval();
+    for (auto transaction : *block) {
+        json transactionJSON;
+        std::string topic = "transactions/"s + transaction->getId().toString();
+        if (hasSubscribers(topic)) {
+            transactionJSON = transaction;
+            transactionJSON["committed_in"] = blockId;
+            transactionJSON["committed_at"] = committedAt;
+            publish(topic, makeBlockUpdateMessage(topic, {{"transaction", transactionJSON}}, blockId));
+        }
+
+        std::string prefix;
+        if (transaction->getType() == StorageAddEntryTransaction::TYPE) {
+            prefix = std::static_pointer_cast<const StorageAddEntryTransaction>(transaction)->getPrefix();
+        } else if (transaction->getType() == StorageCreatePrefixTransaction::TYPE) {
+            prefix = std::static_pointer_cast<const StorageCreatePrefixTransaction>(transaction)->getPrefix();
+        } else if (transaction->getType() == StorageUpdatePrefixTransaction::TYPE) {
+            prefix = std::static_pointer_cast<const StorageUpdatePrefixTransaction>(transaction)->getPrefix();
+        } else {
+            continue;
+        }
+        topic = "prefixes/"s + prefix;
+        if (hasSubscribers(topic)) {
+            if (transactionJSON.is_null()) {
+                transactionJSON = transaction;
+                transactionJSON["committed_in"] = blockId;
+                transactionJSON["committed_at"] = committedAt;
+            }
+            publish(topic, makeBlockUpdateMessage(topic, {{"transaction", transactionJSON}}, blockId));
+        }
+    }
 }
 
 void Api::onNewTransactions(const std::vector<Transaction_cptr>& transactions)
@@ -266,7 +501,7 @@ void Api::onNewTransactions(const std::vector<Transaction_cptr>& transactions)
         transactionIds.push_back(transaction->getId());
     }
 
-    m_server->publish("new_transactions", {
+    publish("new_transactions", {
         {"type", "subscription"},
         {"topic", "new_transactions"},
         {"data", {
@@ -275,6 +510,214 @@ void Api::onNewTransactions(const std::vector<Transaction_cptr>& transactions)
     });
 }
 
+void Api::publish(const std::string& topic, const json& message)
+{
+    std::shared_lock lock(m_mutex);
+    for (auto format : { ApiServer::Format::JSON, ApiServer::Format::CBOR, ApiServer::Format::MSGPACK }) {
+        if (m_websocketFormats[(size_t)format] == 0) {
+            continue;
+        }
+        auto data = std::make_shared<const std::string>(ApiServer::encode(message, format));
+        auto opCode = format == ApiServer::Format::JSON ? uWS::TEXT : uWS::BINARY;
+        for (auto& worker : m_workers) {
+            if (worker->server) {
+                worker->server->publish(getFormatTopic(topic, format), data, opCode);
+            }
+        }
+    }
+}
+
+std::optional<std::string> Api::getSubscriptionTopic(const std::string& topic)
+{
+    if (topic == "new_blocks"s || topic == "new_transactions"s) {
+        return topic;
+    }
+    // ids are parsed and serialized again, so the same entity always has the same topic
+    size_t pos = topic.find('/');
+    if (pos == std::string::npos) {
+        return std::nullopt;
+    }
+    std::string_view type = std::string_view(topic).substr(0, pos), id = std::string_view(topic).substr(pos + 1);
+    if (type == "users") {
+        UserId userId(id);
+        if (userId.isValid()) {
+            return "users/"s + userId.toString();
+        }
+    } else if (type == "transactions") {
+        TransactionId transactionId(id);
+        if (transactionId.isValid()) {
+            return "transactions/"s + transactionId.toString();
+        }
+    } else if (type == "prefixes") {
+        if (id.size() >= kStoragePrefixMinLength && id.size() <= kStoragePrefixMaxLength) {
+            return topic;
+        }
+    }
+    return std::nullopt;
+}
+
+void Api::updateSubscriptions(const std::string& topic, bool subscribed)
+{
+    std::lock_guard lock(m_subscriptionsMutex);
+    if (subscribed) {
+        m_subscriptions[topic] += 1;
+    } else if (--m_subscriptions[topic] == 0) {
+        m_subscriptions.erase(topic);
+    }
+}
+
+bool Api::hasSubscribers(const std::string& topic) const
+{
+    std::lock_guard lock(m_subscriptionsMutex);
+    return m_subscriptions.contains(topic);
+}
+
+std::string Api::getFormatTopic(const std::string& topic, ApiServer::Format format)
+{
+    if (format == ApiServer::Format::JSON) {
+        return topic;
+    }
+    return topic + "/"s + std::string(ApiServer::getFormatName(format));
+}
+
+void Api::writeCachedResponse(ApiServer::HttpResponse* res, ApiServer::HttpRequest* req, const std::string& key,
+                              const ResponseHandler& handler, const BinaryResponseHandler& binaryHandler)
+{
+    auto format = ApiServer::getFormat(req);
+    if (format == ApiServer::Format::BINARY && !binaryHandler) {
+        format = ApiServer::Format::JSON;
+    }
+    ApiServer::writeResponse(res, req, *getCachedResponse(key, format, handler, binaryHandler));
+}
+
+ApiServer::Response_cptr Api::getCachedResponse(const std::string& key, ApiServer::Format format,
+                                                const ResponseHandler& handler,
+                                                const BinaryResponseHandler& binaryHandler)
+{
+    std::string cacheKey = key + "."s + std::string(ApiServer::getFormatName(format));
+    auto cachedResponse = m_responseCache.get(cacheKey);
+    if (cachedResponse) {
+        return cachedResponse;
+    }
+
+    // latest block id must be taken before reading resource, otherwise it could be read from rolled back block
+    uint32_t latestBlockId = m_blockchain->getLatestBlockId();
+    uint64_t generation = m_responseCache.getGeneration();
+    ApiServer::Response response;
+    uint32_t blockId = 0;
+    if (format == ApiServer::Format::BINARY) {
+        auto [body, committedIn] = binaryHandler();
+        blockId = committedIn;
+        if (body.empty()) {
+            response = ApiServer::makeResponse(404, ApiServer::Format::JSON);
+        } else {
+            response = ApiServer::Response{ .format = format, .body = std::move(body) };
+        }
+    } else {
+        auto [j, committedIn] = handler();
+        blockId = committedIn;
+        response = ApiServer::makeResponse(j, format);
+    }
+
+    if (!response.status.empty() || blockId == 0 || blockId + kDatabaseRolbackableBlocks >= latestBlockId) {
+        return std::make_shared<const ApiServer::Response>(std::move(response));
+    }
+
+    response.etag = "\""s + Hash::generate(response.body).toString() + "\""s;
+    cachedResponse = std::make_shared<const ApiServer::Response>(std::move(response));
+    m_responseCache.put(cacheKey, cachedResponse, cacheKey.size() + cachedResponse->body.size() +
+                        cachedResponse->etag.size(), generation);
+    return cachedResponse;
+}
+
+void Api::cacheCommittedBlocks()
+{
+    // blocks from the last few intervals are cached, older ones are cached on first request
+    constexpr uint32_t MAX_CACHED_BLOCKS = 8;
+    uint32_t latestBlockId = m_blockchain->getLatestBlockId();
+    if (latestBlockId <= kDatabaseRolbackableBlocks + 1) {
+        return;
+    }
+    uint32_t lastBlockId = latestBlockId - kDatabaseRolbackableBlocks - 1;
+    uint32_t blockId = std::max(m_cachedBlockId + 1, lastBlockId > MAX_CACHED_BLOCKS ?
+                                lastBlockId - MAX_CACHED_BLOCKS + 1 : 1);
+    for (; blockId <= lastBlockId; ++blockId) {
+        getCachedResponse("blocks/"s + std::to_string(blockId), ApiServer::Format::JSON, [this, blockId] {
+            return std::make_pair(getBlock(blockId), blockId);
+        });
+    }
+    m_cachedBlockId = lastBlockId;
+}
+
+Api::CommittedState_cptr Api::buildCommittedState() const
+{
+    auto state = std::make_shared<CommittedState>();
+    state->blockId = db()->blocks.getLatestBlockId();
+    state->status = {
+        {"version", std::to_string(kVersionMajor) + "."s + std::to_string(kVersionMinor)},
+        {"miner_id", m_blockchain->getMinerId()},
+        {"pricing", db()->state.getPricing()},
+        {"initialization_time", m_blockchain->getInitializationTime()},
+        {"miners", db()->miners.getMinersCount()},
+        {"tokens", db()->users.getTokens()},
+        {"staked_tokens", db()->miners.getStakedTokens()},
+        {"users", db()->users.getUsersCount()},
+        {"transactions", db()->transactions.getTransactionsCount()},
+        {"transactions_size", db()->transactions.getTransactionsSize()},
+        {"storage", {
+            {"entries", db()->storage.getEntriesCount()},
+            {"prefixes", db()->storage.getPrefixesCount()},
+        }}
+    };
+
+    std::vector<std::pair<std::string, json>> responses = {
+        {"blocks/latest", getLatestBlocks()},
+        {"miners/queue", getMinersQueue()},
+        {"miners/top", getTopMiners()}
+    };
+    for (auto& [key, j] : responses) {
+        for (auto format : { ApiServer::Format::JSON, ApiServer::Format::CBOR, ApiServer::Format::MSGPACK }) {
+            state->responses.emplace(key + "."s + std::string(ApiServer::getFormatName(format)),
+                                     std::make_shared<const ApiServer::Response>(ApiServer::makeResponse(j, format)));
+        }
+    }
+    return state;
+}
+
+void Api::updateCommittedState()
+{
+    auto state = buildCommittedState();
+    std::lock_guard lock(m_committedStateMutex);
+    // state could be already rebuilt by getCommittedState for the same block
+    if (!m_committedState || m_committedState->blockId != state->blockId) {
+        m_committedState = state;
+    }
+}
+
+Api::CommittedState_cptr Api::getCommittedState() const
+{
+    std::lock_guard lock(m_committedStateMutex);
+    // blocks may be committed before onBlocks event is handled by first worker, so state is rebuilt when
+    // latest block differs from the one it was built for
+    if (!m_committedState || m_committedState->blockId != db()->blocks.getLatestBlockId()) {
+        m_committedState = buildCommittedState();
+    }
+    return m_committedState;
+}
+
+void Api::writeCommittedResponse(ApiServer::HttpResponse* res, ApiServer::HttpRequest* req,
+                                 const std::string& key) const
+{
+    auto format = ApiServer::getFormat(req);
+    if (format == ApiServer::Format::BINARY) {
+        format = ApiServer::Format::JSON;
+    }
+    auto state = getCommittedState();
+    auto it = state->responses.find(key + "."s + std::string(ApiServer::getFormatName(format)));
+    ASSERT(it != state->responses.end());
+    ApiServer::writeResponse(res, req, *it->second);
+}
+
 bool Api::onlyConfirmed(ApiServer::HttpRequest* req) const
 {
     auto parameter = req->getQuery("unconfirmed");
@@ -291,31 +734,94 @@ uint32_t Api::toU32(const std::string_view& str) const
     return value;
 }
 
+bool Api::isCursorRequest(ApiServer::HttpRequest* req)
+{
+    return !req->getQuery("order").empty() || !req->getQuery("limit").empty() || !req->getQuery("cursor").empty();
+}
+
+std::optional<Api::Cursor> Api::getCursor(ApiServer::HttpRequest* req) const
+{
+    Cursor cursor;
+    auto order = req->getQuery("order");
+    if (order == "oldest") {
+        cursor.newestFirst = false;
+    } else if (!order.empty() && order != "newest") {
+        return std::nullopt;
+    }
+
+    auto limit = req->getQuery("limit");
+    if (!limit.empty()) {
+        cursor.limit = toU32(limit);
+        if (cursor.limit == 0 || cursor.limit > MAX_CURSOR_LIMIT) {
+            return std::nullopt;
+        }
+    }
+
+    auto index = req->getQuery("cursor");
+    if (!index.empty()) {
+        uint64_t value;
+        auto result = std::from_chars(index.data(), index.data() + index.size(), value);
+        if (result.ec != std::errc() || result.ptr != index.data() + index.size()) {
+            return std::nullopt;
+        }
+        cursor.index = value;
+    }
+    return cursor;
+}
+
+json Api::readCursor(const Cursor& cursor, uint64_t total, const CursorReader& reader)
+{
+    json j = {
+        {"total", total},
+        {"entries", json::array()},
+        {"next_cursor", nullptr}
+    };
+    uint64_t index = cursor.index.value_or(cursor.newestFirst ? total - 1 : 0);
+    if (total == 0 || index >= total) {
+        return j;
+    }
+
+    // entries are read from index towards older ones for newest first order
+    size_t count = (size_t)std::min<uint64_t>(cursor.limit, cursor.newestFirst ? index + 1 : total - index);
+    j["entries"] = reader(index, count, cursor.newestFirst);
+    if (j["entries"].size() != count) {
+        return j;
+    }
+    if (cursor.newestFirst && index >= count) {
+        j["next_cursor"] = std::to_string(index - count);
+    } else if (!cursor.newestFirst && index + count < total) {
+        j["next_cursor"] = std::to_string(index + count);
+    }
+    return j;
+}
+
+std::vector<std::string_view> Api::getBatchIds(ApiServer::HttpRequest* req) const
+{
+    std::vector<std::string_view> ids;
+    std::string_view parameter = req->getQuery("ids");
+    while (!parameter.empty()) {
+        if (ids.size() == MAX_BATCH_IDS) {
+            return {};
+        }
+        size_t pos = parameter.find(',');
+        ids.push_back(parameter.substr(0, pos));
+        parameter.remove_prefix(pos == std::string_view::npos ? parameter.size() : pos + 1);
+    }
+    return ids;
+}
+
 json Api::status() const
 {
-    json j;
-    j["version"] = std::to_string(kVersionMajor) + "."s + std::to_string(kVersionMinor);
-    j["miner_id"] = m_blockchain->getMinerId();
-    j["pricing"] = db()->state.getPricing();
-    j["initialization_time"] = m_blockchain->getInitializationTime();
+    // values which don't change between commits are taken from committed state
+    json j = getCommittedState()->status;
     j["current_time"] = chrono::duration_cast<chrono::seconds>(chrono::system_clock::now().time_since_epoch()).count();
     j["latest_block_id"] = m_blockchain->getLatestBlockId();
     j["exptected_block_id"] = m_blockchain->getExpectedBlockId();
     j["is_synchronized"] = !m_blockchain->isDesynchronized();
-    j["miners"] = db()->miners.getMinersCount();
-    j["tokens"] = db()->users.getTokens();
-    j["staked_tokens"] = db()->miners.getStakedTokens();
-    j["users"] = db()->users.getUsersCount();
-    j["transactions"] = db()->transactions.getTransactionsCount();
-    j["transactions_size"] = db()->transactions.getTransactionsSize();
     j["new_transactions"] = db(false)->transactions.getNewTransactionsCount();
     j["new_transactions_size"] = db(false)->transactions.getNewTransactionsSize();
     j["pending_transactions"] = m_blockchain->getPendingTransactions().getPendingTransactionsCount();
     j["pending_transactions_size"] = m_blockchain->getPendingTransactions().getPendingTransactionsSize();
-    j["storage"] = {
-        {"entries", db()->storage.getEntriesCount()},
-        {"prefixes", db()->storage.getPrefixesCount()},
-    };
     return j;
 }
 
@@ -473,6 +979,90 @@ json Api::getTransaction(const TransactionId& transactionId, bool confirmed) con
     return j;
 }
 
+json Api::getTransactions(const std::vector<TransactionId>& transactionIds, bool confirmed) const
+{
+    uint64_t initializationTime = m_blockchain->getInitializationTime();
+    json j = json::array();
+    for (auto& [transaction, blockId] : m_blockchain->getTransactionsWithBlockIds(transactionIds)) {
+        if (!transaction || (blockId == 0 && confirmed)) {
+            j.push_back(nullptr);
+            continue;
+        }
+        json& t = j.emplace_back(transaction);
+        t["committed_in"] = blockId;
+        t["committed_at"] = blockId > 0 ? initializationTime + blockId * m_blockchain->getBlockInterval() : 0;
+    }
+    return j;
+}
+
+ApiServer::Stream Api::exportBlocks(ApiServer::HttpRequest* req) const
+{
+    uint32_t latestBlockId = db()->blocks.getLatestBlockId();
+    uint32_t firstBlockId = std::max<uint32_t>(toU32(req->getQuery("from")), 1);
+    uint32_t lastBlockId = req->getQuery("to").empty() ? latestBlockId : toU32(req->getQuery("to"));
+    if (firstBlockId > lastBlockId) {
+        return ApiServer::Stream{ .error = 400 };
+    }
+
+    bool binary = ApiServer::getFormat(req) == ApiServer::Format::BINARY;
+    std::shared_ptr<database::BlocksFacade::Iterator> iterator =
+        db()->blocks.getBlocksIterator(firstBlockId, std::min(lastBlockId, latestBlockId));
+    return ApiServer::Stream{
+        .contentType = binary ? "application/octet-stream" : "application/x-ndjson",
+        .generator = [iterator, binary]() -> std::string {
+            auto block = iterator->next();
+            if (!block) {
+                return "";
+            }
+            if (binary) {
+                // native serialization of block prefixed by its size (uint32, little endian)
+                Serializer s;
+                s(block);
+                std::string_view data(s);
+                uint32_t size = boost::endian::native_to_little((uint32_t)data.size());
+                std::string record((const char*)&size, sizeof(size));
+                record.append(data);
+                return record;
+            }
+            json transactions = json::array();
+            for (auto transaction : *block) {
+                transactions.push_back(transaction);
+            }
+            json j = {
+                {"id", block->getId()},
+                {"depth", block->getDepth()},
+                {"header", block->getBlockHeader()},
+                {"body", block->getBlockBody()},
+                {"transactions", std::move(transactions)}
+            };
+            return j.dump() + "\n";
+        }
+    };
+}
+
+std::pair<std::string, uint32_t> Api::getSerializedBlock(uint32_t blockId) const
+{
+    auto block = db()->blocks.getBlock(blockId);
+    if (!block) {
+        return { "", blockId };
+    }
+    Serializer s;
+    s(block);
+    return { std::string(std::string_view(s)), blockId };
+}
+
+std::pair<std::string, uint32_t> Api::getSerializedTransaction(const TransactionId& transactionId,
+                                                               bool confirmed) const
+{
+    auto [transaction, blockId] = m_blockchain->getTransaction(transactionId);
+    if (!transaction || (blockId == 0 && confirmed)) {
+        return { "", 0 };
+    }
+    Serializer s;
+    s(transaction);
+    return { std::string(std::string_view(s)), blockId };
+}
+
 json Api::getMiner(const MinerId& minerId, bool confirmed) const
 {
     auto miner = db(confirmed)->miners.getMiner(minerId);
@@ -534,6 +1124,15 @@ json Api::getUser(const UserId& userId, bool confirmed) const
     return user;
 }
 
+json Api::getUsers(const std::vector<UserId>& userIds, bool confirmed) const
+{
+    json j = json::array();
+    for (auto& user : db(confirmed)->users.getUsers(userIds)) {
+        j.push_back(user); // null when user doesn't exist
+    }
+    return j;
+}
+
 json Api::getUserHistory(const UserId& userId, uint32_t page, bool confirmed) const
 {
     return db(confirmed)->users.getUserHistory(userId, page);
@@ -544,6 +1143,28 @@ json Api::getUserSponsors(const UserId& userId, uint32_t page, bool confirmed) c
     return db(confirmed)->users.getUserSponsors(userId, page);
 }
 
+json Api::getUserHistory(const UserId& userId, const Cursor& cursor, bool confirmed) const
+{
+    auto user = db(confirmed)->users.getUser(userId);
+    if (!user) {
+        return 404;
+    }
+    return readCursor(cursor, user->operations, [&](uint64_t index, size_t count, bool reverse) {
+        return json(db(confirmed)->users.getUserHistory(userId, index, count, reverse));
+    });
+}
+
+json Api::getUserSponsors(const UserId& userId, const Cursor& cursor, bool confirmed) const
+{
+    auto user = db(confirmed)->users.getUser(userId);
+    if (!user) {
+        return 404;
+    }
+    return readCursor(cursor, user->sponsors, [&](uint64_t index, size_t count, bool reverse) {
+        return json(db(confirmed)->users.getUserSponsors(userId, index, count, reverse));
+    });
+}
+
 json Api::getPrefix(const std::string& prefixId, bool confirmed) const
 {
     auto prefix = db(confirmed)->storage.getPrefix(prefixId);
@@ -614,10 +1235,235 @@ json Api::getTransactionsForPrefix(const std::string& prefixId, uint32_t page) c
     return db()->storage.getTransasctionsForPrefix(prefixId, page);
 }
 
-void Api::postTransaction(Serializer& serializer, SafeCallback<json>&& callback) const
+json Api::getTransactionsForPrefix(const std::string& prefixId, const Cursor& cursor, bool confirmed) const
+{
+    auto prefix = db(confirmed)->storage.getPrefix(prefixId);
+    if (!prefix) {
+        return 404;
+    }
+    return readCursor(cursor, prefix->entries, [&](uint64_t index, size_t count, bool reverse) {
+        return json(db(confirmed)->storage.getTransasctionsForPrefix(prefixId, index, count, reverse));
+    });
+}
+
+AdmissionControl::Result Api::admitTransactions(const std::string_view& address,
+                                                const std::vector<Transaction_cptr>& transactions)
+{
+    // transactions in flight would be rejected by blockchain anyway if they don't fit into pending transactions
+    auto& pendingTransactions = m_blockchain->getPendingTransactions();
+    size_t maxPendingTransactions = pendingTransactions.getMaxPendingTransactionsCount();
+    size_t pending = pendingTransactions.getPendingTransactionsCount() +
+        pendingTransactions.getExecutedTransactionsCount();
+    size_t maxInFlight = pending < maxPendingTransactions ? maxPendingTransactions - pending : 0;
+
+    std::vector<UserId> userIds;
+    userIds.reserve(transactions.size());
+    for (auto& transaction : transactions) {
+        userIds.push_back(transaction->getUserId());
+    }
+    auto result = m_admissionControl.admit(std::string(address), userIds, maxInFlight, maxPendingTransactions);
+    if (result != AdmissionControl::Result::ADMITTED) {
+        LOG_CLASS(debug) << "Rejected " << transactions.size() << " transactions from " << address
+            << ", reason: " << (int)result;
+    }
+    return result;
+}
+
+json Api::getAdmissionError(AdmissionControl::Result result) const
+{
+    if (result != AdmissionControl::Result::EXCEEDS_CAPACITY) {
+        return json(429);
+    }
+    size_t maxPendingTransactions = m_blockchain->getPendingTransactions().getMaxPendingTransactionsCount();
+    size_t addressCapacity = m_admissionControl.getAddressCapacity();
+    size_t userCapacity = m_admissionControl.getUserCapacity();
+    std::string limits = "max "s + std::to_string(maxPendingTransactions) + " transactions";
+    if (addressCapacity != 0) {
+        limits += ", "s + std::to_string(addressCapacity) + " transactions per address";
+    }
+    if (userCapacity != 0) {
+        limits += ", "s + std::to_string(userCapacity) + " transactions per user";
+    }
+    return ApiServer::makeError(413, "Too many transactions in single request, limit: "s + limits);
+}
+
+void Api::postTransaction(Serializer& serializer, const std::string_view& address, SafeCallback<json>&& callback,
+                          bool waitForCommit)
+{
+    Transaction_cptr transaction;
+    try {
+        transaction = Transaction::load(serializer);
+        if (!serializer.eof()) {
+            THROW_SERIALIZER_EXCEPTION("Unknown extra transaction data");
+        }
+    } catch (const SerializerException& e) {
+        return callback((json)PostTransactionResult(PostTransactionResult::Status::SERIALIZER_ERROR, e.what()));
+    }
+
+    if (auto result = admitTransactions(address, { transaction }); result != AdmissionControl::Result::ADMITTED) {
+        return callback(getAdmissionError(result));
+    }
+
+    m_blockchain->postTransaction(transaction, (PostTransactionCallback)
+                                  [this, transaction, callback = std::move(callback), waitForCommit,
+                                  weakSelf = weak_from_this()](auto result) mutable {
+        auto self = weakSelf.lock();
+        if (self) {
+            m_admissionControl.release(1);
+            // user id of transaction with invalid signature could be forged
+            if (result && result->getStatusCode() != PostTransactionResult::Status::SIGNATURE_ERROR) {
+                m_admissionControl.chargeUsers({ transaction->getUserId() });
+            }
+        }
+        if (!self || !waitForCommit || !result || !(*result)) {
+            return callback(std::move((json)result));
+        }
+        addCommitWaiter(transaction, std::move(callback));
+    });
+}
+
+void Api::addCommitWaiter(const Transaction_cptr& transaction, SafeCallback<json>&& callback)
+{
+    const TransactionId& transactionId = transaction->getId();
+    bool added = false;
+    {
+        std::lock_guard lock(m_commitWaitersMutex);
+        if (!m_stopped && m_commitWaiters.size() < MAX_COMMIT_WAITERS) {
+            m_commitWaiters.emplace(transactionId, CommitWaiter{
+                .maxBlockId = transaction->getBlockId() + (uint32_t)kTransactionMaxBlockIdDifference - 1,
+                .deadline = chrono::steady_clock::now() + COMMIT_WAIT_TIMEOUT,
+                .callback = std::move(callback)
+            });
+            added = true;
+        }
+    }
+    if (!added) {
+        return callback(makeCommitResult(transactionId, PostTransactionResult::Status::TIMEOUT, 0,
+                                         "can't wait for commit"));
+    }
+
+    // transaction could be committed before waiter was added
+    uint32_t blockId = m_blockchain->getTransaction(transactionId).second;
+    if (blockId > 0) {
+        std::vector<std::pair<SafeCallback<json>, json>> results;
+        {
+            std::lock_guard lock(m_commitWaitersMutex);
+            auto [begin, end] = m_commitWaiters.equal_range(transactionId);
+            for (auto it = begin; it != end; ++it) {
+                results.emplace_back(std::move(it->second.callback),
+                                     makeCommitResult(transactionId, PostTransactionResult::Status::SUCCESS, blockId));
+            }
+            m_commitWaiters.erase(begin, end);
+        }
+        for (auto& [callback, result] : results) {
+            callback(std::move(result));
+        }
+    }
+}
+
+void Api::checkCommitWaiters(const std::vector<Block_cptr>& blocks)
+{
+    std::vector<std::pair<SafeCallback<json>, json>> results;
+    std::vector<std::pair<SafeCallback<json>, TransactionId>> outdated;
+    {
+        std::lock_guard lock(m_commitWaitersMutex);
+        if (m_commitWaiters.empty()) {
+            return;
+        }
+
+        for (auto& block : blocks) {
+            for (size_t i = 0; i < block->getTransactions(); ++i) {
+                TransactionId transactionId = block->getTransactionId(i);
+                auto [begin, end] = m_commitWaiters.equal_range(transactionId);
+                for (auto it = begin; it != end; ++it) {
+                    results.emplace_back(std::move(it->second.callback), makeCommitResult(
+                        transactionId, PostTransactionResult::Status::SUCCESS, block->getId()));
+                }
+                m_commitWaiters.erase(begin, end);
+            }
+        }
+
+        uint32_t latestBlockId = m_blockchain->getLatestBlockId();
+        auto now = chrono::steady_clock::now();
+        for (auto it = m_commitWaiters.begin(); it != m_commitWaiters.end(); ) {
+            if (it->second.maxBlockId < latestBlockId) {
+                outdated.emplace_back(std::move(it->second.callback), it->first);
+            } else if (m_stopped || it->second.deadline <= now) {
+                results.emplace_back(std::move(it->second.callback), makeCommitResult(
+                    it->first, PostTransactionResult::Status::TIMEOUT, 0, "transaction wasn't committed in time"));
+            } else {
+                ++it;
+                continue;
+            }
+            it = m_commitWaiters.erase(it);
+        }
+    }
+
+    for (auto& [callback, result] : results) {
+        callback(std::move(result));
+    }
+    // block with transaction may be not handled yet by onBlocks
+    for (auto& [callback, transactionId] : outdated) {
+        uint32_t blockId = m_blockchain->getTransaction(transactionId).second;
+        if (blockId > 0) {
+            callback(makeCommitResult(transactionId, PostTransactionResult::Status::SUCCESS, blockId));
+        } else {
+            callback(makeCommitResult(transactionId, PostTransactionResult::Status::OUTDATED, 0));
+        }
+    }
+}
+
+json Api::makeCommitResult(const TransactionId& transactionId, PostTransactionResult::Status status,
+                           uint32_t blockId, const std::string& details)
+{
+    json j = PostTransactionResult(transactionId, status, details);
+    j["committed_in"] = blockId;
+    return j;
+}
+
+void Api::postTransactions(Serializer& serializer, const std::string_view& address, SafeCallback<json>&& callback)
 {
-    m_blockchain->postTransaction(serializer, (PostTransactionCallback)[callback = std::move(callback)](auto result) {
-        return callback(std::move((json)result));
+    std::vector<Transaction_cptr> transactions;
+    try {
+        while (!serializer.eof()) {
+            transactions.push_back(Transaction::load(serializer));
+        }
+    } catch (const SerializerException& e) {
+        // the same result as from Blockchain::postTransactions, following transactions can't be read
+        json j = json::array();
+        j.push_back((json)PostTransactionResult(PostTransactionResult::Status::SERIALIZER_ERROR,
+                                                "transaction "s + std::to_string(transactions.size()) + " - "s +
+                                                e.what()));
+        return callback(std::move(j));
+    }
+
+    // whole batch is rejected if any transaction can't be admitted, batch which can't be admitted even by idle node
+    // gets 413 with limits
+    if (!transactions.empty()) {
+        if (auto result = admitTransactions(address, transactions); result != AdmissionControl::Result::ADMITTED) {
+            return callback(getAdmissionError(result));
+        }
+    }
+
+    m_blockchain->postTransactions(transactions, (PostTransactionsCallback)
+                                   [this, transactions, callback = std::move(callback),
+                                   weakSelf = weak_from_this()](auto results) {
+        if (auto self = weakSelf.lock()) {
+            m_admissionControl.release(transactions.size());
+            // user ids of transactions with invalid signatures could be forged
+            std::vector<UserId> userIds;
+            for (size_t i = 0; results && i < results->size() && i < transactions.size(); ++i) {
+                if ((*results)[i].getStatusCode() != PostTransactionResult::Status::SIGNATURE_ERROR) {
+                    userIds.push_back(transactions[i]->getUserId());
+                }
+            }
+            m_admissionControl.chargeUsers(userIds);
+        }
+        json j = json::array();
+        for (auto& result : *results) {
+            j.push_back(result);
+        }
+        return callback(std::move(j));
     });
 }
 
@@ -626,6 +1472,20 @@ void Api::getDebugInfo(SafeCallback<json>&& callback) const
     std::shared_ptr<json> j = std::make_shared<json>();
     j->emplace("blockchain", m_blockchain->getDebugInfo());
     j->emplace("database", m_database->getDebugInfo());
+    j->emplace("api", json{
+        {"threads", m_workers.size()},
+        {"response_cache", m_responseCache.getDebugInfo()},
+        {"admission", m_admissionControl.getDebugInfo()},
+        {"websockets", {
+            {"json", m_websocketFormats[(size_t)ApiServer::Format::JSON].load()},
+            {"cbor", m_websocketFormats[(size_t)ApiServer::Format::CBOR].load()},
+            {"msgpack", m_websocketFormats[(size_t)ApiServer::Format::MSGPACK].load()}
+        }},
+        {"subscribed_topics", [this] {
+            std::lock_guard lock(m_subscriptionsMutex);
+            return m_subscriptions.size();
+        }()}
+    });
 
     if (m_communication) {
         m_communication->getDebugInfo((SafeCallback<json>)[j, callback = std::move(callback)](const std::shared_ptr<json>& ret) {
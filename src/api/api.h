@@ -1,9 +1,11 @@
 #pragma once
 
+#include "admission_control.h"
 #include "api_options.h"
 #include "api_server.h"
 #include "blockchain/blockchain.h"
 #include "communication/communication.h"
+#include "database/columns/object_cache.h"
 
 namespace logpass {
 
@@ -24,15 +26,112 @@ public:
     }
 
 protected:
-    ApiServer configureServer();
-
-    void onWebsocketMessage(ApiServer::WebSocket* ws, const json& data);
+    // max number of topics subscribed by single websocket
+    static constexpr size_t MAX_SUBSCRIPTIONS = 1024;
+    // max time of waiting for transaction commit
+    static constexpr chrono::seconds COMMIT_WAIT_TIMEOUT = chrono::seconds(60);
+    // max number of transactions waiting for commit, above it transactions are responded without waiting
+    static constexpr size_t MAX_COMMIT_WAITERS = 100'000;
+    // interval of checking commit timeouts in milliseconds
+    static constexpr int COMMIT_WAITERS_CHECK_INTERVAL = 1000;
+    // max number of ids in single batch lookup
+    static constexpr size_t MAX_BATCH_IDS = 256;
+    // max body size of batch transactions post
+    static constexpr size_t MAX_BATCH_BODY_SIZE = 4 * 1024 * 1024;
+    // default and max number of entries returned for cursor
+    static constexpr size_t DEFAULT_CURSOR_LIMIT = 100;
+    static constexpr size_t MAX_CURSOR_LIMIT = 1000;
+
+    // position in history of user or prefix, entries are indexed in order of adding
+    struct Cursor {
+        bool newestFirst = true;
+        size_t limit = DEFAULT_CURSOR_LIMIT;
+        // index of first returned entry, the newest or the oldest entry when it's not set
+        std::optional<uint64_t> index;
+    };
+    using CursorReader = std::function<json(uint64_t index, size_t count, bool reverse)>;
+
+    // each worker has own thread, event loop and server, websockets are handled by worker which accepted them
+    struct ApiWorker {
+        uWS::Loop* loop = nullptr;
+        ApiServer* server = nullptr;
+        // timer checking commit waiters, only first worker has it
+        us_timer_t* timer = nullptr;
+        std::set<ApiServer::WebSocket*> websockets;
+    };
+
+    void runWorker(ApiWorker& worker, std::condition_variable_any& cv, size_t& startedWorkers);
+    ApiServer configureServer(ApiWorker& worker);
+
+    void onWebsocketMessage(ApiWorker& worker, ApiServer::WebSocket* ws, const json& data);
+    // sends message to subscribers of topic on all workers, message is serialized once for every used format
+    void publish(const std::string& topic, const json& message);
+    // subscribers of topic are grouped by format of websocket
+    static std::string getFormatTopic(const std::string& topic, ApiServer::Format format);
+    // returns normalized topic, besides new_blocks and new_transactions there are users/<id>, prefixes/<id>
+    // and transactions/<id> topics
+    static std::optional<std::string> getSubscriptionTopic(const std::string& topic);
+    void updateSubscriptions(const std::string& topic, bool subscribed);
+    bool hasSubscribers(const std::string& topic) const;
+    void addCommitWaiter(const Transaction_cptr& transaction, SafeCallback<json>&& callback);
+    // responds to waiters of transactions committed in blocks and to expired waiters
+    void checkCommitWaiters(const std::vector<Block_cptr>& blocks = {});
+    static json makeCommitResult(const TransactionId& transactionId, PostTransactionResult::Status status,
+                                 uint32_t blockId, const std::string& details = "");
+    // publishes users, prefixes and transactions committed in blocks, messages are created only for topics
+    // with subscribers, users are published once with id of last block because only their latest state is known
+    void publishBlockUpdates(const std::vector<Block_cptr>& blocks);
+    // publishes prefixes and transactions committed in block
+    void publishTransactionUpdates(const Block_cptr& block);
+    static json makeBlockUpdateMessage(const std::string& topic, json&& data, uint32_t blockId);
 
     void onBlocks(const std::vector<Block_cptr>& blocks, bool didChangeBranch);
     void onNewTransactions(const std::vector<Transaction_cptr>& transactions);
 
+    // handler returns response and id of block in which resource was committed (0 if it's not committed)
+    using ResponseHandler = std::function<std::pair<json, uint32_t>()>;
+    // handler of binary format returns serialized resource (empty if it's not found) and id of block
+    using BinaryResponseHandler = std::function<std::pair<std::string, uint32_t>()>;
+
+    // responses of resources committed deeper than kDatabaseRolbackableBlocks are cached
+    void writeCachedResponse(ApiServer::HttpResponse* res, ApiServer::HttpRequest* req, const std::string& key,
+                             const ResponseHandler& handler, const BinaryResponseHandler& binaryHandler = nullptr);
+    ApiServer::Response_cptr getCachedResponse(const std::string& key, ApiServer::Format format,
+                                               const ResponseHandler& handler,
+                                               const BinaryResponseHandler& binaryHandler = nullptr);
+    // caches responses of blocks which became immutable, called by first worker
+    void cacheCommittedBlocks();
+
+    // responses of confirmed state which change only when blocks are committed
+    struct CommittedState {
+        // latest block when state was built
+        uint32_t blockId = 0;
+        // part of status without values which change between commits
+        json status;
+        // responses of latest blocks, miners queue and top miners encoded in every format
+        std::map<std::string, ApiServer::Response_cptr> responses;
+    };
+    using CommittedState_cptr = std::shared_ptr<const CommittedState>;
+
+    CommittedState_cptr buildCommittedState() const;
+    // rebuilds committed state, called by first worker after blocks are committed
+    void updateCommittedState();
+    // returns committed state, it's rebuilt when it's older than latest block
+    CommittedState_cptr getCommittedState() const;
+    // writes response of committed state with given key
+    void writeCommittedResponse(ApiServer::HttpResponse* res, ApiServer::HttpRequest* req, const std::string& key) const;
+
     bool onlyConfirmed(ApiServer::HttpRequest* req) const;
     uint32_t toU32(const std::string_view& str) const;
+    // returns comma separated values of ids query parameter, empty if there's more than MAX_BATCH_IDS of them
+    std::vector<std::string_view> getBatchIds(ApiServer::HttpRequest* req) const;
+    // true if request has any of cursor parameters: order (newest or oldest), limit or cursor
+    static bool isCursorRequest(ApiServer::HttpRequest* req);
+    // returns cursor from query parameters, nullopt if they're invalid
+    std::optional<Cursor> getCursor(ApiServer::HttpRequest* req) const;
+    // returns total number of entries, entries for cursor and opaque cursor of next entries (null if there are
+    // no more entries)
+    static json readCursor(const Cursor& cursor, uint64_t total, const CursorReader& reader);
 
     json status() const;
     json health() const;
@@ -55,15 +154,38 @@ protected:
     json getTopMiners() const;
     json getTrustedMiners() const;
     json getTransaction(const TransactionId& transactionId, bool confirmed = true) const;
+    json getTransactions(const std::vector<TransactionId>& transactionIds, bool confirmed = true) const;
+    std::pair<std::string, uint32_t> getSerializedBlock(uint32_t blockId) const;
+    // streams blocks with transactions from range given by from and to query parameters, as ndjson or as native
+    // serialization when binary format is accepted
+    ApiServer::Stream exportBlocks(ApiServer::HttpRequest* req) const;
+    std::pair<std::string, uint32_t> getSerializedTransaction(const TransactionId& transactionId,
+                                                              bool confirmed = true) const;
     json getUser(const UserId& userId, bool confirmed = true) const;
+    json getUsers(const std::vector<UserId>& userIds, bool confirmed = true) const;
     json getUserHistory(const UserId& userId, uint32_t page, bool confirmed = true) const;
+    json getUserHistory(const UserId& userId, const Cursor& cursor, bool confirmed = true) const;
     json getUserSponsors(const UserId& userId, uint32_t page, bool confirmed = true) const;
+    json getUserSponsors(const UserId& userId, const Cursor& cursor, bool confirmed = true) const;
 
     json getPrefix(const std::string& prefixId, bool confirmed = true) const;
     json getStorageEntry(const std::string& prefixId, const std::string& key, bool confirmed = true) const;
     json getTransactionsForPrefix(const std::string& prefixId, uint32_t page) const;
-
-    void postTransaction(Serializer& serializer, SafeCallback<json>&& callback) const;
+    json getTransactionsForPrefix(const std::string& prefixId, const Cursor& cursor, bool confirmed = true) const;
+
+    // admits transactions posted from given address, in-flight limit is free space of pending transactions,
+    // admitted transactions must be released when blockchain returns result, users of transactions are charged
+    // then unless signature was invalid
+    AdmissionControl::Result admitTransactions(const std::string_view& address,
+                                               const std::vector<Transaction_cptr>& transactions);
+    // returns 413 error with limits for transactions which exceed capacity, otherwise 429
+    json getAdmissionError(AdmissionControl::Result result) const;
+    // with waitForCommit, response of successfully posted transaction is held until it's committed in block,
+    // can't be committed anymore or COMMIT_WAIT_TIMEOUT passes, rejected transactions get 429 without
+    // reaching blockchain
+    void postTransaction(Serializer& serializer, const std::string_view& address, SafeCallback<json>&& callback,
+                         bool waitForCommit = false);
+    void postTransactions(Serializer& serializer, const std::string_view& address, SafeCallback<json>&& callback);
 
     void getDebugInfo(SafeCallback<json>&& callback) const;
 
@@ -83,10 +205,29 @@ private:
     mutable Logger m_logger;
 
     std::unique_ptr<EventsListener> m_eventsListener;
-    ApiServer* m_server = nullptr;
-    uWS::Loop* m_loop = nullptr;
-
-    std::set<ApiServer::WebSocket*> m_websockets;
+    std::vector<std::unique_ptr<ApiWorker>> m_workers;
+    std::vector<std::thread> m_workerThreads;
+
+    database::ObjectCache<std::string, ApiServer::Response_cptr> m_responseCache;
+    AdmissionControl m_admissionControl;
+    mutable std::mutex m_committedStateMutex;
+    mutable CommittedState_cptr m_committedState;
+    // number of websockets using each format
+    std::array<std::atomic<size_t>, 3> m_websocketFormats{};
+    struct CommitWaiter {
+        // last block in which transaction can be committed
+        uint32_t maxBlockId;
+        chrono::steady_clock::time_point deadline;
+        SafeCallback<json> callback;
+    };
+    // responses waiting for commit of transactions
+    std::mutex m_commitWaitersMutex;
+    std::multimap<TransactionId, CommitWaiter> m_commitWaiters;
+    // number of websockets subscribed to each topic
+    mutable std::mutex m_subscriptionsMutex;
+    std::map<std::string, size_t> m_subscriptions;
+    // last block which response was cached after commit, used only by first worker
+    uint32_t m_cachedBlockId = 0;
 
     std::atomic<bool> m_stopped = false;
 };
@@ -12,7 +12,13 @@ po::options_description ApiOptions::getOptionsDescription()
 
     options.add_options()
         ("api-host", po::value<std::string>()->default_value("0.0.0.0"), "host of api service")
-        ("api-port", po::value<uint16_t>()->default_value(8080), "port of api service (0=disabled)");
+        ("api-port", po::value<uint16_t>()->default_value(8080), "port of api service (0=disabled)")
+        ("api-threads", po::value<size_t>()->default_value(1), "number of threads handling api requests")
+        ("api-cache-size", po::value<size_t>()->default_value(64), "max size in MBs of cached api responses")
+        ("api-address-transactions-rate", po::value<size_t>()->default_value(100),
+         "max number of transactions per second posted from single address (0=unlimited)")
+        ("api-user-transactions-rate", po::value<size_t>()->default_value(10),
+         "max number of transactions per second posted by single user (0=unlimited)");
 
     return options;
 }
@@ -22,6 +28,13 @@ ApiOptions ApiOptions::loadOptions(po::variables_map& vm)
     ApiOptions options;
     options.host = vm["api-host"].as<std::string>();
     options.port = vm["api-port"].as<uint16_t>();
+    options.threads = vm["api-threads"].as<size_t>();
+    if (options.threads == 0) {
+        THROW_EXCEPTION(po::error("Invalid number of api threads (0)"));
+    }
+    options.cacheSize = vm["api-cache-size"].as<size_t>();
+    options.addressTransactionsRate = vm["api-address-transactions-rate"].as<size_t>();
+    options.userTransactionsRate = vm["api-user-transactions-rate"].as<size_t>();
 
     return options;
 }
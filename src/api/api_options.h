@@ -5,6 +5,14 @@ namespace logpass {
 struct ApiOptions {
     std::string host = "127.0.0.1";
     uint16_t port = 8080;
+    // number of threads with own event loop and listen socket bound to the same port
+    size_t threads = 1;
+    // max size in MBs of cached responses of immutable resources
+    size_t cacheSize = 64;
+    // max number of transactions per second posted from single address, 0 means unlimited
+    size_t addressTransactionsRate = 100;
+    // max number of transactions per second posted by single user, 0 means unlimited
+    size_t userTransactionsRate = 10;
 
     static program_options::options_description getOptionsDescription();
     static ApiOptions loadOptions(program_options::variables_map& optionsVariableMap);
@@ -4,47 +4,276 @@
 
 namespace logpass {
 
-void ApiServer::writeResponse(HttpResponse* res, const json& data) {
-    std::string status, error, response;
+ApiServer::Format ApiServer::getFormat(HttpRequest* req)
+{
+    return getAcceptedFormat(req->getHeader("accept"));
+}
+
+ApiServer::Format ApiServer::getAcceptedFormat(std::string_view accept)
+{
+    auto trim = [](std::string_view str) {
+        while (!str.empty() && (str.front() == ' ' || str.front() == '\t')) {
+            str.remove_prefix(1);
+        }
+        while (!str.empty() && (str.back() == ' ' || str.back() == '\t')) {
+            str.remove_suffix(1);
+        }
+        return str;
+    };
+
+    Format bestFormat = Format::JSON;
+    double bestQuality = 0;
+    while (!accept.empty()) {
+        size_t end = accept.find(',');
+        std::string_view range = accept.substr(0, end);
+        accept.remove_prefix(end == std::string_view::npos ? accept.size() : end + 1);
+
+        size_t separator = range.find(';');
+        std::string_view type = trim(range.substr(0, separator));
+        std::optional<Format> format;
+        if (type == "application/json" || type == "application/*" || type == "*/*") {
+            format = Format::JSON;
+        } else if (type == "application/cbor") {
+            format = Format::CBOR;
+        } else if (type == "application/msgpack" || type == "application/x-msgpack") {
+            format = Format::MSGPACK;
+        } else if (type == "application/octet-stream") {
+            format = Format::BINARY;
+        }
+        if (!format) {
+            continue;
+        }
+
+        // quality is 1 by default, invalid one is treated as default too
+        double quality = 1;
+        while (separator != std::string_view::npos) {
+            range.remove_prefix(separator + 1);
+            separator = range.find(';');
+            std::string_view parameter = trim(range.substr(0, separator));
+            if (parameter.starts_with("q=")) {
+                std::from_chars(parameter.data() + 2, parameter.data() + parameter.size(), quality);
+            }
+        }
+        // on equal quality first listed format is preferred
+        if (quality > bestQuality) {
+            bestFormat = *format;
+            bestQuality = quality;
+        }
+    }
+    return bestFormat;
+}
+
+std::optional<ApiServer::Format> ApiServer::getFormat(std::string_view name)
+{
+    for (Format format : { Format::JSON, Format::CBOR, Format::MSGPACK, Format::BINARY }) {
+        if (getFormatName(format) == name) {
+            return format;
+        }
+    }
+    return std::nullopt;
+}
+
+std::string_view ApiServer::getFormatName(Format format)
+{
+    switch (format) {
+    case Format::CBOR:
+        return "cbor";
+    case Format::MSGPACK:
+        return "msgpack";
+    case Format::BINARY:
+        return "binary";
+    default:
+        return "json";
+    }
+}
+
+std::string_view ApiServer::getQueryValue(std::string_view query, std::string_view key)
+{
+    while (!query.empty()) {
+        size_t end = query.find('&');
+        std::string_view parameter = query.substr(0, end);
+        size_t separator = parameter.find('=');
+        if (parameter.substr(0, separator) == key) {
+            return separator == std::string_view::npos ? std::string_view() : parameter.substr(separator + 1);
+        }
+        query.remove_prefix(end == std::string_view::npos ? query.size() : end + 1);
+    }
+    return {};
+}
+
+std::string ApiServer::encode(const json& data, Format format)
+{
+    std::string encoded;
+    if (format == Format::CBOR) {
+        json::to_cbor(data, encoded);
+    } else if (format == Format::MSGPACK) {
+        json::to_msgpack(data, encoded);
+    } else {
+        encoded = data.dump();
+    }
+    return encoded;
+}
+
+json ApiServer::makeError(int code, const std::string& message)
+{
+    return json{ {"error_code", code}, {"error", message} };
+}
+
+ApiServer::Response ApiServer::makeResponse(const json& data, Format format)
+{
+    if (format == Format::BINARY) {
+        format = Format::JSON;
+    }
+
+    Response response{ .format = format };
+    std::string error;
     try {
+        std::optional<int> errorCode;
         if (data.is_number_integer()) {
-            int errorCode = data.get<int>();
-            if (errorCode == 400) {
-                status = "400 Bad Request";
+            errorCode = data.get<int>();
+        } else if (data.is_object() && data.contains("error_code")) {
+            errorCode = data["error_code"].get<int>();
+        }
+
+        if (errorCode) {
+            if (*errorCode == 400) {
+                response.status = "400 Bad Request";
                 error = "Bad Request";
-            } else if (errorCode == 404) {
-                status = "404 Not Found";
+            } else if (*errorCode == 404) {
+                response.status = "404 Not Found";
                 error = "Not Found";
-            } else if (errorCode == 500) {
-                status = "500 Internal Server Error";
+            } else if (*errorCode == 413) {
+                response.status = "413 Payload Too Large";
+                error = "Payload Too Large";
+            } else if (*errorCode == 429) {
+                response.status = "429 Too Many Requests";
+                error = "Too Many Requests";
+            } else if (*errorCode == 500) {
+                response.status = "500 Internal Server Error";
                 error = "Internal Server Error";
             } else {
-                status = "500 Internal Server Error";
-                error = "Unknown error: "s + std::to_string(errorCode);
+                response.status = "500 Internal Server Error";
+                error = "Unknown error: "s + std::to_string(*errorCode);
+            }
+            if (data.is_object()) {
+                error = data["error"].get<std::string>();
             }
         } else {
-            response = data.dump(4);
+            response.body = encode(data, format);
         }
     } catch (const json::exception&) {
-        status = "500 Internal Server Error";
+        response.status = "500 Internal Server Error";
         error = "Exception";
     }
 
     if (!error.empty()) {
-        response = json{ {"error", error } }.dump(4);
+        response.body = encode(json{ {"error", error } }, format);
     }
+    return response;
+}
+
+void ApiServer::writeResponse(HttpResponse* res, const json& data, Format format)
+{
+    writeResponse(res, nullptr, makeResponse(data, format));
+}
 
-    res->cork([res, status = std::move(status), response = std::move(response)] {
-        if (!status.empty()) {
-            res->writeStatus(status);
+void ApiServer::writeResponse(HttpResponse* res, HttpRequest* req, const Response& response)
+{
+    bool notModified = req && !response.etag.empty() &&
+        req->getHeader("if-none-match").find(response.etag) != std::string_view::npos;
+    res->cork([res, &response, notModified] {
+        if (notModified) {
+            res->writeStatus("304 Not Modified");
+        } else if (!response.status.empty()) {
+            res->writeStatus(response.status);
         }
-        res->writeHeader("Content-Type", "application/json");
-        res->writeHeader("Access-Control-Allow-Origin", "*");
-        res->writeHeader("Access-Control-Allow-Methods", "*");
-        res->writeHeader("Access-Control-Allow-Credentials", "true");
-        res->writeHeader("Cross-Origin-Resource-Policy", "cross-origin");
-        res->end(response);
+        writeHeaders(res, response.format);
+        if (!response.etag.empty()) {
+            res->writeHeader("ETag", response.etag);
+            res->writeHeader("Cache-Control", "public, max-age=31536000, immutable");
+        }
+        res->end(notModified ? std::string_view() : std::string_view(response.body));
+    });
+}
+
+void ApiServer::send(WebSocket* ws, const json& message)
+{
+    Format format = ws->getUserData()->format;
+    ws->send(encode(message, format), format == Format::JSON ? uWS::TEXT : uWS::BINARY);
+}
+
+void ApiServer::writeStream(HttpResponse* res, const std::shared_ptr<ApiServerData>& data,
+                            const std::shared_ptr<std::function<std::string()>>& generator)
+{
+    for (size_t chunks = 0; chunks < STREAM_CHUNKS_PER_ITERATION; ++chunks) {
+        if (!data->pendingResponses.contains(res)) {
+            return;
+        }
+
+        std::string chunk;
+        bool finished = false;
+        try {
+            while (chunk.size() < STREAM_CHUNK_SIZE) {
+                std::string record = (*generator)();
+                if (record.empty()) {
+                    finished = true;
+                    break;
+                }
+                chunk += record;
+            }
+        } catch (const std::exception& e) {
+            // response is closed without last chunk, so client knows it's truncated
+            LOG(warning) << "Stream error: " << e.what();
+            data->pendingResponses.erase(res);
+            *generator = nullptr;
+            res->close();
+            return;
+        }
+
+        bool written = true;
+        res->cork([res, &chunk, finished, &written] {
+            if (finished) {
+                res->end(chunk);
+            } else {
+                written = res->write(chunk);
+            }
+        });
+        if (finished) {
+            data->pendingResponses.erase(res);
+            *generator = nullptr;
+            return;
+        }
+        if (!written) {
+            // onWritable continues when buffered data is sent
+            return;
+        }
+    }
+
+    data->loop->defer([res, data, generator] {
+        writeStream(res, data, generator);
     });
 }
 
+void ApiServer::writeHeaders(HttpResponse* res, Format format)
+{
+    switch (format) {
+    case Format::CBOR:
+        res->writeHeader("Content-Type", "application/cbor");
+        break;
+    case Format::MSGPACK:
+        res->writeHeader("Content-Type", "application/msgpack");
+        break;
+    case Format::BINARY:
+        res->writeHeader("Content-Type", "application/octet-stream");
+        break;
+    default:
+        res->writeHeader("Content-Type", "application/json");
+    }
+    res->writeHeader("Access-Control-Allow-Origin", "*");
+    res->writeHeader("Access-Control-Allow-Methods", "*");
+    res->writeHeader("Access-Control-Allow-Credentials", "true");
+    res->writeHeader("Cross-Origin-Resource-Policy", "cross-origin");
+    res->writeHeader("Vary", "Accept");
+}
+
 }
@@ -6,7 +6,35 @@ namespace logpass {
 
 class ApiServer : private uWS::App {
 public:
-    struct UserData {};
+    // encoding of responses, selected by Accept header or by websocket format request
+    enum class Format : uint8_t {
+        JSON,
+        CBOR,
+        MSGPACK,
+        BINARY // native serialization, available only for blocks and transactions
+    };
+
+    struct UserData {
+        Format format = Format::JSON;
+        std::set<std::string> topics;
+    };
+
+    // serialized response, responses with etag are immutable and can be cached
+    struct Response {
+        std::string status;
+        Format format = Format::JSON;
+        std::string body;
+        std::string etag;
+    };
+    using Response_cptr = std::shared_ptr<const Response>;
+
+    // response of unknown size written in chunks, when generator is not set error is written instead
+    struct Stream {
+        std::string contentType;
+        // returns next record of response, empty record ends response, when it throws connection is closed
+        std::function<std::string()> generator;
+        json error;
+    };
 
     using WebSocket = uWS::WebSocket<false, true, UserData>;
     using HttpResponse = uWS::HttpResponse<false>;
@@ -122,22 +150,31 @@ public:
     }
 
 
+    // connection is closed when body is bigger than maxBodySize, handler gets raw query string and remote address
+    // because request is no longer valid when body is received
     ApiServer post(const std::string& pattern,
-                   std::function<void(HttpRequest*, Serializer_ptr, SafeCallback<json>&&)>&& handler)
+                   std::function<void(std::string_view, std::string_view, Serializer_ptr,
+                                      SafeCallback<json>&&)>&& handler,
+                   size_t maxBodySize = kTransactionMaxSize * 2)
     {
-        return { uWS::App::post(pattern,[data = data, handler = std::move(handler)](auto* res, auto* req) mutable {
+        return { uWS::App::post(pattern,[data = data, handler = std::move(handler), maxBodySize](auto* res,
+                                                                                               auto* req) mutable {
+            Format format = getFormat(req);
             data->pendingResponses.insert(res);
             res->onAborted([res, data] {
                 data->pendingResponses.erase(res);
             });
 
             Serializer_ptr s = std::make_shared<Serializer>();
-            res->onData([s, req, res, data, handler](std::string_view msg, bool last) mutable {
+            std::string query(req->getQuery());
+            std::string address(res->getRemoteAddressAsText());
+            res->onData([s, query, address, res, data, handler, format, maxBodySize](std::string_view msg,
+                                                                                     bool last) mutable {
                 if (!data->pendingResponses.contains(res)) {
                     return;
                 }
                 s->readFrom(msg);
-                if (s->pos() > kTransactionMaxSize * 2) {
+                if (s->pos() > maxBodySize) {
                     data->pendingResponses.erase(res);
                     res->close();
                     return;
@@ -146,17 +183,17 @@ public:
                     return;
                 }
                 s->switchToReader();
-                handler(req, s, (SafeCallback<json>)[res, data](const std::shared_ptr<json>& json) {
+                handler(query, address, s, (SafeCallback<json>)[res, data, format](const std::shared_ptr<json>& json) {
                     std::lock_guard<std::mutex> lock(data->mutex);
                     if (data->stopped) {
                         return;
                     }
-                    data->loop->defer([res, json, data] {
+                    data->loop->defer([res, json, data, format] {
                         if (!data->pendingResponses.contains(res)) {
                             return;
                         }
                         data->pendingResponses.erase(res);
-                        writeResponse(res, *json);
+                        writeResponse(res, *json, format);
                     });
                 });
             });
@@ -167,45 +204,74 @@ public:
                   uWS::MoveOnlyFunction<void(HttpRequest*, SafeCallback<json>&&)>&& handler)
     {
         return { uWS::App::get(pattern,[data = data, handler = std::move(handler)](auto* res, auto* req) mutable {
+            Format format = getFormat(req);
             data->pendingResponses.insert(res);
             res->onAborted([res, data] {
                 data->pendingResponses.erase(res);
             });
 
-            handler(req, (SafeCallback<json>)[res, data](const std::shared_ptr<json>& json) {
+            handler(req, (SafeCallback<json>)[res, data, format](const std::shared_ptr<json>& json) {
                 std::lock_guard<std::mutex> lock(data->mutex);
                 if (data->stopped) {
                     return;
                 }
-                data->loop->defer([res, json, data] {
+                data->loop->defer([res, json, data, format] {
                     if (!data->pendingResponses.contains(res)) {
                         return;
                     }
                     data->pendingResponses.erase(res);
-                    ApiServer::writeResponse(res, *json);
+                    ApiServer::writeResponse(res, *json, format);
                 });
             });
         }), data };
     }
 
+    // records are requested from stream only when previous chunks were written without backpressure
+    ApiServer stream(const std::string& pattern, std::function<Stream(HttpRequest*)>&& handler)
+    {
+        return { uWS::App::get(pattern,[data = data, handler = std::move(handler)](auto* res, auto* req) mutable {
+            Stream stream = handler(req);
+            if (!stream.generator) {
+                return ApiServer::writeResponse(res, stream.error, getFormat(req));
+            }
+
+            auto generator = std::make_shared<std::function<std::string()>>(std::move(stream.generator));
+            data->pendingResponses.insert(res);
+            res->onAborted([res, data, generator] {
+                data->pendingResponses.erase(res);
+                *generator = nullptr;
+            });
+            res->onWritable([res, data, generator](uintmax_t offset) {
+                writeStream(res, data, generator);
+                return true;
+            });
+            res->writeHeader("Content-Type", stream.contentType);
+            res->writeHeader("Access-Control-Allow-Origin", "*");
+            writeStream(res, data, generator);
+        }), data };
+    }
+
     ApiServer get(const std::string& pattern, uWS::MoveOnlyFunction<json(HttpRequest*)>&& handler)
     {
         return { uWS::App::get(pattern,[handler = std::move(handler)](auto* res, auto* req) mutable {
-            return ApiServer::writeResponse(res, handler(req));
+            Format format = getFormat(req);
+            return ApiServer::writeResponse(res, handler(req), format);
         }), data };
     }
 
     ApiServer options(const std::string& pattern, uWS::MoveOnlyFunction<json(HttpRequest*)>&& handler)
     {
         return { uWS::App::options(pattern,[handler = std::move(handler)](auto* res, auto* req) mutable {
-            return ApiServer::writeResponse(res, handler(req));
+            Format format = getFormat(req);
+            return ApiServer::writeResponse(res, handler(req), format);
         }), data };
     }
 
     ApiServer any(const std::string& pattern, uWS::MoveOnlyFunction<json(HttpRequest*)>&& handler)
     {
         return { uWS::App::any(pattern,[handler = std::move(handler)](auto* res, auto* req) mutable {
-            return ApiServer::writeResponse(res, handler(req));
+            Format format = getFormat(req);
+            return ApiServer::writeResponse(res, handler(req), format);
         }), data };
     }
 
@@ -226,19 +292,56 @@ public:
     }
 
     void publish(const std::string& topic, const json& message)
+    {
+        publish(topic, std::make_shared<const std::string>(message.dump()));
+    }
+
+    // serialized message can be shared by servers of different loops
+    void publish(const std::string& topic, const std::shared_ptr<const std::string>& message,
+                 uWS::OpCode opCode = uWS::TEXT)
     {
         std::lock_guard<std::mutex> lock(data->mutex);
         if (data->stopped) {
             return;
         }
-        data->loop->defer([this, topic, message] {
-            uWS::App::publish(topic, message.dump(4), uWS::TEXT);
+        data->loop->defer([this, topic, message, opCode] {
+            uWS::App::publish(topic, *message, opCode);
         });
     }
 
-    static void writeResponse(HttpResponse* res, const json& data);
+    // returns format of response accepted by client, json if none of supported formats is accepted
+    static Format getFormat(HttpRequest* req);
+    // returns format with highest quality in value of accept header, json if none of supported formats is accepted
+    static Format getAcceptedFormat(std::string_view accept);
+    // returns format with given name, or nullopt if it's invalid
+    static std::optional<Format> getFormat(std::string_view name);
+    static std::string_view getFormatName(Format format);
+    // returns value of parameter from raw query string, values are not url decoded
+    static std::string_view getQueryValue(std::string_view query, std::string_view key);
+    // encodes json in given format, binary format is not supported by json and json is used instead
+    static std::string encode(const json& data, Format format);
+    // returns error with http status code and message to be passed instead of response data
+    static json makeError(int code, const std::string& message);
+    // json error codes (numbers) and errors from makeError are converted to error responses
+    static Response makeResponse(const json& data, Format format);
+
+    static void writeResponse(HttpResponse* res, const json& data, Format format = Format::JSON);
+    // if response has etag and request has matching If-None-Match header then 304 is sent
+    static void writeResponse(HttpResponse* res, HttpRequest* req, const Response& response);
+    // sends message to websocket in its format
+    static void send(WebSocket* ws, const json& message);
 
 private:
+    // size of chunk written to stream at once
+    static constexpr size_t STREAM_CHUNK_SIZE = 64 * 1024;
+    // after this number of chunks writing is deferred, so long stream doesn't block loop
+    static constexpr size_t STREAM_CHUNKS_PER_ITERATION = 16;
+
+    static void writeHeaders(HttpResponse* res, Format format);
+    // writes chunks of stream until there's backpressure, continues when response becomes writable
+    static void writeStream(HttpResponse* res, const std::shared_ptr<ApiServerData>& data,
+                            const std::shared_ptr<std::function<std::string()>>& generator);
+
     std::shared_ptr<ApiServerData> data;
 };
 
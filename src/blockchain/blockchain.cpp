@@ -90,30 +90,9 @@ void Blockchain::postTransaction(const Transaction_cptr& transaction, PostTransa
         ASSERT(std::this_thread::get_id() == m_thread.get_id());
         LOG_CLASS(trace) << "Posting transaction: " << transaction->getId();
 
-        if (isStopped()) {
-            return cb(PostTransactionResult(transaction->getId(), PostTransactionResult::Status::TIMEOUT));
-        }
-
-        if (isDesynchronized()) {
-            return cb(PostTransactionResult(transaction->getId(), PostTransactionResult::Status::DESYNCHRONIZED));
-        }
-
-        // check is transaction is already pending and executed
-        if (m_pendingTransactions->hasExecutedTransaction(transaction->getId())) {
-            return cb(PostTransactionResult(transaction->getId(), PostTransactionResult::Status::SUCCESS));
-        }
-
-        // add transaction to pending queue if it's requested by some pending block
-        m_pendingTransactions->addTransactionIfRequested(transaction);
-
-        if (!m_pendingTransactions->canAddTransaction(transaction->getId())) {
-            return cb(PostTransactionResult(transaction->getId(),
-                                            PostTransactionResult::Status::REACHED_PENDING_LIMIT));
-        }
-
-        PostTransactionResult result = canExecuteTransaction(transaction, getPendingExecutionBlockId());
-        if (!result) {
-            return cb(std::move(result));
+        auto result = checkPostedTransaction(transaction);
+        if (result) {
+            return cb(std::move(*result));
         }
 
         // do crypto verification on other thread
@@ -131,21 +110,136 @@ void Blockchain::postTransaction(const Transaction_cptr& transaction, PostTransa
 
             post([this, transaction, cb = std::move(cb)]() {
                 ASSERT(std::this_thread::get_id() == m_thread.get_id());
-                if (isStopped()) {
-                    return cb(PostTransactionResult(transaction->getId(), PostTransactionResult::Status::TIMEOUT));
-                }
+                return cb(executePostedTransaction(transaction));
+            });
+        });
+    });
+}
+
+void Blockchain::postTransactions(Serializer& serializer, PostTransactionsCallback&& cb) noexcept
+{
+    std::vector<Transaction_cptr> transactions;
+    try {
+        while (!serializer.eof()) {
+            transactions.push_back(Transaction::load(serializer));
+        }
+    } catch (const SerializerException& e) {
+        // following transactions can't be read, so whole batch is rejected
+        std::vector<PostTransactionResult> results;
+        results.emplace_back(PostTransactionResult::Status::SERIALIZER_ERROR,
+                             "transaction "s + std::to_string(transactions.size()) + " - "s + e.what());
+        return cb(std::move(results));
+    }
+    postTransactions(transactions, std::move(cb));
+}
+
+void Blockchain::postTransactions(const std::vector<Transaction_cptr>& transactions,
+                                  PostTransactionsCallback&& cb) noexcept
+{
+    post([this, transactions, cb = std::move(cb)]() mutable {
+        ASSERT(std::this_thread::get_id() == m_thread.get_id());
+        LOG_CLASS(trace) << "Posting " << transactions.size() << " transactions";
 
-                if (!m_pendingTransactions->canAddTransaction(transaction->getId())) {
-                    return cb(PostTransactionResult(transaction->getId(),
-                                                    PostTransactionResult::Status::REACHED_PENDING_LIMIT));
+        auto results = std::make_shared<std::vector<std::optional<PostTransactionResult>>>(transactions.size());
+        // transactions which need crypto verification and their positions in results
+        std::vector<Transaction_cptr> transactionsToVerify;
+        std::vector<size_t> positions;
+        for (size_t i = 0; i < transactions.size(); ++i) {
+            (*results)[i] = checkPostedTransaction(transactions[i]);
+            if (!(*results)[i]) {
+                transactionsToVerify.push_back(transactions[i]);
+                positions.push_back(i);
+            }
+        }
+
+        auto finish = [results, cb = std::move(cb)]() {
+            std::vector<PostTransactionResult> ret;
+            ret.reserve(results->size());
+            for (auto& result : *results) {
+                ret.push_back(std::move(*result));
+            }
+            cb(std::move(ret));
+        };
+        if (transactionsToVerify.empty()) {
+            return finish();
+        }
+
+        // do crypto verification of all transactions on other threads
+        m_verifier->verify(transactionsToVerify, (TransactionsVerifyCallback)
+                           [this, transactionsToVerify, positions, results, finish = std::move(finish),
+                           weakSelf = weak_from_this()](auto verified) mutable {
+            ASSERT(std::this_thread::get_id() != m_thread.get_id());
+            auto self = weakSelf.lock();
+            for (size_t i = 0; i < transactionsToVerify.size(); ++i) {
+                auto& result = (*results)[positions[i]];
+                if (!self) {
+                    result = PostTransactionResult(transactionsToVerify[i]->getId(),
+                                                   PostTransactionResult::Status::TIMEOUT);
+                } else if (!verified || (*verified)[i] == 0) {
+                    result = PostTransactionResult(transactionsToVerify[i]->getId(),
+                                                   PostTransactionResult::Status::SIGNATURE_ERROR);
                 }
+            }
+            if (!self) {
+                return finish();
+            }
 
-                return cb(PostTransactionResult(executeTransaction(transaction, getPendingExecutionBlockId(), true)));
+            post([this, transactionsToVerify, positions, results, finish = std::move(finish)]() {
+                ASSERT(std::this_thread::get_id() == m_thread.get_id());
+                for (size_t i = 0; i < transactionsToVerify.size(); ++i) {
+                    auto& result = (*results)[positions[i]];
+                    if (!result) {
+                        result = executePostedTransaction(transactionsToVerify[i]);
+                    }
+                }
+                finish();
             });
         });
     });
 }
 
+std::optional<PostTransactionResult> Blockchain::checkPostedTransaction(const Transaction_cptr& transaction)
+{
+    if (isStopped()) {
+        return PostTransactionResult(transaction->getId(), PostTransactionResult::Status::TIMEOUT);
+    }
+
+    if (isDesynchronized()) {
+        return PostTransactionResult(transaction->getId(), PostTransactionResult::Status::DESYNCHRONIZED);
+    }
+
+    // check is transaction is already pending and executed
+    if (m_pendingTransactions->hasExecutedTransaction(transaction->getId())) {
+        return PostTransactionResult(transaction->getId(), PostTransactionResult::Status::SUCCESS);
+    }
+
+    // add transaction to pending queue if it's requested by some pending block
+    m_pendingTransactions->addTransactionIfRequested(transaction);
+
+    if (!m_pendingTransactions->canAddTransaction(transaction->getId())) {
+        return PostTransactionResult(transaction->getId(), PostTransactionResult::Status::REACHED_PENDING_LIMIT);
+    }
+
+    PostTransactionResult result = canExecuteTransaction(transaction, getPendingExecutionBlockId());
+    if (!result) {
+        return result;
+    }
+    return std::nullopt;
+}
+
+PostTransactionResult Blockchain::executePostedTransaction(const Transaction_cptr& transaction)
+{
+    if (isStopped()) {
+        return PostTransactionResult(transaction->getId(), PostTransactionResult::Status::TIMEOUT);
+    }
+
+    if (!m_pendingTransactions->canAddTransaction(transaction->getId())) {
+        return PostTransactionResult(transaction->getId(), PostTransactionResult::Status::REACHED_PENDING_LIMIT);
+    }
+
+    return executeTransaction(transaction, getPendingExecutionBlockId(), true);
+}
+
 size_t Blockchain::addTransactions(const std::vector<Transaction_cptr>& transactions, const MinerId& reporter)
 {
     // there's no need to move to main thread, bellow functions are thread-safe
@@ -194,6 +288,39 @@ std::vector<Transaction_cptr> Blockchain::getTransactions(const std::vector<Tran
     return ret;
 }
 
+std::vector<std::pair<Transaction_cptr, uint32_t>> Blockchain::getTransactionsWithBlockIds(
+    const std::vector<TransactionId>& transactionIds) const
+{
+    // thread-safe
+    std::vector<std::pair<Transaction_cptr, uint32_t>> ret(transactionIds.size(), { nullptr, 0 });
+    std::vector<TransactionId> missingTransactionIds;
+    std::vector<size_t> positions;
+    auto activeBranch = m_blockTree->getActiveBranch();
+    for (size_t i = 0; i < transactionIds.size(); ++i) {
+        for (auto& node : activeBranch) {
+            auto transaction = node.block->getTransaction(transactionIds[i]);
+            if (transaction) {
+                ret[i] = { transaction, node.getId() };
+                break;
+            }
+        }
+        if (!ret[i].first) {
+            missingTransactionIds.push_back(transactionIds[i]);
+            positions.push_back(i);
+        }
+    }
+
+    auto transactions = m_database->unconfirmed().transactions.getTransactionsWithBlockIds(missingTransactionIds);
+    for (size_t i = 0; i < transactions.size(); ++i) {
+        if (transactions[i].first) {
+            ret[positions[i]] = transactions[i];
+        } else {
+            ret[positions[i]] = { m_pendingTransactions->getTransaction(missingTransactionIds[i]), 0 };
+        }
+    }
+    return ret;
+}
+
 json Blockchain::getDebugInfo() const
 {
     // thread-safe functions
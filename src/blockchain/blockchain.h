@@ -17,6 +17,7 @@
 namespace logpass {
 
 using PostTransactionCallback = SafeCallback<PostTransactionResult>;
+using PostTransactionsCallback = SafeCallback<std::vector<PostTransactionResult>>;
 
 class Blockchain : public EventLoopThread {
 protected:
@@ -35,6 +36,10 @@ public:
     void postTransaction(Serializer& serializer, PostTransactionCallback&& cb) noexcept;
     void postTransaction(const Serializer_ptr& serializer, PostTransactionCallback&& cb) noexcept;
     void postTransaction(const Transaction_cptr& transaction, PostTransactionCallback&& cb) noexcept;
+    // posts multiple transactions with single task on blockchain thread, signatures are verified as one batch,
+    // results are in the same order as transactions
+    void postTransactions(Serializer& serializer, PostTransactionsCallback&& cb) noexcept;
+    void postTransactions(const std::vector<Transaction_cptr>& transactions, PostTransactionsCallback&& cb) noexcept;
 
     // adds transaction to pending transactions without executing them, they will be executed later
     size_t addTransactions(const std::vector<Transaction_cptr>& transactions, const MinerId& reporter);
@@ -45,6 +50,10 @@ public:
     // return transactions if they exist in BlockTree, PendingTransactions or Database, otherwise has nullptr in vector
     std::vector<Transaction_cptr> getTransactions(const std::vector<TransactionId>& transactions) const;
 
+    // the same as getTransaction for multiple transactions, database is read with single multiGet
+    std::vector<std::pair<Transaction_cptr, uint32_t>> getTransactionsWithBlockIds(
+        const std::vector<TransactionId>& transactionIds) const;
+
     // returns debug info
     json getDebugInfo() const;
 
@@ -128,6 +137,10 @@ protected:
     void processPendingTransactions(uint32_t blockId, const chrono::high_resolution_clock::time_point& deadline,
                                     size_t maxTransactions = 0, size_t maxTransactionsSize = 0);
 
+    // checks posted transaction before crypto verification, returns result if it can't be executed
+    std::optional<PostTransactionResult> checkPostedTransaction(const Transaction_cptr& transaction);
+    // executes posted transaction after crypto verification
+    PostTransactionResult executePostedTransaction(const Transaction_cptr& transaction);
     // checks if transaction can be executed
     PostTransactionResult canExecuteTransaction(const Transaction_cptr& transaction, uint32_t blockId);
     // executes transaction
@@ -34,6 +34,7 @@ public:
 
     // allow to post transactions with callback
     using Blockchain::postTransaction;
+    using Blockchain::postTransactions;
 
     // post new serialized transaction, returns true on success
     PostTransactionResult postTransaction(Serializer& serializer) noexcept;
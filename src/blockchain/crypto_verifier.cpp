@@ -60,4 +60,31 @@ std::vector<uint8_t> CryptoVerifier::verify(const std::vector<Transaction_cptr>&
     return results;
 }
 
+void CryptoVerifier::verify(const std::vector<Transaction_cptr>& transactions, TransactionsVerifyCallback&& callback)
+{
+    if (transactions.empty()) {
+        return callback(std::vector<uint8_t>());
+    }
+    struct Batch {
+        Batch(size_t size, TransactionsVerifyCallback&& callback) : results(size, 0), callback(std::move(callback)) {}
+
+        std::vector<uint8_t> results;
+        std::atomic<size_t> validatedTransactions = 0;
+        TransactionsVerifyCallback callback;
+    };
+    auto batch = std::make_shared<Batch>(transactions.size(), std::move(callback));
+    for (size_t index = 0, lastIndex = transactions.size() - 1; auto & transaction : transactions) {
+        boost::asio::post(m_context, [index, lastIndex, transaction, batch] {
+            if (transaction->validateSignatures()) {
+                batch->results[index] = 1;
+            }
+            // acq_rel makes results written by other threads visible to thread calling callback
+            if (batch->validatedTransactions.fetch_add(1, std::memory_order_acq_rel) == lastIndex) {
+                batch->callback(std::move(batch->results));
+            }
+        });
+        ++index;
+    }
+}
+
 }
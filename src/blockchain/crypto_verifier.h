@@ -5,6 +5,7 @@
 namespace logpass {
 
 using TransactionVerifyCallback = SafeCallback<bool>;
+using TransactionsVerifyCallback = SafeCallback<std::vector<uint8_t>>;
 
 class CryptoVerifier {
 public:
@@ -15,6 +16,8 @@ public:
     void verify(const Transaction_cptr& transaction, TransactionVerifyCallback&& callback);
     // verifies multiple transactions, blocks till done
     std::vector<uint8_t> verify(const std::vector<Transaction_cptr>& transactions);
+    // verifies multiple transactions, callback is called once by thread which verified last transaction
+    void verify(const std::vector<Transaction_cptr>& transactions, TransactionsVerifyCallback&& callback);
 
 private:
     asio::io_context m_context;
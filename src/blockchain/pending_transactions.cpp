@@ -48,6 +48,7 @@ size_t PendingTransactions::addTransactions(const std::vector<Transaction_cptr>&
                                           .transaction = transaction,
                                           .reporter = reporter
                                       });
+        addShortTransactionId(transaction->getId());
         m_pendingTransactionsQueue.push_back(transaction);
         m_transactionsSize += transaction->getSize();
         addedTransactions += 1;
@@ -95,6 +96,7 @@ size_t PendingTransactions::addExecutedTransactions(const std::vector<Transactio
             m_pendingTransactions.erase(pendingTransactionIt);
         } else {
             m_transactionsSize += transaction->getSize();
+            addShortTransactionId(transaction->getId());
         }
 
         m_executedTransactions.emplace(transaction->getId(), PendingTransactionEntry{ transaction,
@@ -146,6 +148,7 @@ bool PendingTransactions::addTransactionIfRequested(const Transaction_cptr& tran
                                   PendingTransactionEntry{
                                       .transaction = transaction
                                   });
+    addShortTransactionId(transaction->getId());
     m_pendingTransactionsQueue.push_back(transaction);
     m_transactionsSize += transaction->getSize();
     return true;
@@ -185,6 +188,57 @@ std::map<TransactionId, Transaction_cptr> PendingTransactions::getTransactions(
     return ret;
 }
 
+uint64_t PendingTransactions::getShortTransactionIdsSalt()
+{
+    auto now = chrono::steady_clock::now();
+    {
+        std::shared_lock lock(m_mutex);
+        if (now - m_shortTransactionIdsSaltTime < SHORT_TRANSACTION_IDS_SALT_LIFETIME) {
+            return m_shortTransactionIdsSalt;
+        }
+    }
+
+    std::unique_lock lock(m_mutex);
+    if (now - m_shortTransactionIdsSaltTime >= SHORT_TRANSACTION_IDS_SALT_LIFETIME) {
+        m_shortTransactionIdsSalt = ShortTransactionIds::generateSalt();
+        m_shortTransactionIdsSaltTime = now;
+        m_shortTransactionIds.clear();
+        for (auto& [transactionId, entry] : m_pendingTransactions) {
+            addShortTransactionId(transactionId);
+        }
+        for (auto& [transactionId, entry] : m_executedTransactions) {
+            addShortTransactionId(transactionId);
+        }
+    }
+    return m_shortTransactionIdsSalt;
+}
+
+std::map<uint64_t, TransactionId> PendingTransactions::getTransactionIds(
+    uint64_t salt, const std::set<uint64_t>& shortTransactionIds) const
+{
+    std::shared_lock lock(m_mutex);
+    std::map<uint64_t, TransactionId> ret;
+    if (salt == m_shortTransactionIdsSalt) {
+        for (uint64_t shortTransactionId : shortTransactionIds) {
+            auto [begin, end] = m_shortTransactionIds.equal_range(shortTransactionId);
+            if (begin != end && std::next(begin) == end) {
+                ret.emplace(shortTransactionId, begin->second);
+            }
+        }
+        return ret;
+    }
+
+    // index was rebuilt with new salt after request, it should be rare
+    ShortTransactionIds index(salt);
+    index.addTransactionIds(m_pendingTransactions | std::views::keys);
+    index.addTransactionIds(m_executedTransactions | std::views::keys);
+    for (uint64_t shortTransactionId : shortTransactionIds) {
+        if (auto transactionId = index.getTransactionId(shortTransactionId)) {
+            ret.emplace(shortTransactionId, *transactionId);
+        }
+    }
+    return ret;
+}
 
 bool PendingTransactions::hasExecutedTransaction(const TransactionId& transactionId) const
 {
@@ -346,6 +400,7 @@ void PendingTransactions::updateTransactions(const std::vector<std::pair<Transac
             ASSERT(it != m_pendingTransactions.end());
             m_transactionsSize -= transaction->getSize();
             m_pendingTransactions.erase(it);
+            removeShortTransactionId(transaction->getId());
         }
     }
 }
@@ -360,6 +415,7 @@ void PendingTransactions::removeTransactions(const std::set<TransactionId>& tran
         }
         m_pendingTransactions.erase(it);
         m_transactionsSize -= transactionId.getSize();
+        removeShortTransactionId(transactionId);
     }
 
     auto it = std::remove_if(m_pendingTransactionsQueue.begin(), m_pendingTransactionsQueue.end(),
@@ -446,6 +502,24 @@ uint32_t PendingTransactions::getMaxPendingTransactionsSize() const
     return kBlockMaxTransactionsSize * 8;
 }
 
+void PendingTransactions::addShortTransactionId(const TransactionId& transactionId)
+{
+    m_shortTransactionIds.emplace(ShortTransactionIds::calculateValue(m_shortTransactionIdsSalt, transactionId),
+                                  transactionId);
+}
+
+void PendingTransactions::removeShortTransactionId(const TransactionId& transactionId)
+{
+    auto [begin, end] = m_shortTransactionIds.equal_range(
+        ShortTransactionIds::calculateValue(m_shortTransactionIdsSalt, transactionId));
+    for (auto it = begin; it != end; ++it) {
+        if (it->second == transactionId) {
+            m_shortTransactionIds.erase(it);
+            return;
+        }
+    }
+}
+
 json PendingTransactions::getDebugInfo() const
 {
     std::shared_lock lock(m_mutex);
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <database/database.h>
+#include <crypto/short_transaction_ids.h>
 
 #include "events.h"
 #include "block/pending_block.h"
@@ -18,6 +19,9 @@ class PendingTransactions {
     };
 
 public:
+    // salt of short transaction ids index is changed after that time, so it can't be used to craft collisions
+    static constexpr chrono::seconds SHORT_TRANSACTION_IDS_SALT_LIFETIME = chrono::seconds(60);
+
     PendingTransactions() = default;
     PendingTransactions(const PendingTransactions&) = delete;
     PendingTransactions& operator=(const PendingTransactions&) = delete;
@@ -46,6 +50,15 @@ public:
     // return transactions
     std::map<TransactionId, Transaction_cptr> getTransactions(const std::set<TransactionId>& transactionIds) const;
 
+    // returns salt of short transaction ids index of pending and executed transactions, should be used for
+    // short transaction ids requested from peers
+    uint64_t getShortTransactionIdsSalt();
+
+    // returns ids of pending and executed transactions with given short ids, unknown and ambiguous short ids are
+    // skipped, when salt isn't the one of index then all transactions ids are checked
+    std::map<uint64_t, TransactionId> getTransactionIds(uint64_t salt,
+                                                        const std::set<uint64_t>& shortTransactionIds) const;
+
     // checks if transaction with given id is executed
     bool hasExecutedTransaction(const TransactionId& transactionId) const;
 
@@ -114,6 +127,10 @@ public:
     json getDebugInfo() const;
 
 private:
+    // adds and removes transaction from short transaction ids index, m_mutex must be locked
+    void addShortTransactionId(const TransactionId& transactionId);
+    void removeShortTransactionId(const TransactionId& transactionId);
+
     mutable std::shared_mutex m_mutex;
     std::map<TransactionId, PendingTransactionEntry> m_executedTransactions;
     std::map<TransactionId, PendingTransactionEntry> m_pendingTransactions;
@@ -121,6 +138,10 @@ private:
     std::deque<Transaction_cptr> m_pendingTransactionsQueue;
     uint32_t m_executedTransactionsSize = 0;
     uint32_t m_transactionsSize = 0;
+    // short ids of pending and executed transactions calculated with m_shortTransactionIdsSalt
+    std::multimap<uint64_t, TransactionId> m_shortTransactionIds;
+    uint64_t m_shortTransactionIdsSalt = ShortTransactionIds::generateSalt();
+    chrono::steady_clock::time_point m_shortTransactionIdsSaltTime = chrono::steady_clock::now();
 };
 
 }
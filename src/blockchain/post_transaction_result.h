@@ -30,6 +30,11 @@ public:
         return m_transactionId;
     }
 
+    Status getStatusCode() const
+    {
+        return m_status;
+    }
+
     std::string getStatus() const
     {
         switch (m_status) {
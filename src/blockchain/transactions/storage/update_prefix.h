@@ -21,6 +21,11 @@ public:
 
     void toJSON(json& j) const final;
 
+    const std::string& getPrefix() const
+    {
+        return m_prefix;
+    }
+
     constexpr virtual TransactionSettings getTransactionSettings() const
     {
         return TransactionSettings{
@@ -9,9 +9,10 @@ namespace logpass {
 Acceptor::Acceptor(asio::io_context& context, const boost::asio::ip::tcp::endpoint& endpoint,
                    const MinerId& minerId, const std::shared_ptr<Certificate>& certificate,
                    const std::function<bool(Connection_ptr)>& onConnection,
-                   const ConnectionCallbacks& connectionCallbacks) :
+                   const ConnectionCallbacks& connectionCallbacks, ContextPool* contextPool) :
     m_context(context), m_endpoint(endpoint), m_minerId(minerId), m_certificate(certificate),
-    m_onConnection(onConnection), m_connectionCallbacks(connectionCallbacks), m_acceptor(m_context), m_timer(context)
+    m_onConnection(onConnection), m_connectionCallbacks(connectionCallbacks), m_contextPool(contextPool),
+    m_acceptor(m_context), m_timer(context)
 {
     ASSERT(m_onConnection && m_minerId.isValid());
     m_logger.add_attribute("Class", boost::log::attributes::constant<std::string>("Acceptor"));
@@ -70,7 +71,9 @@ void Acceptor::accept()
         return;
     }
 
-    m_acceptor.async_accept([this, self = shared_from_this()](boost::system::error_code ec, auto socket) {
+    asio::io_context* context = m_contextPool ? &m_contextPool->getContext() : &m_context;
+    m_acceptor.async_accept(*context, [this, context, self = shared_from_this()](boost::system::error_code ec,
+                                                                                auto socket) {
         if (m_closed) {
             return;
         }
@@ -83,10 +86,10 @@ void Acceptor::accept()
         LOG_CLASS(debug) << "incoming connection from " << socket.remote_endpoint(ec);
         Connection_ptr connection;
         if (m_certificate) {
-            connection = std::make_shared<SecureConnection>(m_context, std::move(socket), m_certificate, m_minerId,
+            connection = std::make_shared<SecureConnection>(*context, std::move(socket), m_certificate, m_minerId,
                                                             MinerId(), m_connectionCallbacks);
         } else {
-            connection = std::make_shared<UnsecureConnection>(m_context, std::move(socket), m_minerId, MinerId(),
+            connection = std::make_shared<UnsecureConnection>(*context, std::move(socket), m_minerId, MinerId(),
                                                               m_connectionCallbacks);
         }
 
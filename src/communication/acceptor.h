@@ -1,6 +1,7 @@
 #pragma once
 
 #include "connection/connection.h"
+#include "context_pool.h"
 
 namespace logpass {
 
@@ -9,7 +10,7 @@ public:
     Acceptor(asio::io_context& context, const boost::asio::ip::tcp::endpoint& endpoint,
              const MinerId& minerId, const std::shared_ptr<Certificate>& certificate,
              const std::function<bool(Connection_ptr)>& onConnection,
-             const ConnectionCallbacks& connectionCallbacks);
+             const ConnectionCallbacks& connectionCallbacks, ContextPool* contextPool = nullptr);
     ~Acceptor();
 
     void open();
@@ -37,6 +38,8 @@ private:
     const std::shared_ptr<Certificate> m_certificate;
     const std::function<bool(Connection_ptr)> m_onConnection;
     const ConnectionCallbacks m_connectionCallbacks;
+    // if set, accepted connections are working on contexts from this pool
+    ContextPool* const m_contextPool;
 
     Logger m_logger;
     bool m_closed = true;
@@ -0,0 +1,225 @@
+#include "pch.h"
+
+#include "block_downloader.h"
+#include "packets/get_block.h"
+
+namespace logpass {
+
+namespace {
+
+bool isDownloadable(PendingBlock::Status status)
+{
+    return status == PendingBlock::Status::MISSING_TRANSACTION_IDS ||
+        status == PendingBlock::Status::MISSING_TRANSACTIONS;
+}
+
+}
+
+void BlockDownloader::addPendingBlock(const PendingBlock_ptr& pendingBlock)
+{
+    std::lock_guard lock(m_mutex);
+    getEntry(pendingBlock);
+}
+
+std::optional<BlockDownloadAssignment> BlockDownloader::assign(const PendingBlock_ptr& pendingBlock,
+                                                               const MinerId& minerId, bool endgame)
+{
+    std::lock_guard lock(m_mutex);
+    return assign(getEntry(pendingBlock), minerId, endgame);
+}
+
+BlockDownloader::Entry& BlockDownloader::getEntry(const PendingBlock_ptr& pendingBlock)
+{
+    cleanup();
+    auto it = std::find_if(m_entries.begin(), m_entries.end(), [&](auto& entry) {
+        return entry.pendingBlock == pendingBlock;
+    });
+    if (it != m_entries.end()) {
+        return *it;
+    }
+    m_entries.push_back(Entry{ .pendingBlock = pendingBlock });
+    // removing from front doesn't invalidate reference to last entry
+    if (m_entries.size() > MAX_PENDING_BLOCKS) {
+        m_entries.pop_front();
+    }
+    return m_entries.back();
+}
+
+std::optional<BlockDownloadAssignment> BlockDownloader::assign(uint32_t maxDepth, const MinerId& minerId)
+{
+    std::lock_guard lock(m_mutex);
+    cleanup();
+    for (auto& entry : m_entries) {
+        if (entry.pendingBlock->getDepth() > maxDepth || entry.failedMiners.contains(minerId)) {
+            continue;
+        }
+        auto assignment = assign(entry, minerId, false);
+        if (assignment) {
+            return assignment;
+        }
+    }
+    return std::nullopt;
+}
+
+std::optional<BlockDownloadAssignment> BlockDownloader::assign(Entry& entry, const MinerId& minerId, bool endgame)
+{
+    auto status = entry.pendingBlock->getStatus();
+    if (!isDownloadable(status)) {
+        return std::nullopt;
+    }
+
+    auto now = chrono::steady_clock::now();
+    double throughput = getThroughput(minerId);
+    size_t sizeLimit = std::clamp((size_t)(throughput * REQUEST_DURATION), MIN_REQUEST_SIZE,
+                                  GetBlockPacket::MAX_TRANSACTIONS_SIZE);
+    BlockDownloadAssignment assignment{ .pendingBlock = entry.pendingBlock, .status = status };
+
+    // in first pass not assigned and timed out parts are used, in endgame parts assigned to other miners
+    size_t size = 0;
+    auto canAssign = [&](auto& requests, auto& key, bool endgamePass) {
+        auto it = requests.find(key);
+        bool isFree = it == requests.end() || it->second.deadline <= now;
+        if (!endgamePass) {
+            return isFree;
+        }
+        return !isFree && it->second.minerId != minerId;
+    };
+    for (bool endgamePass : { false, true }) {
+        if (endgamePass && (!endgame || size > 0)) {
+            break;
+        }
+        if (status == PendingBlock::Status::MISSING_TRANSACTION_IDS) {
+            size_t chunkSize = kBlockTransactionsPerChunk * TransactionId::SIZE;
+            for (auto& [index, hash] : entry.pendingBlock->getMissingTransactionIdsHashes()) {
+                if (size > 0 && size + chunkSize > sizeLimit) {
+                    break;
+                }
+                if (assignment.transactionIdsHashes.size() == GetBlockPacket::MAX_TRANSACTION_IDS) {
+                    break;
+                }
+                if (!canAssign(entry.transactionIdsRequests, index, endgamePass)) {
+                    continue;
+                }
+                assignment.transactionIdsHashes.emplace_back(index, hash);
+                size += chunkSize;
+            }
+        } else {
+            for (auto& transactionId : entry.pendingBlock->getMissingTransactionIds()) {
+                if (size > 0 && size + transactionId.getSize() > sizeLimit) {
+                    break;
+                }
+                if (assignment.transactionIds.size() == GetBlockPacket::MAX_TRANSACTIONS) {
+                    break;
+                }
+                if (!canAssign(entry.transactionsRequests, transactionId, endgamePass)) {
+                    continue;
+                }
+                assignment.transactionIds.insert(transactionId);
+                size += transactionId.getSize();
+            }
+        }
+    }
+
+    if (size == 0) {
+        return std::nullopt;
+    }
+
+    // slow peers get more time, but not less than MIN_TIMEOUT
+    auto timeout = std::max<chrono::steady_clock::duration>(MIN_TIMEOUT,
+        chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double>(4 * size / throughput)));
+    Request request{ .minerId = minerId, .deadline = now + timeout };
+    for (auto& [index, hash] : assignment.transactionIdsHashes) {
+        entry.transactionIdsRequests[index] = request;
+    }
+    for (auto& transactionId : assignment.transactionIds) {
+        entry.transactionsRequests[transactionId] = request;
+    }
+    return assignment;
+}
+
+void BlockDownloader::finish(const BlockDownloadAssignment& assignment, const MinerId& minerId, size_t size,
+                             chrono::steady_clock::duration duration, bool succeeded)
+{
+    std::lock_guard lock(m_mutex);
+    auto it = std::find_if(m_entries.begin(), m_entries.end(), [&](auto& entry) {
+        return entry.pendingBlock == assignment.pendingBlock;
+    });
+    if (it != m_entries.end()) {
+        for (auto& [index, hash] : assignment.transactionIdsHashes) {
+            auto requestIt = it->transactionIdsRequests.find(index);
+            if (requestIt != it->transactionIdsRequests.end() && requestIt->second.minerId == minerId) {
+                it->transactionIdsRequests.erase(requestIt);
+            }
+        }
+        for (auto& transactionId : assignment.transactionIds) {
+            auto requestIt = it->transactionsRequests.find(transactionId);
+            if (requestIt != it->transactionsRequests.end() && requestIt->second.minerId == minerId) {
+                it->transactionsRequests.erase(requestIt);
+            }
+        }
+        if (!succeeded) {
+            it->failedMiners.insert(minerId);
+        }
+    }
+
+    if (!succeeded || size == 0) {
+        return;
+    }
+    double throughput = size / std::max(chrono::duration<double>(duration).count(), 0.001);
+    auto [throughputIt, inserted] = m_throughput.emplace(minerId, throughput);
+    if (!inserted) {
+        throughputIt->second = (throughputIt->second * 3 + throughput) / 4;
+    }
+}
+
+void BlockDownloader::cancel(const MinerId& minerId)
+{
+    std::lock_guard lock(m_mutex);
+    for (auto& entry : m_entries) {
+        std::erase_if(entry.transactionIdsRequests, [&](auto& request) {
+            return request.second.minerId == minerId;
+        });
+        std::erase_if(entry.transactionsRequests, [&](auto& request) {
+            return request.second.minerId == minerId;
+        });
+    }
+    m_throughput.erase(minerId);
+}
+
+double BlockDownloader::getThroughput(const MinerId& minerId) const
+{
+    auto it = m_throughput.find(minerId);
+    if (it == m_throughput.end()) {
+        return DEFAULT_THROUGHPUT;
+    }
+    return std::max(it->second, 1.0);
+}
+
+void BlockDownloader::cleanup()
+{
+    std::erase_if(m_entries, [](auto& entry) {
+        auto status = entry.pendingBlock->getStatus();
+        return !isDownloadable(status) && status != PendingBlock::Status::MISSING_BODY;
+    });
+}
+
+json BlockDownloader::getDebugInfo() const
+{
+    std::lock_guard lock(m_mutex);
+    json j;
+    j["pending_blocks"] = json::array();
+    for (auto& entry : m_entries) {
+        j["pending_blocks"].push_back({
+            {"block", entry.pendingBlock->toString()},
+            {"requested_transaction_ids", entry.transactionIdsRequests.size()},
+            {"requested_transactions", entry.transactionsRequests.size()},
+            {"failed_miners", entry.failedMiners.size()}
+        });
+    }
+    for (auto& [minerId, throughput] : m_throughput) {
+        j["throughput"][minerId.toString()] = (uint64_t)throughput;
+    }
+    return j;
+}
+
+}
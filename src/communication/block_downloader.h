@@ -0,0 +1,74 @@
+#pragma once
+
+#include <blockchain/block/pending_block.h>
+
+namespace logpass {
+
+// parts of pending block assigned to one peer
+struct BlockDownloadAssignment {
+    PendingBlock_ptr pendingBlock;
+    PendingBlock::Status status;
+    std::vector<std::pair<uint32_t, Hash>> transactionIdsHashes;
+    std::set<TransactionId> transactionIds;
+};
+
+// splits missing transaction ids chunks and transactions of pending blocks between peers which have these blocks,
+// size of assigned parts depends on measured throughput of peer, timed out parts are assigned again, thread-safe
+class BlockDownloader {
+public:
+    static constexpr size_t MAX_PENDING_BLOCKS = 8;
+    static constexpr double DEFAULT_THROUGHPUT = 1024 * 1024; // in bytes per second
+    static constexpr double REQUEST_DURATION = 0.5; // expected duration of request in seconds
+    static constexpr size_t MIN_REQUEST_SIZE = 64 * 1024;
+    static constexpr chrono::seconds MIN_TIMEOUT = chrono::seconds(2);
+
+    BlockDownloader() = default;
+    BlockDownloader(const BlockDownloader&) = delete;
+    BlockDownloader& operator=(const BlockDownloader&) = delete;
+
+    // adds pending block which can be downloaded from many peers
+    void addPendingBlock(const PendingBlock_ptr& pendingBlock);
+
+    // assigns missing parts of pending block to given miner, when all parts are assigned to other miners and
+    // endgame is true then parts are assigned again to given miner, returns nullopt if there's nothing to assign
+    std::optional<BlockDownloadAssignment> assign(const PendingBlock_ptr& pendingBlock, const MinerId& minerId,
+                                                  bool endgame);
+
+    // assigns not assigned missing parts of any pending block with depth not higher than given one
+    std::optional<BlockDownloadAssignment> assign(uint32_t maxDepth, const MinerId& minerId);
+
+    // releases assigned parts and updates throughput of miner
+    void finish(const BlockDownloadAssignment& assignment, const MinerId& minerId, size_t size,
+                chrono::steady_clock::duration duration, bool succeeded);
+
+    // releases all parts assigned to given miner
+    void cancel(const MinerId& minerId);
+
+    json getDebugInfo() const;
+
+private:
+    struct Request {
+        MinerId minerId;
+        chrono::steady_clock::time_point deadline;
+    };
+
+    struct Entry {
+        PendingBlock_ptr pendingBlock;
+        std::map<uint32_t, Request> transactionIdsRequests;
+        std::map<TransactionId, Request> transactionsRequests;
+        std::set<MinerId> failedMiners;
+    };
+
+    // returns entry of pending block, adds it if it's missing and removes the oldest one above MAX_PENDING_BLOCKS,
+    // m_mutex must be locked
+    Entry& getEntry(const PendingBlock_ptr& pendingBlock);
+    std::optional<BlockDownloadAssignment> assign(Entry& entry, const MinerId& minerId, bool endgame);
+    double getThroughput(const MinerId& minerId) const;
+    void cleanup();
+
+    mutable std::mutex m_mutex;
+    std::deque<Entry> m_entries;
+    std::map<MinerId, double> m_throughput;
+};
+
+}
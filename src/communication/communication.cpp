@@ -2,15 +2,34 @@
 
 #include "communication.h"
 #include "connection/secure_connection.h"
+#include "connection/simulated_connection.h"
 #include "connection/unsecure_connection.h"
 #include "packets/packet.h"
 
 namespace logpass {
 
+namespace {
+
+// collects debug info of connections and sessions from their strands, calls callback when it's destroyed
+struct DebugInfoCollector {
+    DebugInfoCollector(SafeCallback<json>&& callback) : callback(std::move(callback)) {}
+
+    ~DebugInfoCollector()
+    {
+        callback(std::move(info));
+    }
+
+    std::mutex mutex;
+    json info;
+    SafeCallback<json> callback;
+};
+
+}
+
 Communication::Communication(const CommunicationOptions& options, const std::shared_ptr<Blockchain>& blockchain,
                              const std::shared_ptr<const Database>& database) :
     EventLoopThread("communication"), m_options(options), m_blockchain(blockchain), m_database(database),
-    m_timer(m_context), m_connectionManager(blockchain->getMinerId())
+    m_timer(m_context), m_contextPool(options.threads), m_connectionManager(blockchain->getMinerId())
 {
     ASSERT(m_options.port != 0);
 
@@ -34,11 +53,16 @@ void Communication::start()
             .onPacket = std::bind(&Communication::onConnectionPacket, self, std::placeholders::_1, std::placeholders::_2),
         };
 
-        asio::ip::tcp::endpoint endpoint(asio::ip::make_address(m_options.host), m_options.port);
-        m_acceptor = std::make_shared<Acceptor>(m_context, endpoint, m_blockchain->getMinerId(), m_certificate,
-                                                std::bind(&Communication::onConnection, self, std::placeholders::_1),
-                                                callbacks);
-        m_acceptor->open();
+        if (m_options.simulatedNetwork) {
+            listenOnSimulatedNetwork(callbacks);
+        } else {
+            asio::ip::tcp::endpoint endpoint(asio::ip::make_address(m_options.host), m_options.port);
+            m_acceptor = std::make_shared<Acceptor>(m_context, endpoint, m_blockchain->getMinerId(), m_certificate,
+                                                    std::bind(&Communication::onConnection, self,
+                                                              std::placeholders::_1),
+                                                    callbacks, &m_contextPool);
+            m_acceptor->open();
+        }
         updateMiners();
 
         m_eventsListener = m_blockchain->registerEventsListener(EventsListenerCallbacks{
@@ -53,18 +77,24 @@ void Communication::start()
         check();
     });
 
+    m_contextPool.start();
     EventLoopThread::start();
 }
 
 void Communication::stop()
 {
-    post([this] {
+    std::promise<void> closed;
+    post([&] {
         LOG_CLASS(debug) << "stopping";
         m_eventsListener = nullptr;
         close();
         m_acceptor = nullptr;
         m_timer.cancel();
+        closed.set_value();
     });
+    closed.get_future().wait();
+    // waits until all connections are closed
+    m_contextPool.stop();
     EventLoopThread::stop();
     ASSERT(m_sessions.empty());
 }
@@ -72,7 +102,13 @@ void Communication::stop()
 void Communication::close()
 {
     ASSERT(std::this_thread::get_id() == m_thread.get_id());
-    m_acceptor->close();
+    if (m_acceptor) {
+        m_acceptor->close();
+    }
+    if (m_options.simulatedNetwork) {
+        m_options.simulatedNetwork->unlisten(Endpoint(m_options.host, m_options.port));
+    }
+    std::lock_guard lock(m_connectionsMutex);
     for (auto& connection : m_connectionManager.getConnections()) {
         connection->close("shutdown");
     }
@@ -88,22 +124,18 @@ void Communication::check()
     checkConnections();
 
     // check sessions
+    std::lock_guard lock(m_connectionsMutex);
     for (auto& [minerId, session] : m_sessions) {
-        try {
-            session->onPeriodicalCheck();
-        } catch (const SessionException& exception) {
-            Connection* connection = m_connectionManager.getConnection(minerId);
-            if (connection) {
-                connection->close(exception.what());
-                m_connectionManager.blockMinerId(connection->getMinerId(), std::chrono::seconds(60));
-            }
-        }
+        postToSession(minerId, session, [](Session& session) {
+            session.onPeriodicalCheck();
+        });
     }
 }
 
 void Communication::checkConnections()
 {
     ASSERT(std::this_thread::get_id() == m_thread.get_id());
+    std::lock_guard lock(m_connectionsMutex);
 
     // close connections
     auto connectionsToEnd = m_connectionManager.getConnectionsToEnd();
@@ -120,6 +152,7 @@ void Communication::checkConnections()
 
 bool Communication::onConnection(Connection_ptr connection)
 {
+    std::lock_guard lock(m_connectionsMutex);
     if (m_connectionManager.getPendingConnections().size() >= kNetworkMaxPendingConnections) {
         return false;
     }
@@ -128,10 +161,35 @@ bool Communication::onConnection(Connection_ptr connection)
         return false;
     }
 
-    connection->start();
+    asio::post(connection->getStrand(), [connection] {
+        connection->start();
+    });
     return true;
 }
 
+void Communication::listenOnSimulatedNetwork(const ConnectionCallbacks& callbacks)
+{
+    ASSERT(std::this_thread::get_id() == m_thread.get_id());
+    auto self(std::dynamic_pointer_cast<Communication>(shared_from_this()));
+    Endpoint localEndpoint(m_options.host, m_options.port);
+    m_options.simulatedNetwork->listen(localEndpoint, [self, localEndpoint, callbacks](auto remote, auto endpoint) {
+        if (self->isStopped()) {
+            return std::shared_ptr<SimulatedConnection>();
+        }
+        auto connection = std::make_shared<SimulatedConnection>(self->m_contextPool.getContext(),
+                                                                self->m_options.simulatedNetwork, localEndpoint,
+                                                                self->m_blockchain->getMinerId(), MinerId(),
+                                                                callbacks);
+        connection->setRemote(remote, endpoint);
+        if (!self->onConnection(connection)) {
+            connection->close("not accepted");
+            return std::shared_ptr<SimulatedConnection>();
+        }
+        return connection;
+    });
+    LOG_CLASS(info) << "Listening on simulated network " << localEndpoint;
+}
+
 Connection_ptr Communication::connect(const MinerId& minerId, const Endpoint& endpoint)
 {
     ASSERT(std::this_thread::get_id() == m_thread.get_id());
@@ -141,10 +199,12 @@ Connection_ptr Communication::connect(const MinerId& minerId, const Endpoint& en
     if (!minerId.isValid() || minerId == m_blockchain->getMinerId()) {
         return nullptr;
     }
-    if (m_connectionManager.hasPendingConnection(minerId)) {
+    if (!endpoint.isValid()) {
         return nullptr;
     }
-    if (!endpoint.isValid()) {
+
+    std::lock_guard lock(m_connectionsMutex);
+    if (m_connectionManager.hasPendingConnection(minerId)) {
         return nullptr;
     }
 
@@ -156,12 +216,17 @@ Connection_ptr Communication::connect(const MinerId& minerId, const Endpoint& en
         .onPacket = std::bind(&Communication::onConnectionPacket, self, std::placeholders::_1, std::placeholders::_2),
     };
 
+    asio::io_context& context = m_contextPool.getContext();
     Connection_ptr connection;
-    if (!m_certificate) {
-        connection = std::make_shared<UnsecureConnection>(m_context, std::move(asio::ip::tcp::socket(m_context)),
+    if (m_options.simulatedNetwork) {
+        connection = std::make_shared<SimulatedConnection>(context, m_options.simulatedNetwork,
+                                                           Endpoint(m_options.host, m_options.port),
+                                                           m_blockchain->getMinerId(), minerId, callbacks);
+    } else if (!m_certificate) {
+        connection = std::make_shared<UnsecureConnection>(context, std::move(asio::ip::tcp::socket(context)),
                                                           m_blockchain->getMinerId(), minerId, callbacks);
     } else {
-        connection = std::make_shared<SecureConnection>(m_context, std::move(asio::ip::tcp::socket(m_context)),
+        connection = std::make_shared<SecureConnection>(context, std::move(asio::ip::tcp::socket(context)),
                                                         m_certificate, m_blockchain->getMinerId(), minerId, callbacks);
     }
 
@@ -169,26 +234,35 @@ Connection_ptr Communication::connect(const MinerId& minerId, const Endpoint& en
         return nullptr;
     }
 
-    connection->start(endpoint);
+    asio::post(connection->getStrand(), [connection, endpoint] {
+        connection->start(endpoint);
+    });
     return connection;
 }
 
 void Communication::onConnectionEnd(Connection* connection)
 {
-    ASSERT(std::this_thread::get_id() == m_thread.get_id());
-    if (connection->isAccepted()) {
-        ASSERT(connection->getMinerId().isValid());
-        auto it = m_sessions.find(connection->getMinerId());
-        ASSERT(it != m_sessions.end());
-        it->second->onDisconnected();
-        m_sessions.erase(it);
+    ASSERT(connection->getStrand().running_in_this_thread());
+    std::shared_ptr<Session> session;
+    {
+        std::lock_guard lock(m_connectionsMutex);
+        if (connection->isAccepted()) {
+            ASSERT(connection->getMinerId().isValid());
+            auto it = m_sessions.find(connection->getMinerId());
+            ASSERT(it != m_sessions.end());
+            session = it->second;
+            m_sessions.erase(it);
+        }
+        m_connectionManager.removeConnection(connection);
+    }
+    if (session) {
+        session->onDisconnected();
     }
-    m_connectionManager.removeConnection(connection);
 }
 
 bool Communication::onConnectionParams(Connection* connection, const MinerId& minerId)
 {
-    ASSERT(std::this_thread::get_id() == m_thread.get_id());
+    ASSERT(connection->getStrand().running_in_this_thread());
     ASSERT(connection->getMinerId() == minerId);
     if (!minerId.isValid() || minerId == m_blockchain->getMinerId()) {
         return false;
@@ -200,58 +274,102 @@ bool Communication::onConnectionParams(Connection* connection, const MinerId& mi
         return false; // miner does not exist
     }
 
+    std::lock_guard lock(m_connectionsMutex);
     return m_connectionManager.canAcceptConnection(connection, isDesynchronized);
 }
 
 bool Communication::onConnectionReady(Connection* connection)
 {
-    ASSERT(std::this_thread::get_id() == m_thread.get_id());
+    ASSERT(connection->getStrand().running_in_this_thread());
     ASSERT(connection->getMinerId().isValid());
 
-    if (!m_connectionManager.acceptConnection(connection)) {
-        return false;
-    }
+    std::shared_ptr<Session> session;
+    BlockHeader_cptr lastBlockHeader;
+    {
+        std::lock_guard lock(m_connectionsMutex);
+        if (!m_connectionManager.acceptConnection(connection)) {
+            return false;
+        }
 
-    ASSERT(m_sessions.count(connection->getMinerId()) == 0);
-    auto session = std::make_shared<Session>(connection->getMinerId(), m_blockchain, m_database);
-    session->onConnected(connection, m_lastBlockHeader);
-    m_sessions.emplace(connection->getMinerId(), session);
+        ASSERT(m_sessions.count(connection->getMinerId()) == 0);
+        session = std::make_shared<Session>(connection->getMinerId(), m_blockchain, m_database,
+                                            m_transactionRequests, m_blockDownloader);
+        m_sessions.emplace(connection->getMinerId(), session);
+        lastBlockHeader = m_lastBlockHeader;
+    }
 
+    // tasks posted to session before this call are executed after it, on the same strand
+    session->onConnected(connection, lastBlockHeader);
     return true;
 }
 
 bool Communication::onConnectionPacket(Connection* connection, const Packet_ptr& packet)
 {
-    ASSERT(std::this_thread::get_id() == m_thread.get_id());
+    ASSERT(connection->getStrand().running_in_this_thread());
     ASSERT(connection->isAccepted());
-    auto sessionIt = m_sessions.find(connection->getMinerId());
-    ASSERT(sessionIt != m_sessions.end());
-    auto& session = sessionIt->second;
+    std::shared_ptr<Session> session;
+    {
+        std::lock_guard lock(m_connectionsMutex);
+        auto sessionIt = m_sessions.find(connection->getMinerId());
+        ASSERT(sessionIt != m_sessions.end());
+        session = sessionIt->second;
+    }
     try {
         return session->onPacket(packet);
     } catch (const SessionException& exception) {
-        connection->close(exception.what());
-        m_connectionManager.blockMinerId(connection->getMinerId(), std::chrono::seconds(60));
+        onSessionException(connection, exception);
     }
     return false;
 }
 
+void Communication::postToSession(const MinerId& minerId, const std::shared_ptr<Session>& session,
+                                  std::function<void(Session&)>&& task)
+{
+    Connection* connection = m_connectionManager.getConnection(minerId);
+    ASSERT(connection != nullptr);
+    asio::post(connection->getStrand(), [this, session, connection = connection->shared_from_this(),
+                                         task = std::move(task)] {
+        if (!session->isConnected()) {
+            return;
+        }
+        try {
+            task(*session);
+        } catch (const SessionException& exception) {
+            onSessionException(connection.get(), exception);
+        }
+    });
+}
+
+void Communication::onSessionException(Connection* connection, const SessionException& exception)
+{
+    connection->close(exception.what());
+    std::lock_guard lock(m_connectionsMutex);
+    m_connectionManager.blockMinerId(connection->getMinerId(), std::chrono::seconds(60));
+}
 
 void Communication::onBlocks(const std::vector<Block_cptr>& blocks, bool didChangeBranch)
 {
     ASSERT(std::this_thread::get_id() == m_thread.get_id());
-    m_lastBlockHeader = blocks.back()->getBlockHeader();
     updateMiners();
+    std::lock_guard lock(m_connectionsMutex);
+    m_lastBlockHeader = blocks.back()->getBlockHeader();
     for (auto& [minerId, session] : m_sessions) {
-        session->onBlocks(blocks, didChangeBranch);
+        postToSession(minerId, session, [blocks, didChangeBranch](Session& session) {
+            session.onBlocks(blocks, didChangeBranch);
+        });
     }
 }
 
 void Communication::onNewTransactions(const std::vector<Transaction_cptr>& transactions)
 {
     ASSERT(std::this_thread::get_id() == m_thread.get_id());
+    std::lock_guard lock(m_connectionsMutex);
     for (auto& [minerId, session] : m_sessions) {
-        session->onNewTransactions(transactions);
+        // trusted and high priority miners get new transactions with lowest latency
+        bool flooding = m_connectionManager.getMinerIndex(minerId) <= 1;
+        postToSession(minerId, session, [transactions, flooding](Session& session) {
+            session.onNewTransactions(transactions, flooding);
+        });
     }
 }
 
@@ -288,21 +406,56 @@ void Communication::updateMiners()
     mediumPriorityMiners.erase(m_blockchain->getMinerId());
     lowPriorityMiners.erase(m_blockchain->getMinerId());
 
+    std::lock_guard lock(m_connectionsMutex);
     m_connectionManager.setPriorityMiners(highPriorityMiners, mediumPriorityMiners, lowPriorityMiners);
 }
 
 void Communication::getDebugInfo(SafeCallback<json>&& callback) const
 {
-    post([this, callback = std::move(callback)]{
-        json sessions = std::map<std::string, json>();
-        for (auto& [minerId, session] : m_sessions) {
-            sessions.emplace(minerId.toString(), session->getDebugInfo());
+    post([this, callback = std::move(callback)]() mutable {
+        auto collector = std::make_shared<DebugInfoCollector>(std::move(callback));
+        std::lock_guard lock(m_connectionsMutex);
+        collector->info = json{
+            { "connections", m_connectionManager.getDebugInfo() },
+            { "transaction_requests", m_transactionRequests->getDebugInfo() },
+            { "block_downloader", m_blockDownloader->getDebugInfo() },
+            { "sessions", std::map<std::string, json>() }
+        };
+        if (m_options.simulatedNetwork) {
+            collector->info["simulated_network"] = m_options.simulatedNetwork->getDebugInfo();
         }
 
-        callback(json{
-            { "connections", m_connectionManager.getDebugInfo() },
-            { "sessions", sessions }
-        });
+        // connections and sessions are not thread-safe, their debug info is collected on their strands
+        auto pendingConnections = m_connectionManager.getPendingConnections();
+        for (auto& connection : m_connectionManager.getConnections()) {
+            bool pending = pendingConnections.contains(connection);
+            std::shared_ptr<Session> session;
+            if (!pending) {
+                auto it = m_sessions.find(connection->getMinerId());
+                if (it != m_sessions.end()) {
+                    session = it->second;
+                }
+            }
+            asio::post(connection->getStrand(), [collector, connection = connection->shared_from_this(), session,
+                                                 pending] {
+                json connectionInfo = connection->getDebugInfo();
+                json sessionInfo;
+                if (session && session->isConnected()) {
+                    sessionInfo = session->getDebugInfo();
+                }
+                std::lock_guard lock(collector->mutex);
+                auto& info = collector->info;
+                if (pending) {
+                    info["connections"]["pending_connections"].push_back(std::move(connectionInfo));
+                    return;
+                }
+                std::string minerId = connection->getMinerId().toString();
+                info["connections"]["connections"].emplace(minerId, std::move(connectionInfo));
+                if (!sessionInfo.is_null()) {
+                    info["sessions"].emplace(minerId, std::move(sessionInfo));
+                }
+            });
+        }
     });
 }
 
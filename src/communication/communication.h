@@ -5,6 +5,7 @@
 #include "communication_options.h"
 #include "connection/connection.h"
 #include "connection_manager.h"
+#include "context_pool.h"
 #include "packets/packet.h"
 #include "session.h"
 
@@ -12,7 +13,8 @@ namespace logpass {
 
 class Communication;
 
-// all protected functions are called on communication thread
+// connections and sessions are working on strands of context pool, other protected functions are called on
+// communication thread, connection manager and sessions map are guarded by m_connectionsMutex
 class Communication : public EventLoopThread {
 protected:
     friend class SharedThread<Communication>;
@@ -37,6 +39,8 @@ protected:
     virtual void check();
     void checkConnections();
     bool onConnection(Connection_ptr connection);
+    // accepts connections from simulated network instead of acceptor
+    void listenOnSimulatedNetwork(const ConnectionCallbacks& callbacks);
     Connection_ptr connect(const MinerId& minerId, const Endpoint& endpoint);
 
     virtual void onConnectionEnd(Connection* connection);
@@ -44,6 +48,11 @@ protected:
     virtual bool onConnectionReady(Connection* connection);
     virtual bool onConnectionPacket(Connection* connection, const Packet_ptr& packet);
 
+    // executes task on strand of session connection if session is still connected, m_connectionsMutex must be locked
+    void postToSession(const MinerId& minerId, const std::shared_ptr<Session>& session,
+                       std::function<void(Session&)>&& task);
+    void onSessionException(Connection* connection, const SessionException& exception);
+
     void onBlocks(const std::vector<Block_cptr>& blocks, bool didChangeBranch);
     void onNewTransactions(const std::vector<Transaction_cptr>& transactions);
 
@@ -59,6 +68,7 @@ protected:
         return m_database.get();
     }
 
+    // m_connectionsMutex must be locked
     const ConnectionManager& getConnectionManager() const
     {
         return m_connectionManager;
@@ -72,13 +82,17 @@ protected:
     mutable Logger m_logger;
 
     asio::steady_timer m_timer;
+    ContextPool m_contextPool;
 
+    mutable std::recursive_mutex m_connectionsMutex;
     ConnectionManager m_connectionManager;
     std::unique_ptr<EventsListener> m_eventsListener;
     std::shared_ptr<Certificate> m_certificate;
     std::shared_ptr<Acceptor> m_acceptor;
 
     std::map<MinerId, std::shared_ptr<Session>> m_sessions;
+    const std::shared_ptr<TransactionRequests> m_transactionRequests = std::make_shared<TransactionRequests>();
+    const std::shared_ptr<BlockDownloader> m_blockDownloader = std::make_shared<BlockDownloader>();
 
     Hash m_firstBlocksHash;
     BlockHeader_cptr m_lastBlockHeader;
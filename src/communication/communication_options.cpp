@@ -13,7 +13,8 @@ po::options_description CommunicationOptions::getOptionsDescription()
     options.add_options()
         ("host", po::value<std::string>()->default_value("0.0.0.0"), "host of blockchain communication service")
         ("port", po::value<uint16_t>()->default_value(8150), "port of blockchain communication service (0=disabled)")
-        ("trusted-nodes-file", po::value<std::string>()->default_value(""), "path to json file with trusted nodes");
+        ("trusted-nodes-file", po::value<std::string>()->default_value(""), "path to json file with trusted nodes")
+        ("communication-threads", po::value<size_t>()->default_value(4), "number of threads handling connections");
 
     return options;
 }
@@ -23,6 +24,10 @@ CommunicationOptions CommunicationOptions::loadOptions(po::variables_map& vm, Fi
     CommunicationOptions options;
     options.host = vm["host"].as<std::string>();
     options.port = vm["port"].as<uint16_t>();
+    options.threads = vm["communication-threads"].as<size_t>();
+    if (options.threads == 0) {
+        THROW_EXCEPTION(po::error("Invalid number of communication threads (0)"));
+    }
 
     std::string trustedNodesFile = vm["trusted-nodes-file"].as<std::string>();
     if (!trustedNodesFile.empty()) {
@@ -4,10 +4,16 @@
 
 namespace logpass {
 
+class SimulatedNetwork;
+
 struct CommunicationOptions {
     std::string host = "127.0.0.1";
     uint16_t port = 9000;
     std::map<MinerId, Endpoint> trustedNodes;
+    // number of threads handling connections
+    size_t threads = 4;
+    // if set, connections use in-process simulated network instead of tcp, used by tests and benchmarks
+    std::shared_ptr<SimulatedNetwork> simulatedNetwork;
 
     static program_options::options_description getOptionsDescription();
 
@@ -28,6 +28,7 @@ public:
     void checkConnections()
     {
         post([&] {
+            std::lock_guard lock(m_connectionsMutex);
             m_connectionManager.clearBlockedMinerIds();
             Communication::checkConnections();
         }, true);
@@ -36,6 +37,7 @@ public:
     void clearBlockMinerIds()
     {
         post([&] {
+            std::lock_guard lock(m_connectionsMutex);
             m_connectionManager.clearBlockedMinerIds();
         }, true);
     }
@@ -45,6 +47,7 @@ public:
         ASSERT(!m_promise);
         m_promise = std::make_shared<std::promise<Connection_ptr>>();
         asio::post(m_context, [this, miner] {
+            std::lock_guard lock(m_connectionsMutex);
             m_connection = Communication::connect(miner->id, miner->settings.endpoint);
         });
         auto f = m_promise->get_future();
@@ -65,9 +68,12 @@ public:
 
     void onConnectionEnd(Connection* connection) override
     {
-        if (connection == m_connection.get() && m_promise) {
-            m_promise->set_value(nullptr);
-            m_connection = nullptr;
+        {
+            std::lock_guard lock(m_connectionsMutex);
+            if (connection == m_connection.get() && m_promise) {
+                m_promise->set_value(nullptr);
+                m_connection = nullptr;
+            }
         }
         Communication::onConnectionEnd(connection);
     }
@@ -81,6 +87,7 @@ public:
     {
         if (!Communication::onConnectionReady(connection))
             return false;
+        std::lock_guard lock(m_connectionsMutex);
         if (connection == m_connection.get() && m_promise) {
             m_promise->set_value(m_connection);
             m_connection = nullptr;
@@ -90,7 +97,10 @@ public:
 
     bool onConnectionPacket(Connection* connection, const Packet_ptr& packet) override
     {
-        m_lastPacket = packet;
+        {
+            std::lock_guard lock(m_connectionsMutex);
+            m_lastPacket = packet;
+        }
         return Communication::onConnectionPacket(connection, packet);
     }
 
@@ -98,6 +108,7 @@ public:
     {
         std::promise<Connection*> promise;
         post([&] {
+            std::lock_guard lock(m_connectionsMutex);
             promise.set_value(m_connectionManager.getConnection(minerId));
         });
         return promise.get_future().get();
@@ -107,6 +118,7 @@ public:
     {
         std::promise<std::shared_ptr<Session>> promise;
         post([&] {
+            std::lock_guard lock(m_connectionsMutex);
             auto it = m_sessions.find(minerId);
             if (it == m_sessions.end()) {
                 promise.set_value(nullptr);
@@ -121,6 +133,7 @@ public:
     {
         std::promise<size_t> promise;
         post([&] {
+            std::lock_guard lock(m_connectionsMutex);
             promise.set_value(m_connectionManager.getConnections().size());
         });
         return promise.get_future().get();
@@ -130,6 +143,7 @@ public:
     {
         std::promise<size_t> promise;
         post([&] {
+            std::lock_guard lock(m_connectionsMutex);
             promise.set_value(m_connectionManager.getActiveConnections().size());
         });
         return promise.get_future().get();
@@ -138,6 +152,7 @@ public:
     void closeAllConnections()
     {
         post([&] {
+            std::lock_guard lock(m_connectionsMutex);
             for (auto& connection : m_connectionManager.getConnections()) {
                 connection->close("requested by test");
             }
@@ -156,6 +171,7 @@ public:
 
     Packet_ptr getLastPacket()
     {
+        std::lock_guard lock(m_connectionsMutex);
         return m_lastPacket;
     }
 
@@ -0,0 +1,128 @@
+#include "pch.h"
+
+#include "buffer_pool.h"
+
+namespace logpass {
+
+BufferPool::Buffer::Buffer(BufferPool* pool, std::unique_ptr<uint8_t[]>&& data, size_t size) :
+    m_pool(pool), m_data(std::move(data)), m_size(size)
+{}
+
+BufferPool::Buffer::Buffer(Buffer&& buffer) noexcept :
+    m_pool(buffer.m_pool), m_data(std::move(buffer.m_data)), m_size(buffer.m_size)
+{
+    buffer.m_size = 0;
+}
+
+BufferPool::Buffer& BufferPool::Buffer::operator=(Buffer&& buffer) noexcept
+{
+    if (this != &buffer) {
+        release();
+        m_pool = buffer.m_pool;
+        m_data = std::move(buffer.m_data);
+        m_size = buffer.m_size;
+        buffer.m_size = 0;
+    }
+    return *this;
+}
+
+BufferPool::Buffer::~Buffer()
+{
+    release();
+}
+
+void BufferPool::Buffer::release()
+{
+    if (m_data) {
+        m_pool->release(std::move(m_data), m_size);
+    }
+    m_size = 0;
+}
+
+BufferPool::BufferPool(size_t maxSize)
+{
+    for (size_t size = MIN_CLASS_SIZE; ; size *= 2) {
+        m_classSizes.push_back(size);
+        if (size >= maxSize) {
+            break;
+        }
+    }
+    m_freeBuffers.resize(m_classSizes.size());
+}
+
+BufferPool& BufferPool::global()
+{
+    static BufferPool pool(kNetworkMaxPacketSize);
+    return pool;
+}
+
+BufferPool::Buffer BufferPool::get(size_t size)
+{
+    size_t sizeClass = getSizeClass(size);
+    std::unique_lock lock(m_mutex);
+    if (sizeClass == m_classSizes.size()) {
+        // too big for any class, it won't be kept after release
+        m_allocations += 1;
+        m_borrowedBuffers += 1;
+        m_borrowedBytes += size;
+        lock.unlock();
+        return Buffer(this, std::unique_ptr<uint8_t[]>(new uint8_t[size]), size);
+    }
+
+    size = m_classSizes[sizeClass];
+    m_borrowedBuffers += 1;
+    m_borrowedBytes += size;
+    auto& freeBuffers = m_freeBuffers[sizeClass];
+    if (!freeBuffers.empty()) {
+        auto data = std::move(freeBuffers.back());
+        freeBuffers.pop_back();
+        m_freeBytes -= size;
+        m_reuses += 1;
+        return Buffer(this, std::move(data), size);
+    }
+    m_allocations += 1;
+    lock.unlock();
+    return Buffer(this, std::unique_ptr<uint8_t[]>(new uint8_t[size]), size);
+}
+
+void BufferPool::release(std::unique_ptr<uint8_t[]>&& data, size_t size)
+{
+    std::lock_guard lock(m_mutex);
+    m_borrowedBuffers -= 1;
+    m_borrowedBytes -= size;
+    size_t sizeClass = getSizeClass(size);
+    if (sizeClass == m_classSizes.size() || m_classSizes[sizeClass] != size) {
+        return;
+    }
+    auto& freeBuffers = m_freeBuffers[sizeClass];
+    if (freeBuffers.size() >= MAX_FREE_BUFFERS) {
+        return;
+    }
+    freeBuffers.push_back(std::move(data));
+    m_freeBytes += size;
+}
+
+size_t BufferPool::getSizeClass(size_t size) const
+{
+    auto it = std::lower_bound(m_classSizes.begin(), m_classSizes.end(), size);
+    return it - m_classSizes.begin();
+}
+
+json BufferPool::getDebugInfo() const
+{
+    std::lock_guard lock(m_mutex);
+    json freeBuffers = json::object();
+    for (size_t i = 0; i < m_classSizes.size(); ++i) {
+        freeBuffers.emplace(std::to_string(m_classSizes[i]), m_freeBuffers[i].size());
+    }
+    return {
+        {"borrowed_buffers", m_borrowedBuffers},
+        {"borrowed_bytes", m_borrowedBytes},
+        {"free_bytes", m_freeBytes},
+        {"free_buffers", freeBuffers},
+        {"allocations", m_allocations},
+        {"reuses", m_reuses}
+    };
+}
+
+}
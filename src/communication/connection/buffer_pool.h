@@ -0,0 +1,74 @@
+#pragma once
+
+namespace logpass {
+
+// thread-safe pool of buffers for frames which don't fit into read buffer of connection,
+// buffers are grouped into size classes (powers of 2), buffer can be reused by any frame of the same class
+class BufferPool {
+public:
+    // size of the smallest class
+    static constexpr size_t MIN_CLASS_SIZE = 64 * 1024;
+    // max number of free buffers kept in every class
+    static constexpr size_t MAX_FREE_BUFFERS = 4;
+
+    // buffer borrowed from pool, it's returned to pool when destroyed
+    class Buffer {
+    public:
+        Buffer() = default;
+        Buffer(Buffer&& buffer) noexcept;
+        Buffer& operator=(Buffer&& buffer) noexcept;
+        ~Buffer();
+
+        uint8_t* data() const
+        {
+            return m_data.get();
+        }
+
+        // capacity of buffer, may be bigger than requested size
+        size_t size() const
+        {
+            return m_size;
+        }
+
+        explicit operator bool() const
+        {
+            return m_data != nullptr;
+        }
+
+    private:
+        friend class BufferPool;
+        Buffer(BufferPool* pool, std::unique_ptr<uint8_t[]>&& data, size_t size);
+        void release();
+
+        BufferPool* m_pool = nullptr;
+        std::unique_ptr<uint8_t[]> m_data;
+        size_t m_size = 0;
+    };
+
+    BufferPool(size_t maxSize);
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+
+    // pool used by all connections
+    static BufferPool& global();
+
+    // returns buffer with at least given size, content of buffer is not initialized
+    Buffer get(size_t size);
+
+    json getDebugInfo() const;
+
+private:
+    void release(std::unique_ptr<uint8_t[]>&& data, size_t size);
+    size_t getSizeClass(size_t size) const;
+
+    std::vector<size_t> m_classSizes;
+    std::vector<std::vector<std::unique_ptr<uint8_t[]>>> m_freeBuffers;
+    size_t m_borrowedBuffers = 0;
+    size_t m_borrowedBytes = 0;
+    size_t m_freeBytes = 0;
+    size_t m_allocations = 0;
+    size_t m_reuses = 0;
+    mutable std::mutex m_mutex;
+};
+
+}
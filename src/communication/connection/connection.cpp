@@ -6,8 +6,9 @@ namespace logpass {
 
 Connection::Connection(asio::io_context& context, const MinerId& localMinerId, const MinerId& remoteMinerId,
                        const ConnectionCallbacks& callbacks) :
-    m_context(context), m_localMinerId(localMinerId), m_remoteMinerId(remoteMinerId), m_callbacks(callbacks),
-    m_outgoing(remoteMinerId.isValid()), m_readTimer(context), m_writeTimer(context), m_keepAliveTimer(context),
+    m_context(context), m_strand(asio::make_strand(context)), m_localMinerId(localMinerId),
+    m_remoteMinerId(remoteMinerId), m_callbacks(callbacks), m_outgoing(remoteMinerId.isValid()),
+    m_readTimer(m_strand), m_writeTimer(m_strand), m_keepAliveTimer(m_strand),
     m_lastKeepAlive(chrono::steady_clock::now()), m_startTime(chrono::steady_clock::now())
 {
     m_logger.add_attribute("Class", boost::log::attributes::constant<std::string>("Connection"));
@@ -20,12 +21,20 @@ Connection::~Connection()
 
 void Connection::close(std::string_view reason)
 {
+    if (!m_strand.running_in_this_thread()) {
+        asio::post(m_strand, [this, self = shared_from_this(), reason = std::string(reason)]() {
+            close(reason);
+        });
+        return;
+    }
+
     if (m_closed) {
         return;
     }
 
     LOG_CLASS(debug) << "close, reason: " << reason;
 
+    shutdown();
     m_closed = true;
 
     boost::system::error_code ec;
@@ -37,7 +46,7 @@ void Connection::close(std::string_view reason)
         return; // connect didn't start, don't call onEnd
     }
 
-    asio::post(m_context, [this, self = shared_from_this()]() {
+    asio::post(m_strand, [this, self = shared_from_this()]() {
         if (m_callbacks.onEnd) {
             m_callbacks.onEnd(this);
         }
@@ -100,15 +109,108 @@ void Connection::onConnectionReady()
     }
 }
 
-void Connection::onRead(const Serializer_ptr& msg)
+void Connection::read()
+{
+    if (m_closed) {
+        return;
+    }
+
+    if (m_largeFrame) {
+        return readSome(asio::buffer(m_largeFrame.data() + m_largeFrameReceived,
+                                     m_largeFrameSize - m_largeFrameReceived));
+    }
+
+    if (m_readBuffer.empty()) {
+        m_readBuffer.resize(READ_BUFFER_SIZE);
+    }
+    if (m_readBegin != 0) {
+        // moves incomplete frame to the beginning of buffer
+        std::memmove(m_readBuffer.data(), m_readBuffer.data() + m_readBegin, m_readEnd - m_readBegin);
+        m_readEnd -= m_readBegin;
+        m_readBegin = 0;
+    }
+    readSome(asio::buffer(m_readBuffer.data() + m_readEnd, m_readBuffer.size() - m_readEnd));
+}
+
+void Connection::onReadSome(const boost::system::error_code& ec, size_t size)
+{
+    if (m_closed) {
+        return;
+    }
+    if (ec) {
+        return close("read error");
+    }
+
+    // statistics
+    m_reads += 1;
+
+    bool receivedFrame = false;
+    if (m_largeFrame) {
+        m_largeFrameReceived += size;
+        if (m_largeFrameReceived < m_largeFrameSize) {
+            return read();
+        }
+        // buffer is returned to pool after parsing
+        BufferPool::Buffer frame = std::move(m_largeFrame);
+        Serializer msg((const char*)frame.data(), m_largeFrameSize, nullptr);
+        onRead(msg);
+        receivedFrame = true;
+    } else {
+        m_readEnd += size;
+    }
+
+    while (!m_closed && m_readEnd - m_readBegin >= sizeof(uint32_t)) {
+        uint32_t frameSize;
+        memcpy(&frameSize, m_readBuffer.data() + m_readBegin, sizeof(uint32_t));
+        if (frameSize > getMaxPacketSize()) {
+            return close("too big packet size");
+        }
+
+        size_t available = m_readEnd - m_readBegin - sizeof(uint32_t);
+        if (frameSize > available) {
+            if (sizeof(uint32_t) + frameSize > m_readBuffer.size()) {
+                // frame doesn't fit into read buffer, rest of it is received into buffer from pool
+                m_largeFrame = BufferPool::global().get(frameSize);
+                m_largeFrameSize = frameSize;
+                m_largeFrameReceived = available;
+                memcpy(m_largeFrame.data(), m_readBuffer.data() + m_readBegin + sizeof(uint32_t), available);
+                m_readBegin = m_readEnd = 0;
+                m_largeFrames += 1;
+            }
+            break;
+        }
+
+        // packet is parsed directly from read buffer, without copying it
+        Serializer msg((const char*)m_readBuffer.data() + m_readBegin + sizeof(uint32_t), frameSize, nullptr);
+        m_readBegin += sizeof(uint32_t) + frameSize;
+        onRead(msg);
+        receivedFrame = true;
+    }
+
+    if (m_closed) {
+        return;
+    }
+
+    if (m_readBegin == m_readEnd) {
+        m_readBegin = m_readEnd = 0;
+    }
+
+    if (receivedFrame) {
+        m_readTimer.expires_after(chrono::milliseconds(getTimeout()));
+        m_readTimer.async_wait(std::bind(&Connection::onTimeout, shared_from_this(), std::placeholders::_1));
+    }
+    read();
+}
+
+void Connection::onRead(Serializer& msg)
 {
-    ASSERT(msg->reader());
+    ASSERT(msg.reader());
     if (m_closed) {
         return;
     }
 
     // statistics
-    m_bytesRecived += msg->size();
+    m_bytesRecived += msg.size();
 
     // close connection if it waits too long for reply packet
     if (!m_waitingPackets.empty() && chrono::steady_clock::now() >
@@ -116,56 +218,45 @@ void Connection::onRead(const Serializer_ptr& msg)
         return close("waited too long for response packet");
     }
 
-    if (msg->size() == 0) {
+    if (msg.size() == 0) {
         if (m_phase == Phase::WORKING) {
-            onKeepAlivePacket();
-            m_readTimer.expires_after(chrono::milliseconds(getTimeout()));
-            m_readTimer.async_wait(std::bind(&Connection::onTimeout, shared_from_this(), std::placeholders::_1));
-            return read();
+            return onKeepAlivePacket();
         }
         return close("invalid header size (0)");
     }
 
-    if (msg->size() > getMaxPacketSize()) {
-        return close("invalid header size ("s + std::to_string(msg->size()) + ")");
+    if (msg.size() > getMaxPacketSize()) {
+        return close("invalid header size ("s + std::to_string(msg.size()) + ")");
     }
 
     processRawPacket(msg);
-
-    if (m_closed) {
-        return;
-    }
-
-    m_readTimer.expires_after(chrono::milliseconds(getTimeout()));
-    m_readTimer.async_wait(std::bind(&Connection::onTimeout, shared_from_this(), std::placeholders::_1));
-    read();
 }
 
-void Connection::processRawPacket(const Serializer_ptr& msg)
+void Connection::processRawPacket(Serializer& msg)
 {
     try {
         if (m_phase == Phase::WAITING_FOR_FIRST_PACKET) {
             onFirstPacket(msg);
         } else {
-            uint32_t packetId = msg->get<uint32_t>();
+            uint32_t packetId = msg.get<uint32_t>();
             if (packetId != m_expectedPacketId) {
                 return close("invalid packetId");
             }
             m_expectedPacketId += 1;
-            if (msg->peek<uint8_t>() != 0x00) {
-                auto packet = Packet::load(*msg, packetId);
+            if (msg.peek<uint8_t>() != 0x00) {
+                auto packet = Packet::load(msg, packetId);
                 LOG_CLASS(trace) << "received packet (" << (uint16_t)packet->getType() << "), id: " << packet->getId();
                 onPacket(packet);
             } else {
                 // it's a reply for some previous packet
-                msg->get<uint8_t>(); // skip 1 byte
-                uint32_t replyForPacketId = msg->get<uint32_t>();
+                msg.get<uint8_t>(); // skip 1 byte
+                uint32_t replyForPacketId = msg.get<uint32_t>();
                 auto it = m_waitingPackets.find(replyForPacketId);
                 if (it == m_waitingPackets.end())
                     return close("invalid response packet id");
                 Packet_ptr packet = it->second.first;
                 m_waitingPackets.erase(it);
-                packet->serializeResponse(*msg);
+                packet->serializeResponse(msg);
                 LOG_CLASS(trace) << "received reply packet (" << (uint16_t)packet->getType() << "), id: " <<
                     replyForPacketId;
                 onPacket(packet);
@@ -192,8 +283,9 @@ void Connection::send(const Packet_ptr& packet)
         return;
     }
 
+    // packet id is added when message is written, because messages with higher priority can be written earlier
+    QueuedMessage message{ .withPacketId = true };
     auto s = std::make_shared<Serializer>();
-    s->serialize(m_packetId);
     if (packet->hasResponse()) {
         ASSERT(packet->requiresResponse());
         ASSERT(packet->getId() > 0);
@@ -204,50 +296,148 @@ void Connection::send(const Packet_ptr& packet)
         ASSERT(packet->getId() == 0);
         packet->serializeRequest(*s);
         if (packet->requiresResponse()) {
-            if (m_waitingPackets.size() >= 64) { // limits waiting packets size to 64
+            if (m_waitingPackets.size() + m_queuedRequests >= 64) { // limits waiting packets size to 64
                 return close("too many waiting packets");
             }
-            m_waitingPackets.emplace(m_packetId, std::make_pair(packet, chrono::steady_clock::now()));
+            message.request = packet;
         }
     }
+    message.message = s;
 
-    m_packetId += 1;
+    // only gossip which doesn't expect response can be dropped
+    auto priority = packet->getPriority();
+    bool droppable = priority == PacketPriority::TRANSACTIONS && !packet->requiresResponse();
     LOG_CLASS(trace) << "sending packet (" << (uint16_t)packet->getType() << "), id: " << packet->getId();
-    send(s);
+    send(std::move(message), priority, droppable);
 }
 
-void Connection::send(const Serializer_cptr& msg)
+void Connection::send(QueuedMessage&& message, PacketPriority priority, bool droppable)
 {
-    ASSERT(msg->writer());
-    ASSERT(msg->size() <= getMaxPacketSize());
+    ASSERT(message.message->writer());
+    ASSERT(message.message->size() + (message.withPacketId ? sizeof(uint32_t) : 0) <= getMaxPacketSize());
 
     if (m_closed) {
         return;
     }
 
-    if (msg->reader()) {
+    auto& queue = m_sendQueues[(size_t)priority];
+    size_t size = message.message->pos();
+    if (!queue.messages.empty() && queue.size + size > SEND_QUEUE_LIMITS[(size_t)priority]) {
+        if (droppable) {
+            queue.droppedMessages += 1;
+            return;
+        }
+        if (priority != PacketPriority::TRANSACTIONS) {
+            return close("send queue is full");
+        }
+    }
+    if (m_sendQueuesSize + size > MAX_SEND_QUEUES_SIZE) {
+        return close("send queues are full");
+    }
+
+    if (message.request) {
+        m_queuedRequests += 1;
+    }
+    message.time = chrono::steady_clock::now();
+    queue.size += size;
+    m_sendQueuesSize += size;
+    queue.messages.push_back(std::move(message));
+
+    if (!m_writing) {
+        // flush later, to write all messages sent by current handler at once
+        m_writing = true;
+        asio::post(m_strand, std::bind(&Connection::flush, shared_from_this()));
+    }
+}
+
+void Connection::flush()
+{
+    ASSERT(m_writing && m_writingMessages.empty());
+    if (m_closed) {
         return;
     }
 
-    if (m_sendQueue.empty()) {
-        m_sendQueue.push(msg);
+    // messages are taken in order of priorities, higher priority queue must be empty before lower one is used
+    auto now = chrono::steady_clock::now();
+    size_t writeSize = 0;
+    for (auto& queue : m_sendQueues) {
+        while (!queue.messages.empty()) {
+            auto& message = queue.messages.front();
+            size_t size = message.message->pos();
+            if (!m_writingMessages.empty() && writeSize + size > MAX_WRITE_SIZE) {
+                break;
+            }
+            writeSize += size;
+            queue.size -= size;
+            m_sendQueuesSize -= size;
+            queue.sentMessages += 1;
+            queue.waitTime += now - message.time;
+            m_writingMessages.push_back(std::move(message));
+            queue.messages.pop_front();
+        }
+        if (!queue.messages.empty()) {
+            break;
+        }
+    }
+
+    // small messages are copied with their headers into coalescing buffer, which is reserved upfront, so it's
+    // never reallocated, other messages are written directly from their serializers
+    const size_t coalescingLimit = getCoalescingLimit();
+    size_t coalescedSize = 0;
+    m_writeHeaders.resize(m_writingMessages.size());
+    for (size_t i = 0; i < m_writingMessages.size(); ++i) {
+        auto& message = m_writingMessages[i];
+        uint32_t size = (uint32_t)message.message->pos();
+        size_t headerSize = sizeof(uint32_t);
+        if (message.withPacketId) {
+            if (message.request) {
+                m_queuedRequests -= 1;
+                m_waitingPackets.emplace(m_packetId, std::make_pair(message.request, now));
+            }
+            m_writeHeaders[i] = { size + (uint32_t)sizeof(uint32_t), m_packetId++ };
+            headerSize += sizeof(uint32_t);
+        } else {
+            m_writeHeaders[i] = { size, 0 };
+        }
+        if (size <= coalescingLimit) {
+            coalescedSize += headerSize + size;
+        }
     }
 
-    if (m_sendQueue.front() != msg) {
-        if (m_sendQueue.size() >= 64) { // limits send buffer size to 64 messages
-            return close("too many waiting packets");
+    m_coalescingBuffer.resize(coalescedSize);
+    m_writeBuffers.clear();
+
+    uint8_t* coalesced = m_coalescingBuffer.data();
+    uint8_t* coalescedBegin = coalesced;
+    for (size_t i = 0; i < m_writingMessages.size(); ++i) {
+        auto& message = m_writingMessages[i];
+        uint32_t size = (uint32_t)message.message->pos();
+        size_t headerSize = message.withPacketId ? 2 * sizeof(uint32_t) : sizeof(uint32_t);
+        m_bytesSent += headerSize + size - sizeof(uint32_t);
+        if (size <= coalescingLimit) {
+            memcpy(coalesced, m_writeHeaders[i].data(), headerSize);
+            memcpy(coalesced + headerSize, message.message->buffer(), size);
+            coalesced += headerSize + size;
+            continue;
         }
-        m_sendQueue.push(msg);
-        return;
+        if (coalesced != coalescedBegin) {
+            m_writeBuffers.emplace_back(coalescedBegin, coalesced - coalescedBegin);
+            coalescedBegin = coalesced;
+        }
+        m_writeBuffers.emplace_back(m_writeHeaders[i].data(), headerSize);
+        m_writeBuffers.emplace_back(message.message->buffer(), size);
+    }
+    if (coalesced != coalescedBegin) {
+        m_writeBuffers.emplace_back(coalescedBegin, coalesced - coalescedBegin);
     }
 
     // statistics
-    m_bytesSent += msg->size();
+    m_writes += 1;
 
     m_writeTimer.expires_after(chrono::milliseconds(getTimeout()));
     m_writeTimer.async_wait(std::bind(&Connection::onTimeout, shared_from_this(), std::placeholders::_1));
 
-    write(msg);
+    write(m_writeBuffers);
 }
 
 void Connection::onWrite()
@@ -256,13 +446,14 @@ void Connection::onWrite()
         return;
     }
 
-    m_sendQueue.pop();
-    if (m_sendQueue.empty()) {
+    m_writingMessages.clear();
+    if (std::all_of(m_sendQueues.begin(), m_sendQueues.end(), [](auto& queue) { return queue.messages.empty(); })) {
+        m_writing = false;
         m_writeTimer.cancel();
         return;
     }
 
-    send(m_sendQueue.front());
+    flush();
 }
 
 void Connection::keepAlive(const boost::system::error_code& ec)
@@ -278,7 +469,7 @@ void Connection::keepAlive(const boost::system::error_code& ec)
     m_keepAliveTimer.expires_after(chrono::milliseconds(getTimeout() / 2));
     m_keepAliveTimer.async_wait(std::bind(&Connection::keepAlive, shared_from_this(), std::placeholders::_1));
 
-    send(std::make_shared<Serializer>());
+    send(QueuedMessage{ .message = std::make_shared<Serializer>() }, PacketPriority::CONSENSUS, false);
 }
 
 void Connection::sendFirstPacket()
@@ -288,19 +479,19 @@ void Connection::sendFirstPacket()
     (*s)(kNetworkProtocolVersion);
     (*s)(m_localMinerId);
     (*s)(m_remoteMinerId);
-    send(s);
+    send(QueuedMessage{ .message = s }, PacketPriority::CONSENSUS, false);
 }
 
-void Connection::onFirstPacket(const Serializer_ptr& s)
+void Connection::onFirstPacket(Serializer& s)
 {
-    uint8_t protocolVersion = s->get<uint8_t>();
+    uint8_t protocolVersion = s.get<uint8_t>();
     if (protocolVersion != kNetworkProtocolVersion) {
         return close("invalid protocol version");
     }
     MinerId localMinerId, remoteMinerId;
-    (*s)(remoteMinerId);
-    (*s)(localMinerId);
-    if (!s->eof()) {
+    s(remoteMinerId);
+    s(localMinerId);
+    if (!s.eof()) {
         return close("invalid first packet data");
     }
 
@@ -354,15 +545,36 @@ void Connection::onPacket(const Packet_ptr& packet)
 json Connection::getDebugInfo() const
 {
     auto now = chrono::steady_clock::now();
+    json sendQueues = json::array();
+    for (auto& queue : m_sendQueues) {
+        auto waitTime = queue.messages.empty() ? chrono::steady_clock::duration::zero() :
+            now - queue.messages.front().time;
+        auto averageWaitTime = queue.sentMessages == 0 ? chrono::steady_clock::duration::zero() :
+            queue.waitTime / queue.sentMessages;
+        sendQueues.push_back({
+            {"messages", queue.messages.size()},
+            {"size", queue.size},
+            {"sent_messages", queue.sentMessages},
+            {"dropped_messages", queue.droppedMessages},
+            {"wait_time", chrono::duration_cast<chrono::microseconds>(waitTime).count()},
+            {"average_wait_time", chrono::duration_cast<chrono::microseconds>(averageWaitTime).count()}
+        });
+    }
     return {
         {"miner_id", m_remoteMinerId},
         {"outgoing", m_outgoing},
-        {"validated", m_validated},
+        {"validated", m_validated.load()},
         {"packet_id", m_packetId},
         {"expected_packet_id", m_expectedPacketId},
         {"bytes_sent", m_bytesSent},
         {"bytes_recived", m_bytesRecived},
-        {"sent_queue_size", m_sendQueue.size()},
+        {"send_queues", sendQueues},
+        {"send_queues_size", m_sendQueuesSize},
+        {"writes", m_writes},
+        {"reads", m_reads},
+        {"large_frames", m_largeFrames},
+        {"read_buffer_size", m_readBuffer.size()},
+        {"buffer_pool", BufferPool::global().getDebugInfo()},
         {"waiting_packets_size", m_waitingPackets.size()},
         {"last_keep_alive", chrono::duration_cast<chrono::seconds>(now - m_lastKeepAlive).count()},
         {"duration", chrono::duration_cast<chrono::seconds>(now - m_startTime).count()}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "buffer_pool.h"
 #include "connection_callbacks.h"
 #include <communication/packets/packet.h>
 
@@ -10,7 +11,7 @@ class Connection;
 using Connection_ptr = std::shared_ptr<Connection>;
 using Connection_wptr = std::weak_ptr<Connection>;
 
-// not thread-safe
+// all functions except close and getters must be called on connection strand
 class Connection : public std::enable_shared_from_this<Connection> {
 public:
     enum class Phase : uint8_t {
@@ -30,8 +31,8 @@ public:
     virtual void start() = 0;
     // starts outgoing connection
     virtual void start(const Endpoint& endpoint) = 0;
-    // closes connection
-    virtual void close(std::string_view reason = "");
+    // closes connection, can be called from any thread
+    void close(std::string_view reason = "");
     // sends packet
     void send(const Packet_ptr& packet);
 
@@ -48,6 +49,12 @@ public:
         return kNetworkConnectionTimeout * 1000;
     }
 
+    // messages not bigger than this limit are copied into single buffer before being written
+    virtual size_t getCoalescingLimit() const
+    {
+        return 0;
+    }
+
     chrono::steady_clock::time_point getLastKeepAliveTimePoint() const
     {
         return m_lastKeepAlive;
@@ -78,32 +85,83 @@ public:
         return m_remoteMinerId;
     }
 
+    // returns strand on which all connection handlers are executed
+    const asio::strand<asio::io_context::executor_type>& getStrand() const
+    {
+        return m_strand;
+    }
+
+    // must be called on connection strand
     json getDebugInfo() const;
 
 protected:
-    virtual void read() = 0;
-    virtual void write(const Serializer_cptr& msg) = 0;
+    // size of reusable read buffer, bigger frames are received into buffers from BufferPool
+    static constexpr size_t READ_BUFFER_SIZE = 64 * 1024;
+    // byte limits of send queues of packet priorities, when queue is full transactions gossip is dropped,
+    // other transactions packets are deferred and for other priorities connection is closed
+    static constexpr std::array<size_t, 3> SEND_QUEUE_LIMITS = {
+        2 * kNetworkMaxPacketSize, 8 * kNetworkMaxPacketSize, kNetworkMaxPacketSize
+    };
+    // above this size of all send queues connection is closed, because peer doesn't receive data fast enough
+    static constexpr size_t MAX_SEND_QUEUES_SIZE = 16 * kNetworkMaxPacketSize;
+    // size of messages taken by single write, so new high priority messages don't wait for many other ones
+    static constexpr size_t MAX_WRITE_SIZE = 512 * 1024;
+
+    // cancels pending operations of socket, called on connection strand
+    virtual void shutdown() {};
+    // reads some data into buffer, calls onReadSome when it's done
+    virtual void readSome(const asio::mutable_buffer& buffer) = 0;
+    // writes all buffers with single write operation, calls onWrite when it's done
+    virtual void write(const std::vector<asio::const_buffer>& buffers) = 0;
 
     void onConnected();
-    void onRead(const Serializer_ptr& msg);
+    void onReadSome(const boost::system::error_code& ec, size_t size);
     void onWrite();
     void onTimeout(const boost::system::error_code& ec);
 
+    // binds handler to connection strand
+    template<typename Handler>
+    auto bindToStrand(Handler&& handler)
+    {
+        return asio::bind_executor(m_strand, std::forward<Handler>(handler));
+    }
+
 private:
+    // message waiting in send queue, packet id is assigned when message is written
+    struct QueuedMessage {
+        Serializer_cptr message;
+        bool withPacketId = false;
+        // request which waits for response, it's added to waiting packets when it's written
+        Packet_ptr request;
+        chrono::steady_clock::time_point time;
+    };
+
+    struct SendQueue {
+        std::deque<QueuedMessage> messages;
+        size_t size = 0;
+        size_t sentMessages = 0;
+        size_t droppedMessages = 0;
+        chrono::steady_clock::duration waitTime = chrono::steady_clock::duration::zero();
+    };
+
     void onConnectionReady();
 
-    void processRawPacket(const Serializer_ptr& s);
-    void send(const Serializer_cptr& s);
+    void read();
+    void onRead(Serializer& msg);
+    void processRawPacket(Serializer& s);
+    void send(QueuedMessage&& message, PacketPriority priority, bool droppable);
+    void flush();
     void keepAlive(const boost::system::error_code& ec);
 
     void sendFirstPacket();
-    void onFirstPacket(const Serializer_ptr& s);
+    void onFirstPacket(Serializer& s);
 
     void onKeepAlivePacket();
     void onPacket(const Packet_ptr& packet);
 
 protected:
     asio::io_context& m_context;
+    asio::strand<asio::io_context::executor_type> m_strand;
     const ConnectionCallbacks m_callbacks;
 
     asio::steady_timer m_readTimer;
@@ -112,14 +170,29 @@ protected:
 
     mutable Logger m_logger;
 
-    bool m_closed = false;
-    bool m_validated = false;
+    std::atomic<bool> m_closed = false;
+    std::atomic<bool> m_validated = false;
     const bool m_outgoing = false;
-    Phase m_phase = Phase::WAITING_FOR_START;
+    std::atomic<Phase> m_phase = Phase::WAITING_FOR_START;
 
     uint32_t m_packetId = 1, m_expectedPacketId = 1;
-    size_t m_bytesSent = 0, m_bytesRecived = 0;
-    std::queue<Serializer_cptr> m_sendQueue;
+    size_t m_bytesSent = 0, m_bytesRecived = 0, m_writes = 0, m_reads = 0, m_largeFrames = 0;
+    // received data, frames are parsed directly from this buffer
+    std::vector<uint8_t> m_readBuffer;
+    size_t m_readBegin = 0, m_readEnd = 0;
+    // frame which doesn't fit into read buffer
+    BufferPool::Buffer m_largeFrame;
+    size_t m_largeFrameSize = 0, m_largeFrameReceived = 0;
+    // messages waiting for write, one queue per packet priority
+    std::array<SendQueue, 3> m_sendQueues;
+    size_t m_sendQueuesSize = 0;
+    size_t m_queuedRequests = 0;
+    // messages being written, with buffers of current write
+    bool m_writing = false;
+    std::vector<QueuedMessage> m_writingMessages;
+    std::vector<std::array<uint32_t, 2>> m_writeHeaders;
+    std::vector<uint8_t> m_coalescingBuffer;
+    std::vector<asio::const_buffer> m_writeBuffers;
     std::map<uint32_t, std::pair<Packet_ptr, chrono::steady_clock::time_point>> m_waitingPackets;
 
     // packets waiting to be send when connection is ready
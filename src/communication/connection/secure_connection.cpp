@@ -9,7 +9,7 @@ SecureConnection::SecureConnection(asio::io_context& context, asio::ip::tcp::soc
                                    const MinerId& localMinerId, const MinerId& remoteMinerId,
                                    const ConnectionCallbacks& callbacks) :
     Connection(context, localMinerId, remoteMinerId, callbacks), m_certificate(certificate),
-    m_socket(std::move(socket), certificate->getContext()), m_resolver(context)
+    m_socket(std::move(socket), certificate->getContext()), m_resolver(m_strand)
 {}
 
 void SecureConnection::start()
@@ -28,16 +28,34 @@ void SecureConnection::start()
         }
     });
 
+    // resume previous session with known miner to skip certificate exchange
+    if (m_outgoing) {
+        auto session = m_certificate->takeSession(m_remoteMinerId);
+        if (session) {
+            SSL_set_session(m_socket.native_handle(), session.get());
+        }
+    }
+
     LOG_CLASS(trace) << "starting handshake";
-    m_socket.async_handshake(m_outgoing ? boost::asio::ssl::stream_base::client : boost::asio::ssl::stream_base::server,
-                             [this, self = shared_from_this()](const boost::system::error_code& ec) {
+    auto onHandshake = [this, self = shared_from_this()](const boost::system::error_code& ec) {
         if (ec) {
             return close("handshake failed - "s + ec.message());
         }
 
+        if (SSL_session_reused(m_socket.native_handle())) {
+            // certificate is not verified when session is resumed, so miner id is checked here
+            MinerId minerId = Certificate::getMinerId(SSL_SESSION_get0_peer(SSL_get_session(m_socket.native_handle())));
+            if (!verifyMinerId(minerId)) {
+                return close("invalid resumed session");
+            }
+            LOG_CLASS(debug) << "tls session resumed";
+        }
+
         m_readTimer.cancel();
         Connection::onConnected();
-    });
+    };
+    m_socket.async_handshake(m_outgoing ? boost::asio::ssl::stream_base::client : boost::asio::ssl::stream_base::server,
+                             bindToStrand(std::move(onHandshake)));
 }
 
 void SecureConnection::start(const Endpoint& endpoint)
@@ -72,7 +90,7 @@ void SecureConnection::start(const Endpoint& endpoint)
 
         boost::asio::ip::tcp::endpoint endpoint = *results;
         LOG_CLASS(trace) << "async resolve found " << results.size() << " endpoints, connecting to: " << endpoint;
-        m_socket.lowest_layer().async_connect(endpoint, [this, self](auto ec) {
+        m_socket.lowest_layer().async_connect(endpoint, bindToStrand([this, self](auto ec) {
             if (m_closed) {
                 return;
             }
@@ -83,54 +101,33 @@ void SecureConnection::start(const Endpoint& endpoint)
             m_socket.lowest_layer().set_option(boost::asio::ip::tcp::no_delay(true));
             m_readTimer.cancel();
             SecureConnection::start();
-        });
+        }));
     });
 }
 
-void SecureConnection::close(std::string_view reason)
+void SecureConnection::shutdown()
 {
-    if (m_closed) {
-        return;
-    }
-
     m_resolver.cancel();
     boost::system::error_code ec;
     m_socket.lowest_layer().shutdown(asio::ip::tcp::socket::shutdown_both, ec);
-    boost::asio::post(m_context, [this, self = shared_from_this()]() {
+    asio::post(m_strand, [this, self = shared_from_this()]() {
         boost::system::error_code ec;
         m_socket.lowest_layer().cancel(ec);
     });
-
-    Connection::close(reason);
 }
 
 bool SecureConnection::verifyCertificate(bool preverified, boost::asio::ssl::verify_context& ctx)
 {
-    X509* cert = X509_STORE_CTX_get0_cert(ctx.native_handle());
-    if (!cert) {
-        LOG_CLASS(warning) << "missing x509 certificate";
+    MinerId minerId = Certificate::getMinerId(X509_STORE_CTX_get0_cert(ctx.native_handle()));
+    if (!minerId.isValid()) {
+        LOG_CLASS(warning) << "invalid x509 certificate";
         return false;
     }
+    return verifyMinerId(minerId);
+}
 
-    EVP_PKEY* key = X509_get0_pubkey(cert);
-    if (!key) {
-        LOG_CLASS(warning) << "missing x509 public key";
-        return false;
-    }
-
-    if (EVP_PKEY_base_id(key) != EVP_PKEY_ED25519) {
-        LOG_CLASS(warning) << "invalid x509 public key type (" << EVP_PKEY_base_id(key) << ")";
-        return false;
-    }
-
-    if (X509_verify(cert, key) != 1) {
-        return false;
-    }
-
-    MinerId minerId;
-    size_t len = minerId.size();
-    EVP_PKEY_get_raw_public_key(key, minerId.data(), &len);
-
+bool SecureConnection::verifyMinerId(const MinerId& minerId)
+{
     if (m_outgoing) {
         if (minerId != m_remoteMinerId) {
             LOG_CLASS(warning) << "invalid x509 public key (minerId), got " << minerId << ", expected "
@@ -152,71 +149,33 @@ bool SecureConnection::verifyCertificate(bool preverified, boost::asio::ssl::ver
     return true;
 }
 
-void SecureConnection::read()
+void SecureConnection::readSome(const asio::mutable_buffer& buffer)
 {
     if (m_closed) {
         return;
     }
 
-    asio::async_read(m_socket, asio::buffer(&m_readHeader, 4), [this, self = shared_from_this()](auto ec, auto size) {
-        if (m_closed) {
-            return;
-        }
-        if (ec) {
-            return close("size read error");
-        }
-
-        if (m_readHeader > getMaxPacketSize()) {
-            return close("too big packet size");
-        }
-
-        auto msg = std::make_shared<Serializer>(m_readHeader);
-        if (m_readHeader == 0) {
-            msg->switchToReader(m_readHeader);
-            return onRead(msg);
-        }
-
-        asio::async_read(m_socket, asio::buffer(msg->buffer(), m_readHeader), [this, msg, self](auto ec, auto size) {
-            if (m_closed) {
-                return;
-            }
-            if (ec) {
-                return close("packet read error");
-            }
-
-            msg->switchToReader(m_readHeader);
-            return onRead(msg);
-        });
-    });
+    m_socket.async_read_some(buffer, bindToStrand([this, self = shared_from_this()](auto ec, auto size) {
+        onReadSome(ec, size);
+    }));
 }
 
-void SecureConnection::write(const Serializer_cptr& msg)
+void SecureConnection::write(const std::vector<asio::const_buffer>& buffers)
 {
     if (m_closed) {
         return;
     }
 
-    m_writeHeader = (uint32_t)msg->pos();
-    asio::async_write(m_socket, asio::buffer(&m_writeHeader, 4),
-                      [this, msg, self = shared_from_this()](auto ec, auto size) {
+    asio::async_write(m_socket, buffers, bindToStrand([this, self = shared_from_this()](auto ec, auto size) {
         if (m_closed) {
             return;
         }
         if (ec) {
-            return close("write size error");
+            return close("write error");
         }
 
-        asio::async_write(m_socket, asio::buffer(msg->buffer(), msg->pos()), [this, msg, self](auto ec, auto size) {
-            if (m_closed) {
-                return;
-            }
-            if (ec) {
-                return close("write packet error");
-            }
-
-            onWrite();
-        });
-    });
+        onWrite();
+    }));
 }
 
 }
@@ -4,9 +4,12 @@
 
 namespace logpass {
 
-// not thread-safe
+// all handlers are executed on connection strand
 class SecureConnection : public Connection {
 public:
+    // max size of plaintext in single tls record
+    static constexpr size_t TLS_RECORD_SIZE = 16 * 1024;
+
     SecureConnection(asio::io_context& context, asio::ip::tcp::socket&& socket,
                      const std::shared_ptr<Certificate>& certificate,
                      const MinerId& localMinerId, const MinerId& remoteMinerId, const ConnectionCallbacks& callbacks);
@@ -14,19 +17,31 @@ public:
     void start() override;
     // starts working, for outgoing connection, should be called only once
     void start(const Endpoint& endpoint) override;
-    // closes connection
-    void close(std::string_view reason = "") override;
+
+    // returns true if handshake resumed previous tls session instead of verifying certificate
+    bool isSessionResumed()
+    {
+        return SSL_session_reused(m_socket.native_handle()) == 1;
+    }
+
+    // small packets are coalesced into full tls records
+    size_t getCoalescingLimit() const override
+    {
+        return TLS_RECORD_SIZE;
+    }
 
 protected:
+    void shutdown() override;
     bool verifyCertificate(bool preverified, boost::asio::ssl::verify_context& ctx);
-    void read() override;
-    void write(const Serializer_cptr& msg) override;
+    // checks miner id from certificate of peer, also used for resumed sessions which skip certificate verification
+    bool verifyMinerId(const MinerId& minerId);
+    void readSome(const asio::mutable_buffer& buffer) override;
+    void write(const std::vector<asio::const_buffer>& buffers) override;
 
 protected:
     const std::shared_ptr<Certificate> m_certificate;
     boost::asio::ssl::stream<boost::asio::ip::tcp::socket> m_socket;
     boost::asio::ip::tcp::resolver m_resolver;
-    uint32_t m_readHeader = 0, m_writeHeader = 0;
 };
 
 }
@@ -0,0 +1,171 @@
+#include "pch.h"
+
+#include "simulated_connection.h"
+
+namespace logpass {
+
+SimulatedConnection::SimulatedConnection(asio::io_context& context, const std::shared_ptr<SimulatedNetwork>& network,
+                                         const Endpoint& localEndpoint, const MinerId& localMinerId,
+                                         const MinerId& remoteMinerId, const ConnectionCallbacks& callbacks) :
+    Connection(context, localMinerId, remoteMinerId, callbacks), m_network(network), m_localEndpoint(localEndpoint),
+    m_sendTimer(m_strand)
+{
+    ASSERT(m_network != nullptr && m_localEndpoint.isValid());
+}
+
+void SimulatedConnection::start()
+{
+    ASSERT(!m_closed);
+    ASSERT((!m_outgoing && m_phase == Phase::WAITING_FOR_START) || m_phase == Phase::WAITING_FOR_CONNECTION);
+
+    m_phase = Phase::WAITING_FOR_CONNECTION;
+    Connection::onConnected();
+}
+
+void SimulatedConnection::start(const Endpoint& endpoint)
+{
+    ASSERT(!m_closed && m_phase == Phase::WAITING_FOR_START);
+    ASSERT(m_outgoing && m_remoteMinerId.isValid());
+
+    m_phase = Phase::WAITING_FOR_CONNECTION;
+    m_logger.add_attribute("ID", boost::log::attributes::constant<std::string>(m_remoteMinerId.toString()));
+
+    LOG_CLASS(debug) << "connecting to " << endpoint;
+
+    auto remote = m_network->connect(std::static_pointer_cast<SimulatedConnection>(shared_from_this()),
+                                     m_localEndpoint, endpoint);
+    if (!remote) {
+        return close("can't connect");
+    }
+    setRemote(remote, endpoint);
+    start();
+}
+
+void SimulatedConnection::setRemote(const std::shared_ptr<SimulatedConnection>& remote, const Endpoint& remoteEndpoint)
+{
+    ASSERT(m_phase != Phase::WORKING);
+    m_remote = remote;
+    m_remoteEndpoint = remoteEndpoint;
+}
+
+void SimulatedConnection::shutdown()
+{
+    m_sendTimer.cancel();
+    if (m_remote.expired() || m_dropping) {
+        return;
+    }
+
+    // closing doesn't transfer any data, it's lost when nodes are partitioned
+    auto transmission = m_network->transmit(m_localEndpoint, m_remoteEndpoint, 0);
+    if (transmission) {
+        deliver({}, true, transmission->delivered);
+    }
+}
+
+void SimulatedConnection::readSome(const asio::mutable_buffer& buffer)
+{
+    if (m_closed) {
+        return;
+    }
+
+    ASSERT(!m_pendingRead);
+    m_pendingRead = buffer;
+    if (m_receivedOffset < m_receivedData.size() || m_remoteClosed) {
+        // read handler can't be called from readSome
+        asio::post(m_strand, [this, self = shared_from_this()] {
+            completeRead();
+        });
+    }
+}
+
+void SimulatedConnection::write(const std::vector<asio::const_buffer>& buffers)
+{
+    if (m_closed) {
+        return;
+    }
+
+    std::vector<uint8_t> data(asio::buffer_size(buffers));
+    asio::buffer_copy(asio::buffer(data), buffers);
+    // after data was dropped stream is broken, so nothing is delivered anymore and connection times out
+    auto transmission = m_dropping ? std::nullopt : m_network->transmit(m_localEndpoint, m_remoteEndpoint,
+                                                                        data.size());
+    auto sent = transmission ? transmission->sent : chrono::steady_clock::now();
+    if (transmission) {
+        deliver(std::move(data), false, transmission->delivered);
+    } else {
+        m_dropping = true;
+    }
+
+    // write is finished when data leaves link, so bandwidth limits sender
+    m_sendTimer.expires_at(sent);
+    m_sendTimer.async_wait([this, self = shared_from_this()](auto ec) {
+        if (m_closed || ec) {
+            return;
+        }
+        onWrite();
+    });
+}
+
+void SimulatedConnection::deliver(std::vector<uint8_t>&& data, bool closed,
+                                  chrono::steady_clock::time_point delivered)
+{
+    auto remote = m_remote.lock();
+    if (!remote) {
+        return;
+    }
+
+    uint64_t sequence = m_sentSequence++;
+
+    auto timer = std::make_shared<asio::steady_timer>(remote->getStrand(), delivered);
+    timer->async_wait([remote, timer, sequence, data = std::move(data), closed](auto ec) mutable {
+        remote->onData(sequence, std::move(data), closed);
+    });
+}
+
+void SimulatedConnection::onData(uint64_t sequence, std::vector<uint8_t>&& data, bool closed)
+{
+    if (m_closed) {
+        return;
+    }
+
+    // timers with the same expiration time can be executed in any order
+    m_pendingData.emplace(sequence, std::make_pair(std::move(data), closed));
+    while (!m_pendingData.empty() && m_pendingData.begin()->first == m_receivedSequence) {
+        auto& [receivedData, receivedClosed] = m_pendingData.begin()->second;
+        if (m_receivedOffset == m_receivedData.size() || m_receivedOffset >= READ_BUFFER_SIZE) {
+            m_receivedData.erase(m_receivedData.begin(), m_receivedData.begin() + m_receivedOffset);
+            m_receivedOffset = 0;
+        }
+        m_receivedData.insert(m_receivedData.end(), receivedData.begin(), receivedData.end());
+        m_remoteClosed = m_remoteClosed || receivedClosed;
+        m_pendingData.erase(m_pendingData.begin());
+        m_receivedSequence += 1;
+    }
+
+    if (m_pendingRead && (m_receivedOffset < m_receivedData.size() || m_remoteClosed)) {
+        completeRead();
+    }
+}
+
+void SimulatedConnection::completeRead()
+{
+    if (m_closed || !m_pendingRead) {
+        return;
+    }
+
+    auto buffer = *m_pendingRead;
+    size_t size = std::min(buffer.size(), m_receivedData.size() - m_receivedOffset);
+    if (size == 0 && !m_remoteClosed) {
+        return;
+    }
+    m_pendingRead.reset();
+    if (size == 0) {
+        return onReadSome(asio::error::eof, 0);
+    }
+
+    memcpy(buffer.data(), m_receivedData.data() + m_receivedOffset, size);
+    m_receivedOffset += size;
+    onReadSome({}, size);
+}
+
+}
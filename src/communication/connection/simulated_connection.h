@@ -0,0 +1,52 @@
+#pragma once
+
+#include "connection.h"
+#include "simulated_network.h"
+
+namespace logpass {
+
+// connection working over SimulatedNetwork, all handlers are executed on connection strand
+class SimulatedConnection : public Connection {
+public:
+    SimulatedConnection(asio::io_context& context, const std::shared_ptr<SimulatedNetwork>& network,
+                        const Endpoint& localEndpoint, const MinerId& localMinerId, const MinerId& remoteMinerId,
+                        const ConnectionCallbacks& callbacks);
+
+    void start() override;
+    // starts working, for outgoing connection, should be called only once
+    void start(const Endpoint& endpoint) override;
+
+    // sets other side of connection, must be called before connection starts
+    void setRemote(const std::shared_ptr<SimulatedConnection>& remote, const Endpoint& remoteEndpoint);
+
+protected:
+    void shutdown() override;
+    void readSome(const asio::mutable_buffer& buffer) override;
+    void write(const std::vector<asio::const_buffer>& buffers) override;
+
+private:
+    // delivers data to remote connection at given time, closed flag informs that connection was closed
+    void deliver(std::vector<uint8_t>&& data, bool closed, chrono::steady_clock::time_point delivered);
+    // called by remote connection, data is delivered in order of sequence numbers
+    void onData(uint64_t sequence, std::vector<uint8_t>&& data, bool closed);
+    void completeRead();
+
+    const std::shared_ptr<SimulatedNetwork> m_network;
+    const Endpoint m_localEndpoint;
+    Endpoint m_remoteEndpoint;
+    std::weak_ptr<SimulatedConnection> m_remote;
+    asio::steady_timer m_sendTimer;
+
+    // sent data
+    uint64_t m_sentSequence = 0;
+    bool m_dropping = false;
+    // received data, out of order parts wait in m_pendingData
+    uint64_t m_receivedSequence = 0;
+    std::map<uint64_t, std::pair<std::vector<uint8_t>, bool>> m_pendingData;
+    std::vector<uint8_t> m_receivedData;
+    size_t m_receivedOffset = 0;
+    bool m_remoteClosed = false;
+    std::optional<asio::mutable_buffer> m_pendingRead;
+};
+
+}
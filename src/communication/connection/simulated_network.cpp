@@ -0,0 +1,150 @@
+#include "pch.h"
+
+#include "simulated_connection.h"
+#include "simulated_network.h"
+
+namespace logpass {
+
+void SimulatedNetwork::listen(const Endpoint& endpoint, Listener&& listener)
+{
+    ASSERT(endpoint.isValid() && listener);
+    std::lock_guard lock(m_mutex);
+    m_listeners[endpoint.toString()] = std::move(listener);
+}
+
+void SimulatedNetwork::unlisten(const Endpoint& endpoint)
+{
+    std::lock_guard lock(m_mutex);
+    m_listeners.erase(endpoint.toString());
+}
+
+std::shared_ptr<SimulatedConnection> SimulatedNetwork::connect(const std::shared_ptr<SimulatedConnection>& connection,
+                                                               const Endpoint& from, const Endpoint& to)
+{
+    Listener listener;
+    {
+        std::lock_guard lock(m_mutex);
+        auto it = m_listeners.find(to.toString());
+        if (it == m_listeners.end() || getPartition(from) != getPartition(to)) {
+            m_refusedConnections += 1;
+            return nullptr;
+        }
+        listener = it->second;
+    }
+
+    // listener is called without lock, it can use network
+    auto incomingConnection = listener(connection, from);
+    std::lock_guard lock(m_mutex);
+    if (!incomingConnection) {
+        m_refusedConnections += 1;
+        return nullptr;
+    }
+    m_connections += 1;
+    return incomingConnection;
+}
+
+void SimulatedNetwork::setLink(const Endpoint& from, const Endpoint& to, const SimulatedLink& link)
+{
+    std::lock_guard lock(m_mutex);
+    getLinkState(from, to).link = link;
+}
+
+void SimulatedNetwork::setDefaultLink(const SimulatedLink& link)
+{
+    std::lock_guard lock(m_mutex);
+    m_defaultLink = link;
+}
+
+void SimulatedNetwork::partition(const std::vector<std::vector<Endpoint>>& groups)
+{
+    std::lock_guard lock(m_mutex);
+    m_partitions.clear();
+    for (size_t i = 0; i < groups.size(); ++i) {
+        for (auto& endpoint : groups[i]) {
+            m_partitions[endpoint.toString()] = i + 1;
+        }
+    }
+}
+
+void SimulatedNetwork::heal()
+{
+    std::lock_guard lock(m_mutex);
+    m_partitions.clear();
+}
+
+bool SimulatedNetwork::canCommunicate(const Endpoint& from, const Endpoint& to) const
+{
+    std::lock_guard lock(m_mutex);
+    return getPartition(from) == getPartition(to);
+}
+
+std::optional<SimulatedNetwork::Transmission> SimulatedNetwork::transmit(const Endpoint& from, const Endpoint& to,
+                                                                         size_t size)
+{
+    std::lock_guard lock(m_mutex);
+    if (getPartition(from) != getPartition(to)) {
+        m_droppedBytes += size;
+        return std::nullopt;
+    }
+
+    auto& state = getLinkState(from, to);
+    const SimulatedLink& link = state.link ? *state.link : m_defaultLink;
+    auto now = chrono::steady_clock::now();
+
+    // data waits until previously sent data leaves link
+    Transmission transmission;
+    transmission.sent = std::max(now, state.busyUntil);
+    if (link.bandwidth > 0) {
+        transmission.sent += chrono::duration_cast<chrono::steady_clock::duration>(
+            chrono::duration<double>(size / link.bandwidth));
+    }
+    state.busyUntil = transmission.sent;
+
+    transmission.delivered = transmission.sent + link.latency;
+    if (link.jitter.count() > 0) {
+        std::uniform_int_distribution<int64_t> distribution(0, link.jitter.count());
+        transmission.delivered += chrono::microseconds(distribution(state.generator));
+    }
+    // link is a stream, so data can't be delivered before previously sent data
+    transmission.delivered = std::max(transmission.delivered, state.lastDelivery);
+    state.lastDelivery = transmission.delivered;
+
+    state.transmittedBytes += size;
+    m_transmittedBytes += size;
+    return transmission;
+}
+
+json SimulatedNetwork::getDebugInfo() const
+{
+    std::lock_guard lock(m_mutex);
+    json j;
+    j["listeners"] = m_listeners.size();
+    j["links"] = m_links.size();
+    j["partitions"] = m_partitions.size();
+    j["connections"] = m_connections;
+    j["refused_connections"] = m_refusedConnections;
+    j["transmitted_bytes"] = m_transmittedBytes;
+    j["dropped_bytes"] = m_droppedBytes;
+    return j;
+}
+
+SimulatedNetwork::LinkState& SimulatedNetwork::getLinkState(const Endpoint& from, const Endpoint& to)
+{
+    auto key = std::make_pair(from.toString(), to.toString());
+    auto it = m_links.find(key);
+    if (it == m_links.end()) {
+        // every link has own generator, so its delays don't depend on traffic of other links
+        LinkState state;
+        state.generator.seed(m_seed ^ std::hash<std::string>{}(key.first + ">" + key.second));
+        it = m_links.emplace(std::move(key), std::move(state)).first;
+    }
+    return it->second;
+}
+
+size_t SimulatedNetwork::getPartition(const Endpoint& endpoint) const
+{
+    auto it = m_partitions.find(endpoint.toString());
+    return it == m_partitions.end() ? 0 : it->second;
+}
+
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+namespace logpass {
+
+class SimulatedConnection;
+
+// parameters of one direction of link between two nodes
+struct SimulatedLink {
+    chrono::microseconds latency = chrono::microseconds(0);
+    // random extra delay, from 0 to jitter
+    chrono::microseconds jitter = chrono::microseconds(0);
+    // in bytes per second, 0 means unlimited
+    double bandwidth = 0;
+};
+
+// in-process network used instead of tcp by tests and benchmarks, thread-safe
+// nodes are identified by endpoints, each direction of link has own latency, jitter and bandwidth,
+// nodes from different partitions can't connect and data sent between them is dropped,
+// delays are deterministic for given seed, but order of events still depends on threads scheduling
+class SimulatedNetwork {
+public:
+    // creates and starts incoming connection connected to given remote one, returns nullptr if it was declined
+    using Listener = std::function<std::shared_ptr<SimulatedConnection>(const std::shared_ptr<SimulatedConnection>&,
+                                                                         const Endpoint&)>;
+
+    // time when sent data leaves sender and when it's delivered to receiver
+    struct Transmission {
+        chrono::steady_clock::time_point sent;
+        chrono::steady_clock::time_point delivered;
+    };
+
+    SimulatedNetwork(uint64_t seed = 0, const SimulatedLink& defaultLink = SimulatedLink()) :
+        m_seed(seed), m_defaultLink(defaultLink)
+    {}
+    SimulatedNetwork(const SimulatedNetwork&) = delete;
+    SimulatedNetwork& operator=(const SimulatedNetwork&) = delete;
+
+    void listen(const Endpoint& endpoint, Listener&& listener);
+    void unlisten(const Endpoint& endpoint);
+
+    // connects outgoing connection with node listening on given endpoint, returns incoming connection
+    std::shared_ptr<SimulatedConnection> connect(const std::shared_ptr<SimulatedConnection>& connection,
+                                                 const Endpoint& from, const Endpoint& to);
+
+    // sets parameters of link from one node to other, links which weren't set use default link
+    void setLink(const Endpoint& from, const Endpoint& to, const SimulatedLink& link);
+    void setDefaultLink(const SimulatedLink& link);
+
+    // splits nodes into partitions, nodes which aren't in any group are in the same partition
+    void partition(const std::vector<std::vector<Endpoint>>& groups);
+    // removes all partitions
+    void heal();
+    bool canCommunicate(const Endpoint& from, const Endpoint& to) const;
+
+    // schedules transmission of data sent now, returns nullopt if data is dropped
+    std::optional<Transmission> transmit(const Endpoint& from, const Endpoint& to, size_t size);
+
+    json getDebugInfo() const;
+
+private:
+    struct LinkState {
+        std::optional<SimulatedLink> link;
+        std::mt19937_64 generator;
+        chrono::steady_clock::time_point busyUntil;
+        chrono::steady_clock::time_point lastDelivery;
+        uint64_t transmittedBytes = 0;
+    };
+
+    LinkState& getLinkState(const Endpoint& from, const Endpoint& to);
+    size_t getPartition(const Endpoint& endpoint) const;
+
+    const uint64_t m_seed;
+    mutable std::mutex m_mutex;
+    SimulatedLink m_defaultLink;
+    std::map<std::string, Listener> m_listeners;
+    std::map<std::pair<std::string, std::string>, LinkState> m_links;
+    std::map<std::string, size_t> m_partitions;
+    uint64_t m_transmittedBytes = 0;
+    uint64_t m_droppedBytes = 0;
+    size_t m_connections = 0;
+    size_t m_refusedConnections = 0;
+};
+
+}
@@ -7,7 +7,7 @@ namespace logpass {
 UnsecureConnection::UnsecureConnection(asio::io_context& context, asio::ip::tcp::socket&& socket,
                                        const MinerId& localMinerId, const MinerId& remoteMinerId,
                                        const ConnectionCallbacks& callbacks) :
-    Connection(context, localMinerId, remoteMinerId, callbacks), m_socket(std::move(socket)), m_resolver(context)
+    Connection(context, localMinerId, remoteMinerId, callbacks), m_socket(std::move(socket)), m_resolver(m_strand)
 {}
 
 void UnsecureConnection::start()
@@ -51,7 +51,7 @@ void UnsecureConnection::start(const Endpoint& endpoint)
         boost::asio::ip::tcp::endpoint endpoint = *results;
         LOG_CLASS(trace) << "async resolve found " << results.size() << " endpoints, connecting to: " << endpoint;
 
-        m_socket.async_connect(endpoint, [this, self](auto ec) {
+        m_socket.async_connect(endpoint, bindToStrand([this, self](auto ec) {
             if (m_closed) {
                 return;
             }
@@ -62,92 +62,48 @@ void UnsecureConnection::start(const Endpoint& endpoint)
             m_socket.lowest_layer().set_option(boost::asio::ip::tcp::no_delay(true));
             m_readTimer.cancel();
             start();
-        });
+        }));
     });
 }
 
-void UnsecureConnection::close(std::string_view reason)
+void UnsecureConnection::shutdown()
 {
-    if (m_closed) {
-        return;
-    }
-
     m_resolver.cancel();
     boost::system::error_code ec;
     m_socket.shutdown(asio::ip::tcp::socket::shutdown_both, ec);
-    boost::asio::post(m_context, [this, self = shared_from_this()]() {
+    asio::post(m_strand, [this, self = shared_from_this()]() {
         boost::system::error_code ec;
         m_socket.cancel(ec);
     });
-
-    Connection::close(reason);
 }
 
-void UnsecureConnection::read()
+void UnsecureConnection::readSome(const asio::mutable_buffer& buffer)
 {
     if (m_closed) {
         return;
     }
 
-    asio::async_read(m_socket, asio::buffer(&m_readHeader, 4), [this, self = shared_from_this()](auto ec, auto size) {
-        if (m_closed) {
-            return;
-        }
-        if (ec) {
-            return close("size read error");
-        }
-
-        if (m_readHeader > getMaxPacketSize()) {
-            return close("too big packet size");
-        }
-
-        auto msg = std::make_shared<Serializer>(m_readHeader);
-        if (m_readHeader == 0) {
-            msg->switchToReader(m_readHeader);
-            return onRead(msg);
-        }
-
-        asio::async_read(m_socket, asio::buffer(msg->buffer(), m_readHeader), [this, msg, self](auto ec, auto size) {
-            if (m_closed) {
-                return;
-            }
-            if (ec) {
-                return close("packet read error");
-            }
-
-            msg->switchToReader(m_readHeader);
-            return onRead(msg);
-        });
-    });
+    m_socket.async_read_some(buffer, bindToStrand([this, self = shared_from_this()](auto ec, auto size) {
+        onReadSome(ec, size);
+    }));
 }
 
-void UnsecureConnection::write(const Serializer_cptr& msg)
+void UnsecureConnection::write(const std::vector<asio::const_buffer>& buffers)
 {
     if (m_closed) {
         return;
     }
 
-    m_writeHeader = (uint32_t)msg->pos();
-    asio::async_write(m_socket, asio::buffer(&m_writeHeader, 4),
-                      [this, msg, self = shared_from_this()](auto ec, auto size) {
+    asio::async_write(m_socket, buffers, bindToStrand([this, self = shared_from_this()](auto ec, auto size) {
         if (m_closed) {
             return;
         }
         if (ec) {
-            return close("write size error");
+            return close("write error");
         }
 
-        asio::async_write(m_socket, asio::buffer(msg->buffer(), msg->pos()), [this, msg, self](auto ec, auto size) {
-            if (m_closed) {
-                return;
-            }
-            if (ec) {
-                return close("write packet error");
-            }
-
-            onWrite();
-        });
-    });
+        onWrite();
+    }));
 }
 
 }
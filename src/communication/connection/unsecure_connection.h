@@ -4,7 +4,7 @@
 
 namespace logpass {
 
-// not thread-safe
+// all handlers are executed on connection strand
 class UnsecureConnection : public Connection {
 public:
     UnsecureConnection(asio::io_context& context, asio::ip::tcp::socket&& socket,
@@ -13,17 +13,15 @@ public:
     void start() override;
     // starts working, for outgoing connection, should be called only once
     void start(const Endpoint& endpoint) override;
-    // closes connection
-    void close(std::string_view reason = "") override;
 
 protected:
-    void read() override;
-    void write(const Serializer_cptr& msg) override;
+    void shutdown() override;
+    void readSome(const asio::mutable_buffer& buffer) override;
+    void write(const std::vector<asio::const_buffer>& buffers) override;
 
 protected:
     boost::asio::ip::tcp::socket m_socket;
     boost::asio::ip::tcp::resolver m_resolver;
-    uint32_t m_readHeader = 0, m_writeHeader = 0;
 };
 
 }
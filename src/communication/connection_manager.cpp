@@ -369,12 +369,6 @@ json ConnectionManager::getDebugInfo() const
         {"blocked_outgoing_connections", std::map<std::string, size_t>()},
         {"blocked_incoming_connections", std::map<std::string, size_t>()},
     };
-    for (auto& it : m_pendingConnections) {
-        j["pending_connections"].push_back(it->getDebugInfo());
-    }
-    for (auto& it : m_connections) {
-        j["connections"].emplace(it.right.toString(), it.left->getDebugInfo());
-    }
     for (size_t i = 0; i < m_connectionsCount.size(); ++i) {
         j["connections_count"].push_back(json{
             {"in", m_connectionsCount[i].first},
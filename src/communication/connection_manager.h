@@ -43,6 +43,7 @@ public:
 
     void recalculateConnectionsCount();
 
+    // doesn't include debug info of connections, it must be collected on their strands
     json getDebugInfo() const;
 
     void sortMiners(std::vector<std::pair<MinerId, Endpoint>>& miners);
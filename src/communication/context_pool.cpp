@@ -0,0 +1,49 @@
+#include "pch.h"
+
+#include "context_pool.h"
+
+namespace logpass {
+
+ContextPool::ContextPool(size_t size)
+{
+    ASSERT(size > 0);
+    for (size_t i = 0; i < size; ++i) {
+        m_contexts.push_back(std::make_unique<asio::io_context>(1));
+        m_guards.push_back(asio::make_work_guard(*m_contexts.back()));
+    }
+}
+
+ContextPool::~ContextPool()
+{
+    ASSERT(m_threads.empty());
+}
+
+void ContextPool::start()
+{
+    ASSERT(m_threads.empty() && !m_stopped);
+    for (auto& context : m_contexts) {
+        m_threads.push_back(std::thread([context = context.get()] {
+            SET_THREAD_NAME("communication_worker");
+            context->run();
+        }));
+    }
+}
+
+void ContextPool::stop()
+{
+    m_stopped = true;
+    for (auto& guard : m_guards) {
+        guard.reset();
+    }
+    for (auto& thread : m_threads) {
+        thread.join();
+    }
+    m_threads.clear();
+}
+
+asio::io_context& ContextPool::getContext()
+{
+    return *m_contexts[m_nextContext.fetch_add(1) % m_contexts.size()];
+}
+
+}
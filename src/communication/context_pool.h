@@ -0,0 +1,33 @@
+#pragma once
+
+namespace logpass {
+
+// pool of io_contexts, every context runs on own thread, used to spread connections across threads
+class ContextPool {
+public:
+    ContextPool(size_t size);
+    ~ContextPool();
+    ContextPool(const ContextPool&) = delete;
+    ContextPool& operator=(const ContextPool&) = delete;
+
+    void start();
+    // finishes all tasks and stops threads
+    void stop();
+
+    // returns next context, in round-robin order
+    asio::io_context& getContext();
+
+    size_t getSize() const
+    {
+        return m_contexts.size();
+    }
+
+private:
+    std::vector<std::unique_ptr<asio::io_context>> m_contexts;
+    std::vector<asio::executor_work_guard<asio::io_context::executor_type>> m_guards;
+    std::vector<std::thread> m_threads;
+    std::atomic<size_t> m_nextContext = 0;
+    bool m_stopped = false;
+};
+
+}
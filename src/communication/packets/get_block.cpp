@@ -9,23 +9,27 @@
 
 namespace logpass {
 
-Packet_ptr GetBlockPacket::create(PendingBlock::Status status, const PendingBlock_ptr& pendingBlock)
+Packet_ptr GetBlockPacket::create(const BlockDownloadAssignment& assignment, bool helper)
 {
-    ASSERT(status != PendingBlock::Status::COMPLETE);
+    ASSERT(assignment.status != PendingBlock::Status::COMPLETE);
 
     auto packet = std::make_shared<GetBlockPacket>();
-    packet->m_pendingBlock = pendingBlock;
-    packet->m_blockId = pendingBlock->getId();
-    packet->m_headerHash = pendingBlock->getHeaderHash();
-    packet->m_status = status;
+    packet->m_pendingBlock = assignment.pendingBlock;
+    packet->m_assignment = assignment;
+    packet->m_helper = helper;
+    packet->m_requestTime = chrono::steady_clock::now();
+    packet->m_blockId = assignment.pendingBlock->getId();
+    packet->m_headerHash = assignment.pendingBlock->getHeaderHash();
+    packet->m_status = assignment.status;
 
-    if (status == PendingBlock::Status::MISSING_BODY) {
-        packet->m_bodyHash = pendingBlock->getBlockBodyHash();
-    } else if (status == PendingBlock::Status::MISSING_TRANSACTION_IDS) {
-        packet->m_transactionIdsHashes = pendingBlock->getMissingTransactionIdsHashes(MAX_TRANSACTION_IDS);
-    } else if (status == PendingBlock::Status::MISSING_TRANSACTIONS) {
-        packet->m_transactionIds = pendingBlock->getMissingTransactionIds(MAX_TRANSACTIONS,
-                                                                          MAX_TRANSACTIONS_SIZE);
+    if (assignment.status == PendingBlock::Status::MISSING_BODY) {
+        packet->m_bodyHash = assignment.pendingBlock->getBlockBodyHash();
+    } else if (assignment.status == PendingBlock::Status::MISSING_TRANSACTION_IDS) {
+        ASSERT(!assignment.transactionIdsHashes.empty());
+        packet->m_transactionIdsHashes = assignment.transactionIdsHashes;
+    } else if (assignment.status == PendingBlock::Status::MISSING_TRANSACTIONS) {
+        ASSERT(!assignment.transactionIds.empty());
+        packet->m_transactionIds = assignment.transactionIds;
     }
 
     return packet;
@@ -40,7 +44,6 @@ void GetBlockPacket::serializeRequestBody(Serializer& s)
     } else {
         s.put<uint8_t>((uint8_t)m_status);
     }
-    s(m_expired);
     if (m_status == PendingBlock::Status::MISSING_BODY) {
         s(m_bodyHash);
     } else if (m_status == PendingBlock::Status::MISSING_TRANSACTION_IDS) {
@@ -54,6 +57,7 @@ void GetBlockPacket::serializeRequestBody(Serializer& s)
 
 void GetBlockPacket::serializeResponseBody(Serializer& s)
 {
+    s(m_expired);
     if (m_status == PendingBlock::Status::MISSING_BODY) {
         s.serializeOptional(m_blockBody);
     } else if (m_status == PendingBlock::Status::MISSING_TRANSACTION_IDS) {
@@ -213,10 +217,23 @@ void GetBlockPacket::executeRequest(const PacketExecutionParams& params)
 
 void GetBlockPacket::executeResponse(const PacketExecutionParams& params)
 {
+    auto duration = chrono::steady_clock::now() - m_requestTime;
+    if (m_helper) {
+        // helper doesn't own pending block, so only its part is updated
+        auto result = m_expired ? PendingBlock::AddResult::INVALID_DATA : addToPendingBlock(params);
+        if (!m_expired && result == PendingBlock::AddResult::INVALID_DATA) {
+            THROW_EXCEPTION(SessionException("invalid block part"));
+        }
+        return params.session->onHelperBlockPart(m_assignment, m_expired ? 0 : getResponseSize(), duration,
+                                                 !m_expired);
+    }
+
     // check if block expired
     if (m_expired) {
+        params.session->onBlockPart(m_assignment, 0, duration, false);
         return params.session->onExpiredBlock(m_pendingBlock, false);
     }
+    params.session->onBlockPart(m_assignment, getResponseSize(), duration, true);
 
     // check if block is still valid
     auto blockStatus = m_pendingBlock->getStatus();
@@ -229,22 +246,8 @@ void GetBlockPacket::executeResponse(const PacketExecutionParams& params)
     }
 
     // update block
-    bool validData = false;
-    if (m_status == PendingBlock::Status::MISSING_BODY) {
-        auto status = m_pendingBlock->addBlockBody(m_blockBody);
-        if (status == PendingBlock::AddResult::CORRECT || status == PendingBlock::AddResult::DUPLICATED)
-            validData = true;
-    } else if (m_status == PendingBlock::Status::MISSING_TRANSACTION_IDS) {
-        auto status = m_pendingBlock->addBlockTransactionIds(m_blockTransactionIds);
-        if (status == PendingBlock::AddResult::CORRECT || status == PendingBlock::AddResult::DUPLICATED) {
-            validData = true;
-        } else {
-            validData = false;
-        }
-    } else if (m_status == PendingBlock::Status::MISSING_TRANSACTIONS) {
-        params.blockchain->addTransactions(m_transactions, params.session->getMiner());
-        validData = true;
-    }
+    auto result = addToPendingBlock(params);
+    bool validData = result == PendingBlock::AddResult::CORRECT || result == PendingBlock::AddResult::DUPLICATED;
 
     // update block status
     blockStatus = m_pendingBlock->getStatus();
@@ -258,7 +261,33 @@ void GetBlockPacket::executeResponse(const PacketExecutionParams& params)
     }
 
     // block is not ready, request next part
-    params.connection->send(GetBlockPacket::create(blockStatus, m_pendingBlock));
+    params.session->continueBlock(m_pendingBlock);
+}
+
+PendingBlock::AddResult GetBlockPacket::addToPendingBlock(const PacketExecutionParams& params)
+{
+    if (m_status == PendingBlock::Status::MISSING_BODY) {
+        return m_pendingBlock->addBlockBody(m_blockBody);
+    } else if (m_status == PendingBlock::Status::MISSING_TRANSACTION_IDS) {
+        return m_pendingBlock->addBlockTransactionIds(m_blockTransactionIds);
+    }
+    params.blockchain->addTransactions(m_transactions, params.session->getMiner());
+    return PendingBlock::AddResult::CORRECT;
+}
+
+size_t GetBlockPacket::getResponseSize() const
+{
+    size_t size = 0;
+    if (m_blockBody) {
+        size += m_blockBody->getHashes().size() * Hash::SIZE;
+    }
+    for (auto& blockTransactionIds : m_blockTransactionIds) {
+        size += blockTransactionIds->size() * TransactionId::SIZE;
+    }
+    for (auto& transaction : m_transactions) {
+        size += transaction->getSize();
+    }
+    return size;
 }
 
 }
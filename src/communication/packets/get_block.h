@@ -2,10 +2,11 @@
 
 #include "packet.h"
 #include <blockchain/block/pending_block.h>
+#include <communication/block_downloader.h>
 
 namespace logpass {
 
-// packet used to get block header after one of blocks header with given id and hash
+// packet used to get parts of pending block, helper packets download parts of block requested by other session
 class GetBlockPacket : public PacketWithResponse {
 public:
     static constexpr uint8_t TYPE = 0x08;
@@ -15,7 +16,12 @@ public:
 
     GetBlockPacket() : PacketWithResponse(TYPE) {}
 
-    static Packet_ptr create(PendingBlock::Status status, const PendingBlock_ptr& pendingBlock);
+    PacketPriority getPriority() const override
+    {
+        return PacketPriority::BLOCK_DATA;
+    }
+
+    static Packet_ptr create(const BlockDownloadAssignment& assignment, bool helper = false);
 
 protected:
     void serializeRequestBody(Serializer& s) override;
@@ -27,8 +33,16 @@ protected:
     void executeRequest(const PacketExecutionParams& params) override;
     void executeResponse(const PacketExecutionParams& params) override;
 
+    // adds received part to pending block
+    PendingBlock::AddResult addToPendingBlock(const PacketExecutionParams& params);
+    // returns approximate size of response
+    size_t getResponseSize() const;
+
 protected:
     PendingBlock_ptr m_pendingBlock;
+    BlockDownloadAssignment m_assignment;
+    bool m_helper = false;
+    chrono::steady_clock::time_point m_requestTime;
 
     // request
     uint32_t m_blockId;
@@ -0,0 +1,230 @@
+#include "pch.h"
+#include "get_block_transactions.h"
+
+#include <blockchain/blockchain.h>
+#include <blockchain/block/block.h>
+#include <blockchain/transactions/transaction.h>
+#include <communication/connection/connection.h>
+#include <communication/session.h>
+
+namespace logpass {
+
+Packet_ptr GetBlockTransactionsPacket::create(const PendingBlock_ptr& pendingBlock, std::vector<Chunk>&& chunks)
+{
+    ASSERT(!chunks.empty() && chunks.size() <= MAX_CHUNKS);
+
+    auto packet = std::make_shared<GetBlockTransactionsPacket>();
+    packet->m_pendingBlock = pendingBlock;
+    packet->m_blockId = pendingBlock->getId();
+    packet->m_headerHash = pendingBlock->getHeaderHash();
+    packet->m_chunks = std::move(chunks);
+    return packet;
+}
+
+GetBlockTransactionsPacket::MergedChunks GetBlockTransactionsPacket::mergeChunks(
+    std::vector<Chunk>& chunks, const std::vector<Transaction_cptr>& transactions)
+{
+    MergedChunks merged;
+    size_t offset = 0;
+    for (auto& chunk : chunks) {
+        if (offset == transactions.size()) {
+            break;
+        }
+        size_t chunkOffset = offset;
+        for (uint16_t position : chunk.positions) {
+            chunk.transactionIds[position] = transactions[offset++]->getId();
+        }
+        auto transactionIds = std::make_shared<BlockTransactionIds>(chunk.transactionIds);
+        if (transactionIds->getHash() != chunk.hash) {
+            // short id matched wrong local transaction or peer sent wrong transactions
+            merged.mismatchedChunks.push_back(chunk.index);
+            continue;
+        }
+        merged.blockTransactionIds.push_back(transactionIds);
+        merged.transactions.insert(merged.transactions.end(), transactions.begin() + chunkOffset,
+                                   transactions.begin() + offset);
+    }
+    return merged;
+}
+
+void GetBlockTransactionsPacket::serializeRequestBody(Serializer& s)
+{
+    s(m_blockId);
+    s(m_headerHash);
+    if (s.reader()) {
+        m_chunks.resize(s.get<uint8_t>());
+    } else {
+        s.put<uint8_t>((uint8_t)m_chunks.size());
+    }
+    for (auto& chunk : m_chunks) {
+        s(chunk.index);
+        s(chunk.hash);
+        s(chunk.positions);
+    }
+}
+
+void GetBlockTransactionsPacket::serializeResponseBody(Serializer& s)
+{
+    s(m_expired);
+    s(m_transactions);
+}
+
+bool GetBlockTransactionsPacket::validateRequest()
+{
+    if (m_chunks.empty() || m_chunks.size() > MAX_CHUNKS) {
+        return false;
+    }
+
+    std::set<uint32_t> uniqueIndexes;
+    size_t transactions = 0;
+    for (auto& chunk : m_chunks) {
+        if (chunk.index >= MAX_CHUNKS || !uniqueIndexes.insert(chunk.index).second) {
+            return false;
+        }
+        if (chunk.positions.empty()) {
+            return false;
+        }
+        for (size_t i = 0; i < chunk.positions.size(); ++i) {
+            if (chunk.positions[i] >= kBlockTransactionsPerChunk) {
+                return false;
+            }
+            if (i > 0 && chunk.positions[i] <= chunk.positions[i - 1]) {
+                return false;
+            }
+        }
+        transactions += chunk.positions.size();
+    }
+    return transactions <= MAX_TRANSACTIONS;
+}
+
+bool GetBlockTransactionsPacket::validateResponse()
+{
+    if (m_expired) {
+        return m_transactions.empty();
+    }
+
+    // response must contain all transactions of some first chunks
+    size_t transactions = 0;
+    for (auto& chunk : m_chunks) {
+        if (transactions >= m_transactions.size()) {
+            break;
+        }
+        transactions += chunk.positions.size();
+    }
+    return transactions == m_transactions.size();
+}
+
+void GetBlockTransactionsPacket::executeRequest(const PacketExecutionParams& params)
+{
+    // first try to find block in active branch of BlockTree
+    Block_cptr block;
+    auto activeBranch = params.blockTree->getActiveBranch();
+    auto it = std::find_if(activeBranch.begin(), activeBranch.end(), [&](auto& node) {
+        return node.getHeaderHash() == m_headerHash;
+    });
+    if (it != activeBranch.end()) {
+        block = it->block;
+    }
+
+    size_t transactionsSize = 0;
+    for (auto& chunk : m_chunks) {
+        BlockTransactionIds_cptr blockTransactionIds;
+        if (block) {
+            auto blocksTransactionIds = block->getBlockTransactionIds();
+            if (chunk.index >= blocksTransactionIds.size() ||
+                blocksTransactionIds[chunk.index]->getHash() != chunk.hash) {
+                THROW_PACKET_EXCEPTION("Requested invalid transactions id");
+            }
+            blockTransactionIds = blocksTransactionIds[chunk.index];
+        } else {
+            blockTransactionIds = params.database->blocks.getBlockTransactionIds(m_blockId, (uint8_t)chunk.index);
+            if (!blockTransactionIds || blockTransactionIds->getHash() != chunk.hash) {
+                m_expired = true;
+                m_transactions.clear();
+                return;
+            }
+        }
+
+        // send only whole chunks, remaining ones are requested by GetBlockPacket
+        size_t chunkSize = 0;
+        for (uint16_t position : chunk.positions) {
+            if (position >= blockTransactionIds->size()) {
+                THROW_PACKET_EXCEPTION("Requested invalid transaction");
+            }
+            chunkSize += blockTransactionIds->at(position).getSize();
+        }
+        if (transactionsSize + chunkSize > MAX_TRANSACTIONS_SIZE) {
+            return;
+        }
+        transactionsSize += chunkSize;
+
+        for (uint16_t position : chunk.positions) {
+            auto& transactionId = blockTransactionIds->at(position);
+            Transaction_cptr transaction;
+            if (block) {
+                transaction = block->getTransaction(transactionId);
+                if (!transaction) {
+                    THROW_PACKET_EXCEPTION("Requested invalid transaction");
+                }
+            } else {
+                transaction = params.blockchain->getTransaction(transactionId).first;
+                if (!transaction) {
+                    m_expired = true;
+                    m_transactions.clear();
+                    return;
+                }
+            }
+            m_transactions.push_back(transaction);
+        }
+    }
+}
+
+void GetBlockTransactionsPacket::executeResponse(const PacketExecutionParams& params)
+{
+    // check if block expired
+    if (m_expired) {
+        return params.session->onExpiredBlock(m_pendingBlock, false);
+    }
+
+    // check if block is still valid
+    auto blockStatus = m_pendingBlock->getStatus();
+    if (blockStatus == PendingBlock::Status::INVALID) {
+        return params.session->onInvalidBlock(m_pendingBlock);
+    } else if (blockStatus == PendingBlock::Status::EXPIRED) {
+        return params.session->onExpiredBlock(m_pendingBlock, true);
+    } else if (blockStatus == PendingBlock::Status::COMPLETE || blockStatus == PendingBlock::Status::FINISHED) {
+        return params.session->onCompletedBlock(m_pendingBlock);
+    }
+
+    // rebuild chunks from local transaction ids and received transactions, mismatched chunks will be requested by
+    // GetBlockPacket
+    auto merged = mergeChunks(m_chunks, m_transactions);
+    if (!merged.mismatchedChunks.empty()) {
+        params.session->onMismatchedTransactionIds(m_pendingBlock, merged.mismatchedChunks);
+    }
+
+    bool validData = true;
+    if (!merged.blockTransactionIds.empty()) {
+        auto status = m_pendingBlock->addBlockTransactionIds(merged.blockTransactionIds);
+        validData = status == PendingBlock::AddResult::CORRECT || status == PendingBlock::AddResult::DUPLICATED;
+    }
+    if (validData && !merged.transactions.empty()) {
+        params.blockchain->addTransactions(merged.transactions, params.session->getMiner());
+    }
+
+    // update block status
+    blockStatus = m_pendingBlock->getStatus();
+    // check if data and pending block are valid
+    if (!validData || blockStatus == PendingBlock::Status::INVALID) {
+        return params.session->onInvalidBlock(m_pendingBlock);
+    } else if (blockStatus == PendingBlock::Status::EXPIRED) {
+        return params.session->onExpiredBlock(m_pendingBlock, true);
+    } else if (blockStatus == PendingBlock::Status::COMPLETE || blockStatus == PendingBlock::Status::FINISHED) {
+        return params.session->onCompletedBlock(m_pendingBlock);
+    }
+
+    // block is not ready, request remaining parts
+    params.session->continueBlock(m_pendingBlock);
+}
+
+}
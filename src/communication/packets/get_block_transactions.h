@@ -0,0 +1,68 @@
+#pragma once
+
+#include "packet.h"
+#include <blockchain/block/pending_block.h>
+
+namespace logpass {
+
+// packet used to get transactions missing in compact block, selected by chunk index and position in chunk
+class GetBlockTransactionsPacket : public PacketWithResponse {
+public:
+    static constexpr uint8_t TYPE = 0x0B;
+    static constexpr size_t MAX_CHUNKS = kBlockMaxTransactions / kBlockTransactionsPerChunk;
+    static constexpr size_t MAX_TRANSACTIONS = 4096;
+    static constexpr size_t MAX_TRANSACTIONS_SIZE = kNetworkMaxPacketSize - 1024;
+
+    // chunk of block transaction ids, transactionIds are known only by requester
+    struct Chunk {
+        uint32_t index = 0;
+        Hash hash;
+        std::vector<TransactionId> transactionIds;
+        std::vector<uint16_t> positions;
+    };
+
+    // received transactions merged into requested chunks
+    struct MergedChunks {
+        std::vector<BlockTransactionIds_cptr> blockTransactionIds;
+        // transactions of chunks with correct hash
+        std::vector<Transaction_cptr> transactions;
+        // indexes of chunks which hash doesn't match, they must be requested by GetBlockPacket
+        std::vector<uint32_t> mismatchedChunks;
+    };
+
+    GetBlockTransactionsPacket() : PacketWithResponse(TYPE) {}
+
+    PacketPriority getPriority() const override
+    {
+        return PacketPriority::BLOCK_DATA;
+    }
+
+    static Packet_ptr create(const PendingBlock_ptr& pendingBlock, std::vector<Chunk>&& chunks);
+
+    // fills positions of chunks with ids of received transactions, transactions must be in order of chunks
+    static MergedChunks mergeChunks(std::vector<Chunk>& chunks, const std::vector<Transaction_cptr>& transactions);
+
+protected:
+    void serializeRequestBody(Serializer& s) override;
+    void serializeResponseBody(Serializer& s) override;
+
+    bool validateRequest() override;
+    bool validateResponse() override;
+
+    void executeRequest(const PacketExecutionParams& params) override;
+    void executeResponse(const PacketExecutionParams& params) override;
+
+protected:
+    PendingBlock_ptr m_pendingBlock;
+
+    // request
+    uint32_t m_blockId;
+    Hash m_headerHash;
+    std::vector<Chunk> m_chunks;
+
+    // response, contains transactions of first chunks which fit in packet
+    bool m_expired = false;
+    std::vector<Transaction_cptr> m_transactions;
+};
+
+}
@@ -0,0 +1,197 @@
+#include "pch.h"
+#include "get_compact_block.h"
+#include "get_block_transactions.h"
+
+#include <blockchain/blockchain.h>
+#include <blockchain/block/block.h>
+#include <communication/connection/connection.h>
+#include <communication/session.h>
+
+namespace logpass {
+
+Packet_ptr GetCompactBlockPacket::create(const PendingBlock_ptr& pendingBlock, uint64_t salt)
+{
+    auto packet = std::make_shared<GetCompactBlockPacket>();
+    packet->m_pendingBlock = pendingBlock;
+    packet->m_blockId = pendingBlock->getId();
+    packet->m_headerHash = pendingBlock->getHeaderHash();
+    packet->m_bodyHash = pendingBlock->getBlockBodyHash();
+    packet->m_salt = salt;
+    return packet;
+}
+
+void GetCompactBlockPacket::serializeRequestBody(Serializer& s)
+{
+    s(m_blockId);
+    s(m_headerHash);
+    s(m_bodyHash);
+    s(m_salt);
+}
+
+void GetCompactBlockPacket::serializeResponseBody(Serializer& s)
+{
+    s(m_expired);
+    s.serializeOptional(m_blockBody);
+    s(m_shortTransactionIds);
+}
+
+bool GetCompactBlockPacket::validateRequest()
+{
+    return m_bodyHash.isValid();
+}
+
+bool GetCompactBlockPacket::validateResponse()
+{
+    if (m_expired) {
+        return !m_blockBody && m_shortTransactionIds.empty();
+    }
+
+    if (!m_blockBody || m_blockBody->getHash() != m_bodyHash) {
+        return false;
+    }
+    if (m_shortTransactionIds.size() != m_blockBody->getHashes().size()) {
+        return false;
+    }
+    size_t transactions = 0;
+    for (auto& shortTransactionIds : m_shortTransactionIds) {
+        if (shortTransactionIds.empty() || shortTransactionIds.size() > kBlockTransactionsPerChunk) {
+            return false;
+        }
+        transactions += shortTransactionIds.size();
+    }
+    return transactions == m_blockBody->getTransactions();
+}
+
+void GetCompactBlockPacket::executeRequest(const PacketExecutionParams& params)
+{
+    BlockBody_cptr blockBody;
+    std::vector<BlockTransactionIds_cptr> blockTransactionIds;
+
+    // first try to find block in active branch of BlockTree
+    auto activeBranch = params.blockTree->getActiveBranch();
+    auto it = std::find_if(activeBranch.begin(), activeBranch.end(), [&](auto& node) {
+        return node.getHeaderHash() == m_headerHash;
+    });
+    if (it != activeBranch.end()) {
+        blockBody = it->block->getBlockBody();
+        blockTransactionIds = it->block->getBlockTransactionIds();
+    } else {
+        // get required data from database
+        blockBody = params.database->blocks.getBlockBody(m_blockId);
+        if (!blockBody || blockBody->getHash() != m_bodyHash) {
+            m_expired = true;
+            return;
+        }
+        for (size_t index = 0; index < blockBody->getHashes().size(); ++index) {
+            auto transactionIds = params.database->blocks.getBlockTransactionIds(m_blockId, (uint8_t)index);
+            if (!transactionIds || transactionIds->getHash() != blockBody->getHashes()[index]) {
+                m_expired = true;
+                return;
+            }
+            blockTransactionIds.push_back(transactionIds);
+        }
+    }
+
+    m_blockBody = blockBody;
+    for (auto& transactionIds : blockTransactionIds) {
+        auto& shortTransactionIds = m_shortTransactionIds.emplace_back();
+        shortTransactionIds.reserve(transactionIds->size());
+        for (auto& transactionId : *transactionIds) {
+            shortTransactionIds.push_back(ShortTransactionIds::calculate(m_salt, transactionId));
+        }
+    }
+}
+
+void GetCompactBlockPacket::executeResponse(const PacketExecutionParams& params)
+{
+    // check if block expired
+    if (m_expired) {
+        return params.session->onExpiredBlock(m_pendingBlock, false);
+    }
+
+    // check if block is still valid
+    auto blockStatus = m_pendingBlock->getStatus();
+    if (blockStatus == PendingBlock::Status::INVALID) {
+        return params.session->onInvalidBlock(m_pendingBlock);
+    } else if (blockStatus == PendingBlock::Status::EXPIRED) {
+        return params.session->onExpiredBlock(m_pendingBlock, true);
+    } else if (blockStatus == PendingBlock::Status::COMPLETE || blockStatus == PendingBlock::Status::FINISHED) {
+        return params.session->onCompletedBlock(m_pendingBlock);
+    }
+
+    // update block
+    auto status = m_pendingBlock->addBlockBody(m_blockBody);
+    bool validData = status == PendingBlock::AddResult::CORRECT || status == PendingBlock::AddResult::DUPLICATED;
+
+    // rebuild block transaction ids from pending transactions
+    std::vector<GetBlockTransactionsPacket::Chunk> missingChunks;
+    if (validData && m_pendingBlock->getStatus() == PendingBlock::Status::MISSING_TRANSACTION_IDS) {
+        // only short ids of missing chunks are looked up in index of pending transactions
+        auto missingTransactionIdsHashes = m_pendingBlock->getMissingTransactionIdsHashes();
+        std::set<uint64_t> requiredShortTransactionIds;
+        for (auto& [index, hash] : missingTransactionIdsHashes) {
+            for (auto& shortTransactionId : m_shortTransactionIds[index]) {
+                requiredShortTransactionIds.insert(ShortTransactionIds::fromShortTransactionId(shortTransactionId));
+            }
+        }
+        auto knownTransactionIds = params.blockchain->getPendingTransactions().getTransactionIds(
+            m_salt, requiredShortTransactionIds);
+
+        std::vector<BlockTransactionIds_cptr> blockTransactionIds;
+        size_t missingTransactions = 0;
+        for (auto& [index, hash] : missingTransactionIdsHashes) {
+            GetBlockTransactionsPacket::Chunk chunk{ .index = index, .hash = hash };
+            chunk.transactionIds.resize(m_shortTransactionIds[index].size());
+            for (uint16_t position = 0; position < chunk.transactionIds.size(); ++position) {
+                auto it = knownTransactionIds.find(
+                    ShortTransactionIds::fromShortTransactionId(m_shortTransactionIds[index][position]));
+                if (it != knownTransactionIds.end()) {
+                    chunk.transactionIds[position] = it->second;
+                } else {
+                    chunk.positions.push_back(position);
+                }
+            }
+
+            if (chunk.positions.empty()) {
+                auto transactionIds = std::make_shared<BlockTransactionIds>(chunk.transactionIds);
+                // on short id collision chunk is requested by GetBlockPacket
+                if (transactionIds->getHash() == hash) {
+                    blockTransactionIds.push_back(transactionIds);
+                }
+                continue;
+            }
+
+            if (missingTransactions + chunk.positions.size() > GetBlockTransactionsPacket::MAX_TRANSACTIONS) {
+                continue;
+            }
+            missingTransactions += chunk.positions.size();
+            missingChunks.push_back(std::move(chunk));
+        }
+
+        if (!blockTransactionIds.empty()) {
+            status = m_pendingBlock->addBlockTransactionIds(blockTransactionIds);
+            validData = status == PendingBlock::AddResult::CORRECT || status == PendingBlock::AddResult::DUPLICATED;
+        }
+    }
+
+    // update block status
+    blockStatus = m_pendingBlock->getStatus();
+    // check if data and pending block are valid
+    if (!validData || blockStatus == PendingBlock::Status::INVALID) {
+        return params.session->onInvalidBlock(m_pendingBlock);
+    } else if (blockStatus == PendingBlock::Status::EXPIRED) {
+        return params.session->onExpiredBlock(m_pendingBlock, true);
+    } else if (blockStatus == PendingBlock::Status::COMPLETE || blockStatus == PendingBlock::Status::FINISHED) {
+        return params.session->onCompletedBlock(m_pendingBlock);
+    }
+
+    // fetch transactions missing in pending transactions in single round trip
+    if (!missingChunks.empty()) {
+        return params.connection->send(GetBlockTransactionsPacket::create(m_pendingBlock, std::move(missingChunks)));
+    }
+
+    // block is not ready, request next part
+    params.session->continueBlock(m_pendingBlock);
+}
+
+}
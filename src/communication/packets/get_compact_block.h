@@ -0,0 +1,50 @@
+#pragma once
+
+#include "packet.h"
+#include <blockchain/block/pending_block.h>
+#include <crypto/short_transaction_ids.h>
+
+namespace logpass {
+
+// packet used to get block body with salted short ids of block transactions
+// block transaction ids are rebuilt from pending transactions, missing ones are requested by GetBlockTransactionsPacket
+class GetCompactBlockPacket : public PacketWithResponse {
+public:
+    static constexpr uint8_t TYPE = 0x0A;
+
+    GetCompactBlockPacket() : PacketWithResponse(TYPE) {}
+
+    PacketPriority getPriority() const override
+    {
+        return PacketPriority::BLOCK_DATA;
+    }
+
+    // salt should be the one of short transaction ids index of pending transactions
+    static Packet_ptr create(const PendingBlock_ptr& pendingBlock, uint64_t salt);
+
+protected:
+    void serializeRequestBody(Serializer& s) override;
+    void serializeResponseBody(Serializer& s) override;
+
+    bool validateRequest() override;
+    bool validateResponse() override;
+
+    void executeRequest(const PacketExecutionParams& params) override;
+    void executeResponse(const PacketExecutionParams& params) override;
+
+protected:
+    PendingBlock_ptr m_pendingBlock;
+
+    // request
+    uint32_t m_blockId;
+    Hash m_headerHash;
+    Hash m_bodyHash;
+    uint64_t m_salt;
+
+    // response
+    bool m_expired = false;
+    BlockBody_cptr m_blockBody;
+    std::vector<std::vector<ShortTransactionId>> m_shortTransactionIds;
+};
+
+}
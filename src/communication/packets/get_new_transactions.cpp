@@ -38,7 +38,7 @@ bool GetNewTransactionsPacket::validateRequest()
         transactionsSize += transactionId.getSize();
     }
 
-    if (transactionsSize > kNetworkMaxPacketSize - 1024) {
+    if (transactionsSize > MAX_TRANSACTIONS_SIZE) {
         return false;
     }
 
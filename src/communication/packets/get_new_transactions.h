@@ -11,9 +11,15 @@ public:
     static constexpr uint8_t TYPE = 0x09;
     static constexpr size_t MAX_TRANSACTION_IDS = 16;
     static constexpr size_t MAX_TRANSACTIONS = 1024;
+    static constexpr size_t MAX_TRANSACTIONS_SIZE = kNetworkMaxPacketSize - 1024;
 
     GetNewTransactionsPacket() : PacketWithResponse(TYPE) {}
 
+    PacketPriority getPriority() const override
+    {
+        return PacketPriority::TRANSACTIONS;
+    }
+
     static Packet_ptr create(const std::set<TransactionId>& transactionIds);
 
 protected:
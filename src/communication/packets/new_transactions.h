@@ -13,6 +13,11 @@ public:
 
     NewTransactionsPacket() : Packet(TYPE) {}
 
+    PacketPriority getPriority() const override
+    {
+        return PacketPriority::TRANSACTIONS;
+    }
+
     static Packet_ptr create(const std::set<TransactionId>& transactionIds);
 
 protected:
@@ -4,9 +4,12 @@
 #include "first_packet.h"
 #include "get_block_header.h"
 #include "get_block.h"
+#include "get_block_transactions.h"
+#include "get_compact_block.h"
 #include "get_new_transactions.h"
 #include "new_blocks.h"
 #include "new_transactions.h"
+#include "reconcile_transactions.h"
 
 #include <communication/connection/connection.h>
 
@@ -23,9 +26,12 @@ Packet_ptr Packet::load(Serializer& s, uint32_t id)
         {FirstPacket::TYPE, [] { return std::make_shared<FirstPacket>(); }},
         {GetBlockHeaderPacket::TYPE, [] { return std::make_shared<GetBlockHeaderPacket>(); }},
         {GetBlockPacket::TYPE, [] { return std::make_shared<GetBlockPacket>(); }},
+        {GetBlockTransactionsPacket::TYPE, [] { return std::make_shared<GetBlockTransactionsPacket>(); }},
+        {GetCompactBlockPacket::TYPE, [] { return std::make_shared<GetCompactBlockPacket>(); }},
         {GetNewTransactionsPacket::TYPE, [] { return std::make_shared<GetNewTransactionsPacket>(); }},
         {NewBlocksPacket::TYPE, [] { return std::make_shared<NewBlocksPacket>(); }},
         {NewTransactionsPacket::TYPE, [] { return std::make_shared<NewTransactionsPacket>(); }},
+        {ReconcileTransactionsPacket::TYPE, [] { return std::make_shared<ReconcileTransactionsPacket>(); }},
     };
 
     ASSERT(packetSerializers.count(0x00) == 0); // packet 0x00 is reserved
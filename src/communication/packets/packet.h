@@ -14,6 +14,13 @@ class PacketExecutionException : public Exception {
 
 #define THROW_PACKET_EXCEPTION(message) THROW_EXCEPTION(PacketExecutionException(message))
 
+// priority class of packet in send queue, packets with lower value are sent first
+enum class PacketPriority : uint8_t {
+    CONSENSUS, // block headers and new blocks
+    BLOCK_DATA, // parts of pending blocks
+    TRANSACTIONS // transactions gossip
+};
+
 class Packet : public std::enable_shared_from_this<Packet> {
 protected:
     explicit Packet(uint8_t type);
@@ -47,6 +54,12 @@ public:
         return false;
     }
 
+    // request and response of packet are sent with this priority
+    virtual PacketPriority getPriority() const
+    {
+        return PacketPriority::CONSENSUS;
+    }
+
     // true after serializeResponse is called
     bool hasResponse() const
     {
@@ -0,0 +1,148 @@
+#include "pch.h"
+#include "reconcile_transactions.h"
+
+#include <communication/session.h>
+
+namespace logpass {
+
+Packet_ptr ReconcileTransactionsPacket::create(const std::set<TransactionId>& transactionIds,
+                                               size_t expectedDifference)
+{
+    ASSERT(!transactionIds.empty() && transactionIds.size() <= MAX_TRANSACTION_IDS);
+
+    auto packet = std::make_shared<ReconcileTransactionsPacket>();
+    packet->m_localTransactionIds = transactionIds;
+    packet->m_salt = ShortTransactionIds::generateSalt();
+    packet->m_setSize = transactionIds.size();
+    packet->m_sketch = TransactionSketch(TransactionSketch::getCells(expectedDifference));
+    for (auto& transactionId : transactionIds) {
+        packet->m_sketch.add(ShortTransactionIds::calculateValue(packet->m_salt, transactionId));
+    }
+    return packet;
+}
+
+void ReconcileTransactionsPacket::serializeRequestBody(Serializer& s)
+{
+    s(m_salt);
+    s(m_setSize);
+    s(m_sketch);
+}
+
+void ReconcileTransactionsPacket::serializeResponseBody(Serializer& s)
+{
+    s(m_failed);
+    s(m_remoteSetSize);
+    s(m_transactionIds);
+    s(m_requestedShortTransactionIds);
+}
+
+bool ReconcileTransactionsPacket::validateRequest()
+{
+    return m_sketch.isValid();
+}
+
+bool ReconcileTransactionsPacket::validateResponse()
+{
+    if (m_transactionIds.size() > MAX_TRANSACTION_IDS) {
+        return false;
+    }
+    if (m_requestedShortTransactionIds.size() > MAX_TRANSACTION_IDS) {
+        return false;
+    }
+    if (m_failed && !m_requestedShortTransactionIds.empty()) {
+        return false;
+    }
+    for (auto& transactionId : m_transactionIds) {
+        if (transactionId.getSize() == 0 || transactionId.getSize() > kTransactionMaxSize) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void ReconcileTransactionsPacket::executeRequest(const PacketExecutionParams& params)
+{
+    auto& transactionIds = params.sessionData->reconciliationTransactionIds;
+    m_remoteSetSize = transactionIds.size();
+
+    TransactionSketch sketch(m_sketch.size());
+    for (auto& transactionId : transactionIds) {
+        sketch.add(ShortTransactionIds::calculateValue(m_salt, transactionId));
+    }
+    m_sketch.subtract(sketch);
+
+    // ids added to sketch are in requester set only, removed ones are in local set only
+    std::vector<uint64_t> added, removed;
+    if (!m_sketch.decode(added, removed) || added.size() > MAX_TRANSACTION_IDS ||
+        removed.size() > MAX_TRANSACTION_IDS) {
+        // fall back to flooding
+        m_failed = true;
+        params.sessionData->failedReconciliations += 1;
+        while (!transactionIds.empty() && m_transactionIds.size() < MAX_TRANSACTION_IDS) {
+            m_transactionIds.insert(transactionIds.extract(transactionIds.begin()));
+        }
+        return;
+    }
+
+    ShortTransactionIds shortTransactionIds(m_salt);
+    shortTransactionIds.addTransactionIds(transactionIds);
+    for (uint64_t shortTransactionId : removed) {
+        auto transactionId = shortTransactionIds.getTransactionId(shortTransactionId);
+        if (transactionId) {
+            m_transactionIds.insert(*transactionId);
+        }
+    }
+    for (uint64_t shortTransactionId : added) {
+        m_requestedShortTransactionIds.push_back(ShortTransactionIds::toShortTransactionId(shortTransactionId));
+    }
+
+    // remaining ids are known by both sides
+    params.sessionData->reconciliations += 1;
+    transactionIds.clear();
+}
+
+void ReconcileTransactionsPacket::executeResponse(const PacketExecutionParams& params)
+{
+    auto& data = *params.sessionData;
+    data.reconcilingTransactions = false;
+    data.remoteReconciliationSetSize = m_remoteSetSize;
+    for (auto& transactionId : m_localTransactionIds) {
+        data.reconciliationTransactionIds.erase(transactionId);
+    }
+
+    if (m_failed) {
+        // remote set is in response, local one must be flooded
+        data.failedReconciliations += 1;
+        data.reconciliationDifferenceRatio = std::min(data.reconciliationDifferenceRatio * 2 + 0.1, 1.0);
+        params.session->sendNewTransactionIds(m_localTransactionIds);
+    } else {
+        ShortTransactionIds shortTransactionIds(m_salt);
+        shortTransactionIds.addTransactionIds(m_localTransactionIds);
+        std::set<TransactionId> requestedTransactionIds;
+        for (auto& shortTransactionId : m_requestedShortTransactionIds) {
+            auto transactionId = shortTransactionIds.getTransactionId(shortTransactionId);
+            if (transactionId) {
+                requestedTransactionIds.insert(*transactionId);
+            }
+        }
+        if (!requestedTransactionIds.empty()) {
+            params.session->sendNewTransactionIds(requestedTransactionIds);
+        }
+
+        // update ratio of difference to smaller set, used to estimate size of next sketch
+        data.reconciliations += 1;
+        size_t minSetSize = std::min<size_t>(m_setSize, m_remoteSetSize);
+        size_t setSizeDifference = std::max<size_t>(m_setSize, m_remoteSetSize) - minSetSize;
+        size_t difference = m_transactionIds.size() + m_requestedShortTransactionIds.size();
+        if (minSetSize > 0 && difference >= setSizeDifference) {
+            data.reconciliationDifferenceRatio = std::clamp((double)(difference - setSizeDifference) / minSetSize,
+                                                            0.0, 1.0);
+        }
+    }
+
+    if (!m_transactionIds.empty()) {
+        params.session->onNewTransactionIds(m_transactionIds);
+    }
+}
+
+}
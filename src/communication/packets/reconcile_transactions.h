@@ -0,0 +1,50 @@
+#pragma once
+
+#include "packet.h"
+#include <crypto/short_transaction_ids.h>
+#include <communication/transaction_sketch.h>
+
+namespace logpass {
+
+// packet used to reconcile sets of not announced transaction ids with peer instead of flooding them
+// request contains sketch of local set, response contains ids missing in local set and short ids missing in remote set
+class ReconcileTransactionsPacket : public PacketWithResponse {
+public:
+    static constexpr uint8_t TYPE = 0x0C;
+    static constexpr size_t MAX_TRANSACTION_IDS = 16'384;
+
+    ReconcileTransactionsPacket() : PacketWithResponse(TYPE) {}
+
+    PacketPriority getPriority() const override
+    {
+        return PacketPriority::TRANSACTIONS;
+    }
+
+    static Packet_ptr create(const std::set<TransactionId>& transactionIds, size_t expectedDifference);
+
+protected:
+    void serializeRequestBody(Serializer& s) override;
+    void serializeResponseBody(Serializer& s) override;
+
+    bool validateRequest() override;
+    bool validateResponse() override;
+
+    void executeRequest(const PacketExecutionParams& params) override;
+    void executeResponse(const PacketExecutionParams& params) override;
+
+protected:
+    std::set<TransactionId> m_localTransactionIds;
+
+    // request
+    uint64_t m_salt;
+    uint32_t m_setSize;
+    TransactionSketch m_sketch;
+
+    // response, on failure contains remote set instead of difference
+    bool m_failed = false;
+    uint32_t m_remoteSetSize = 0;
+    std::set<TransactionId> m_transactionIds;
+    std::vector<ShortTransactionId> m_requestedShortTransactionIds;
+};
+
+}
@@ -4,17 +4,23 @@
 #include "packets/first_packet.h"
 #include "packets/get_block_header.h"
 #include "packets/get_block.h"
+#include "packets/get_compact_block.h"
 #include "packets/get_new_transactions.h"
 #include "packets/new_blocks.h"
 #include "packets/new_transactions.h"
+#include "packets/reconcile_transactions.h"
 
 namespace logpass {
 
 Session::Session(const MinerId& minerId, const std::shared_ptr<Blockchain>& blockchain,
-                 const std::shared_ptr<const Database>& database) :
-    m_minerId(minerId), m_blockchain(blockchain), m_database(database)
+                 const std::shared_ptr<const Database>& database,
+                 const std::shared_ptr<TransactionRequests>& transactionRequests,
+                 const std::shared_ptr<BlockDownloader>& blockDownloader) :
+    m_minerId(minerId), m_blockchain(blockchain), m_database(database), m_transactionRequests(transactionRequests),
+    m_blockDownloader(blockDownloader)
 {
     ASSERT(m_minerId.isValid() && m_blockchain != nullptr && m_database != nullptr);
+    ASSERT(m_transactionRequests != nullptr && m_blockDownloader != nullptr);
     m_logger.add_attribute("Class", boost::log::attributes::constant<std::string>("Session"));
     m_logger.add_attribute("ID", boost::log::attributes::constant<std::string>(minerId.toString()));
 }
@@ -35,6 +41,8 @@ void Session::onDisconnected()
 {
     ASSERT(m_connection != nullptr);
     m_connection = nullptr;
+    m_transactionRequests->cancel(m_minerId);
+    m_blockDownloader->cancel(m_minerId);
 }
 
 bool Session::onPacket(const Packet_ptr& packet)
@@ -96,12 +104,12 @@ void Session::onBlocks(const std::vector<Block_cptr>& blocks, bool didChangeBran
         sendFirstPendingTransactions();
     }
 
-    if (!m_data.requestingTransactions && !m_data.recivedNewTransactionIds.empty()) {
+    if (!m_data.recivedNewTransactionIds.empty()) {
         requestNewTransactions();
     }
 }
 
-void Session::onNewTransactions(const std::vector<Transaction_cptr>& transactions)
+void Session::onNewTransactions(const std::vector<Transaction_cptr>& transactions, bool flooding)
 {
     ASSERT(m_connection != nullptr);
     LOG_CLASS(trace) << "onPendingTransactions " << transactions.size();
@@ -115,6 +123,11 @@ void Session::onNewTransactions(const std::vector<Transaction_cptr>& transaction
             continue;
         }
 
+        if (!flooding && m_data.reconciliationTransactionIds.size() < MAX_RECONCILIATION_TRANSACTION_IDS) {
+            m_data.reconciliationTransactionIds.insert(transaction->getId());
+            continue;
+        }
+
         m_data.newTransactionIds.insert(transaction->getId());
         if (m_data.newTransactionIds.size() == NewTransactionsPacket::MAX_TRANSACTION_IDS) {
             sendNewTransactionIds(m_data.newTransactionIds);
@@ -141,6 +154,17 @@ void Session::onPeriodicalCheck()
         }
     }
 
+    // retry transactions which were requested from other peers
+    if (!m_data.recivedNewTransactionIds.empty()) {
+        requestNewTransactions();
+    }
+
+    // parts of waiting block could be downloaded or timed out in other sessions
+    if (m_data.waitingBlock) {
+        continueBlock(std::exchange(m_data.waitingBlock, nullptr));
+    }
+    helpDownloadBlock();
+
     if (m_data.requestingBlock) {
         return;
     }
@@ -153,6 +177,10 @@ void Session::onPeriodicalCheck()
         sendNewTransactionIds(m_data.newTransactionIds);
         m_data.newTransactionIds.clear();
     }
+
+    if (!m_data.reconcilingTransactions && !m_data.reconciliationTransactionIds.empty()) {
+        reconcileTransactions();
+    }
 }
 
 void Session::onFirstPacket(const BlockHeader_cptr& lastBlockHeader)
@@ -210,24 +238,52 @@ void Session::onNewTransactionIds(const std::set<TransactionId>& transactionIds)
 {
     LOG_CLASS(trace) << "onNewTransactionIds " << transactionIds.size();
 
+    // peer knows these transactions, so they don't have to be announced back
+    for (auto& transactionId : transactionIds) {
+        m_sharedTransactionIds.addTransactionId(transactionId);
+        m_data.reconciliationTransactionIds.erase(transactionId);
+    }
+
     m_data.recivedNewTransactionIds.insert(transactionIds.begin(), transactionIds.end());
-    if (!m_data.requestingTransactions && !m_data.recivedNewTransactionIds.empty())
+    if (!m_data.recivedNewTransactionIds.empty())
         requestNewTransactions();
 }
 
 void Session::onTransactions(const std::map<TransactionId, Transaction_cptr>& transactionsMap)
 {
-    ASSERT(m_data.requestingTransactions);
+    ASSERT(!m_data.transactionsRequests.empty());
     LOG_CLASS(trace) << "onTransactions " << transactionsMap.size();
 
-    m_data.requestingTransactions = false;
+    std::vector<TransactionId> transactionIds;
     std::vector<Transaction_cptr> transactions;
+    size_t transactionsSize = 0;
     for (auto& [transactionId, transaction] : transactionsMap) {
+        transactionIds.push_back(transactionId);
         if (!transaction)
             continue;
         transactions.push_back(transaction);
+        transactionsSize += transactionId.getSize();
     }
     m_blockchain->addTransactions({ transactions }, m_minerId);
+    // transactions which were not delivered can be requested from other peers
+    m_transactionRequests->finish(transactionIds, m_minerId);
+
+    // update rtt and delivery rate, they are used to calculate size of transactions window
+    auto request = m_data.transactionsRequests.front();
+    m_data.transactionsRequests.pop_front();
+    m_data.requestingTransactionsSize -= request.size;
+    m_data.deliveredTransactionsSize += transactionsSize;
+    auto now = chrono::steady_clock::now();
+    auto rtt = chrono::duration_cast<chrono::microseconds>(now - request.time);
+    double deliveryRate = (m_data.deliveredTransactionsSize - request.deliveredSize) /
+        std::max(chrono::duration<double>(rtt).count(), 0.001);
+    if (m_data.transactionsRtt.count() == 0) {
+        m_data.transactionsRtt = rtt;
+        m_data.transactionsBandwidth = deliveryRate;
+    } else {
+        m_data.transactionsRtt = (m_data.transactionsRtt * 7 + rtt) / 8;
+        m_data.transactionsBandwidth = (m_data.transactionsBandwidth * 3 + deliveryRate) / 4;
+    }
 
     if (!m_data.recivedNewTransactionIds.empty())
         requestNewTransactions();
@@ -311,6 +367,17 @@ void Session::onInvalidBlock(const PendingBlock_ptr& pendingBlock)
     THROW_EXCEPTION(SessionException("invalid block"));
 }
 
+void Session::onMismatchedTransactionIds(const PendingBlock_ptr& pendingBlock, const std::vector<uint32_t>& chunks)
+{
+    m_data.mismatchedTransactionIdsChunks += chunks.size();
+    LOG_CLASS(warning) << "Mismatched " << chunks.size() << " transaction ids chunks of block "
+        << pendingBlock->toString() << ", total: " << m_data.mismatchedTransactionIdsChunks;
+    if (m_data.mismatchedTransactionIdsChunks > MAX_MISMATCHED_TRANSACTION_IDS_CHUNKS) {
+        m_data.requestingBlock = false;
+        THROW_EXCEPTION(SessionException("too many mismatched transaction ids chunks"));
+    }
+}
+
 void Session::onExpiredBlock(const PendingBlock_ptr& pendingBlock, bool localExpiration)
 {
     ASSERT(m_data.requestingBlock);
@@ -324,6 +391,27 @@ void Session::onExpiredBlock(const PendingBlock_ptr& pendingBlock, bool localExp
     }
 }
 
+void Session::onBlockPart(const BlockDownloadAssignment& assignment, size_t size,
+                          chrono::steady_clock::duration duration, bool succeeded)
+{
+    m_blockDownloader->finish(assignment, m_minerId, size, duration, succeeded);
+}
+
+void Session::onHelperBlockPart(const BlockDownloadAssignment& assignment, size_t size,
+                                chrono::steady_clock::duration duration, bool succeeded)
+{
+    ASSERT(m_data.helpingBlock);
+    m_data.helpingBlock = false;
+    m_blockDownloader->finish(assignment, m_minerId, size, duration, succeeded);
+
+    if (m_data.waitingBlock) {
+        continueBlock(std::exchange(m_data.waitingBlock, nullptr));
+    }
+    if (succeeded) {
+        helpDownloadBlock();
+    }
+}
+
 void Session::sendFirstPendingTransactions()
 {
     ASSERT(!m_data.sharedPendingTransactions);
@@ -358,7 +446,6 @@ void Session::sendNewTransactionIds(const std::set<TransactionId>& transactionId
 
 void Session::requestNewTransactions()
 {
-    ASSERT(!m_data.requestingTransactions);
     ASSERT(!m_data.recivedNewTransactionIds.empty());
     LOG_CLASS(debug) << "Requesting transactions";
 
@@ -367,27 +454,91 @@ void Session::requestNewTransactions()
         return;
     }
 
+    // keeps up to window bytes of transactions requested, split into multiple requests
+    size_t window = getTransactionsWindow();
+    size_t requestLimit = std::clamp(window / MAX_TRANSACTIONS_REQUESTS, kTransactionMaxSize,
+                                     GetNewTransactionsPacket::MAX_TRANSACTIONS_SIZE);
     size_t transactionsSize = 0;
     std::set<TransactionId> transactionIds;
     for (auto it = m_data.recivedNewTransactionIds.begin(); it != m_data.recivedNewTransactionIds.end(); ) {
-        if (transactionsSize + it->getSize() > kTransactionMaxSize)
+        if (!transactionIds.empty() && (transactionsSize + it->getSize() > requestLimit ||
+                                        transactionIds.size() == GetNewTransactionsPacket::MAX_TRANSACTIONS)) {
+            sendTransactionsRequest(transactionIds, transactionsSize);
+            transactionIds.clear();
+            transactionsSize = 0;
+        }
+        if (m_data.transactionsRequests.size() == MAX_TRANSACTIONS_REQUESTS) {
             break;
-        if (!m_blockchain->getTransaction(*it).first) {
-            transactionIds.insert(*it);
-            transactionsSize += it->getSize();
         }
+        bool isIdle = m_data.transactionsRequests.empty() && transactionIds.empty();
+        if (!isIdle && m_data.requestingTransactionsSize + transactionsSize + it->getSize() > window) {
+            break;
+        }
+        if (m_blockchain->getTransaction(*it).first) {
+            it = m_data.recivedNewTransactionIds.erase(it);
+            continue;
+        }
+        if (!m_transactionRequests->request(*it, m_minerId)) {
+            // transaction is requested from other peer, it will be requested again if it's not delivered
+            ++it;
+            continue;
+        }
+        transactionIds.insert(*it);
+        transactionsSize += it->getSize();
         it = m_data.recivedNewTransactionIds.erase(it);
     }
 
-    if (transactionIds.empty())
-        return;
+    if (!transactionIds.empty()) {
+        sendTransactionsRequest(transactionIds, transactionsSize);
+    }
+}
 
+void Session::sendTransactionsRequest(const std::set<TransactionId>& transactionIds, size_t transactionsSize)
+{
+    ASSERT(!transactionIds.empty() && m_data.transactionsRequests.size() < MAX_TRANSACTIONS_REQUESTS);
     LOG_CLASS(debug) << "Requesting (" << transactionIds.size() << ") transactions with size " << transactionsSize;
-    m_data.requestingTransactions = true;
+
+    m_data.transactionsRequests.push_back(TransactionsRequest{
+        .size = transactionsSize,
+        .time = chrono::steady_clock::now(),
+        .deliveredSize = m_data.deliveredTransactionsSize
+    });
+    m_data.requestingTransactionsSize += transactionsSize;
     auto packet = GetNewTransactionsPacket::create(transactionIds);
     m_connection->send(packet);
 }
 
+size_t Session::getTransactionsWindow() const
+{
+    // bandwidth-delay product with margin for growth of bandwidth
+    double window = m_data.transactionsBandwidth * chrono::duration<double>(m_data.transactionsRtt).count() * 2;
+    return std::clamp((size_t)window, MIN_TRANSACTIONS_WINDOW, MAX_TRANSACTIONS_WINDOW);
+}
+
+void Session::reconcileTransactions()
+{
+    ASSERT(!m_data.reconcilingTransactions && !m_data.reconciliationTransactionIds.empty());
+
+    std::set<TransactionId> transactionIds;
+    for (auto& transactionId : m_data.reconciliationTransactionIds) {
+        transactionIds.insert(transactionId);
+        if (transactionIds.size() == ReconcileTransactionsPacket::MAX_TRANSACTION_IDS) {
+            break;
+        }
+    }
+
+    // expected difference is estimated from sizes of both sets and result of previous reconciliation
+    size_t minSetSize = std::min(transactionIds.size(), m_data.remoteReconciliationSetSize);
+    size_t maxSetSize = std::max(transactionIds.size(), m_data.remoteReconciliationSetSize);
+    size_t expectedDifference = maxSetSize - minSetSize +
+        (size_t)(minSetSize * m_data.reconciliationDifferenceRatio) + 1;
+
+    LOG_CLASS(trace) << "Reconciling " << transactionIds.size() << " transaction ids, expected difference " <<
+        expectedDifference;
+    m_data.reconcilingTransactions = true;
+    m_connection->send(ReconcileTransactionsPacket::create(transactionIds, expectedDifference));
+}
+
 void Session::requestBlockHeader()
 {
     ASSERT(!m_data.requestingBlock);
@@ -431,9 +582,57 @@ void Session::requestBlock(const PendingBlock_ptr& pendingBlock)
         return;
     }
 
-    auto getPendingBlockPacket = GetBlockPacket::create(pendingBlockStatus, pendingBlock);
+    // other sessions can download parts of block once its body is known
+    m_blockDownloader->addPendingBlock(pendingBlock);
     m_data.requestingBlock = true;
-    m_connection->send(getPendingBlockPacket);
+    continueBlock(pendingBlock);
+}
+
+void Session::continueBlock(const PendingBlock_ptr& pendingBlock)
+{
+    ASSERT(m_data.requestingBlock && !m_data.waitingBlock);
+
+    auto pendingBlockStatus = pendingBlock->getStatus();
+    if (pendingBlockStatus == PendingBlock::Status::INVALID) {
+        return onInvalidBlock(pendingBlock);
+    } else if (pendingBlockStatus == PendingBlock::Status::EXPIRED) {
+        return onExpiredBlock(pendingBlock, true);
+    } else if (pendingBlockStatus == PendingBlock::Status::COMPLETE ||
+               pendingBlockStatus == PendingBlock::Status::FINISHED) {
+        return onCompletedBlock(pendingBlock);
+    }
+
+    // body is requested with short transaction ids to rebuild block from pending transactions
+    if (pendingBlockStatus == PendingBlock::Status::MISSING_BODY) {
+        return m_connection->send(GetCompactBlockPacket::create(
+            pendingBlock, m_blockchain->getPendingTransactions().getShortTransactionIdsSalt()));
+    }
+
+    // remaining parts are split between this and helping sessions, in endgame parts are requested again
+    auto assignment = m_blockDownloader->assign(pendingBlock, m_minerId, true);
+    if (!assignment) {
+        // all missing parts are requested from this peer by helper request
+        LOG_CLASS(trace) << "Waiting for parts of block (" << pendingBlock->toString() << ")";
+        m_data.waitingBlock = pendingBlock;
+        return;
+    }
+    m_connection->send(GetBlockPacket::create(*assignment));
+}
+
+void Session::helpDownloadBlock()
+{
+    if (m_firstPacket || m_data.helpingBlock || !m_data.lastBlockHeader) {
+        return;
+    }
+
+    // peer can only have blocks which aren't deeper than its last block
+    auto assignment = m_blockDownloader->assign(m_data.lastBlockHeader->getDepth(), m_minerId);
+    if (!assignment) {
+        return;
+    }
+    LOG_CLASS(trace) << "Helping to download block (" << assignment->pendingBlock->toString() << ")";
+    m_data.helpingBlock = true;
+    m_connection->send(GetBlockPacket::create(*assignment, true));
 }
 
 json Session::getDebugInfo() const
@@ -442,10 +641,20 @@ json Session::getDebugInfo() const
     j["local_block_header"] = m_latestBlockHeader ? m_latestBlockHeader->getId() : 0;
     j["remote_block_header"] = m_data.lastBlockHeader ? m_data.lastBlockHeader->getId() : 0;
     j["requesting_block"] = m_data.requestingBlock;
-    j["requesting_transactions"] = m_data.requestingTransactions;
+    j["waiting_block"] = m_data.waitingBlock ? m_data.waitingBlock->toString() : "";
+    j["helping_block"] = m_data.helpingBlock;
+    j["requesting_transactions"] = m_data.transactionsRequests.size();
+    j["requesting_transactions_size"] = m_data.requestingTransactionsSize;
+    j["transactions_rtt"] = m_data.transactionsRtt.count();
+    j["transactions_bandwidth"] = (uint64_t)m_data.transactionsBandwidth;
+    j["transactions_window"] = getTransactionsWindow();
     j["waiting_for_new_block"] = m_data.waitingForNewBlock;
     j["shared_pending_transactions"] = m_data.sharedPendingTransactions;
     j["last_recived_block_hash"] = m_data.lastRecivedBlockHash;
+    j["reconciliation_transaction_ids"] = m_data.reconciliationTransactionIds.size();
+    j["reconciliations"] = m_data.reconciliations;
+    j["failed_reconciliations"] = m_data.failedReconciliations;
+    j["mismatched_transaction_ids_chunks"] = m_data.mismatchedTransactionIdsChunks;
     return j;
 }
 
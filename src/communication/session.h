@@ -3,10 +3,12 @@
 #include <blockchain/blockchain.h>
 #include <database/database.h>
 
+#include "block_downloader.h"
 #include "connection/connection.h"
 #include "packets/packet.h"
 #include "session_data.h"
 #include "shared_transaction_ids.h"
+#include "transaction_requests.h"
 
 namespace logpass {
 
@@ -14,11 +16,22 @@ class SessionException : public Exception {
     using Exception::Exception;
 };
 
-// not thread-safe
+// not thread-safe, all functions must be called on strand of session connection
 class Session {
 public:
+    // limit of transaction ids waiting for reconciliation, above it transaction ids are flooded
+    static constexpr size_t MAX_RECONCILIATION_TRANSACTION_IDS = 65'536;
+    // limits of pipelined transactions requests
+    static constexpr size_t MAX_TRANSACTIONS_REQUESTS = 8;
+    static constexpr size_t MIN_TRANSACTIONS_WINDOW = kTransactionMaxSize;
+    static constexpr size_t MAX_TRANSACTIONS_WINDOW = 4 * (kNetworkMaxPacketSize - 1024);
+    // limit of chunks rebuilt from short ids and transactions of peer with wrong hash, above it peer is disconnected
+    static constexpr size_t MAX_MISMATCHED_TRANSACTION_IDS_CHUNKS = 16;
+
     Session(const MinerId& minerId, const std::shared_ptr<Blockchain>& blockchain,
-            const std::shared_ptr<const Database>& database);
+            const std::shared_ptr<const Database>& database,
+            const std::shared_ptr<TransactionRequests>& transactionRequests,
+            const std::shared_ptr<BlockDownloader>& blockDownloader);
     Session(const Session&) = delete;
     Session& operator=(const Session&) = delete;
 
@@ -26,7 +39,8 @@ public:
     void onDisconnected();
     bool onPacket(const Packet_ptr& packet);
     void onBlocks(const std::vector<Block_cptr>& blocks, bool didChangeBranch);
-    void onNewTransactions(const std::vector<Transaction_cptr>& transactions);
+    // new transaction ids are flooded to peer or added to set reconciled periodically with peer
+    void onNewTransactions(const std::vector<Transaction_cptr>& transactions, bool flooding = true);
     void onPeriodicalCheck();
 
     void onFirstPacket(const BlockHeader_cptr& lastBlockHeader);
@@ -37,24 +51,46 @@ public:
     void onCompletedBlock(const PendingBlock_ptr& pendingBlock);
     void onInvalidBlock(const PendingBlock_ptr& pendingBlock);
     void onExpiredBlock(const PendingBlock_ptr& pendingBlock, bool localExpiration);
+    // chunks of block transaction ids rebuilt from transactions sent by peer have wrong hash
+    void onMismatchedTransactionIds(const PendingBlock_ptr& pendingBlock, const std::vector<uint32_t>& chunks);
+    void onBlockPart(const BlockDownloadAssignment& assignment, size_t size, chrono::steady_clock::duration duration,
+                     bool succeeded);
+    void onHelperBlockPart(const BlockDownloadAssignment& assignment, size_t size,
+                           chrono::steady_clock::duration duration, bool succeeded);
 
     void sendFirstPendingTransactions();
     void sendNewTransactionIds(const std::set<TransactionId>& transactionIds);
     void requestNewTransactions();
+    void sendTransactionsRequest(const std::set<TransactionId>& transactionIds, size_t transactionsSize);
+    void reconcileTransactions();
     void requestBlockHeader();
     void requestBlock(const PendingBlock_ptr& pendingBlock);
+    // requests next part of requested block
+    void continueBlock(const PendingBlock_ptr& pendingBlock);
+    // requests part of block requested by other session
+    void helpDownloadBlock();
 
     MinerId getMiner() const
     {
         return m_minerId;
     }
 
+    bool isConnected() const
+    {
+        return m_connection != nullptr;
+    }
+
     json getDebugInfo() const;
 
 private:
+    // returns size of transactions which can be requested at the same time
+    size_t getTransactionsWindow() const;
+
     const MinerId m_minerId;
     const std::shared_ptr<Blockchain> m_blockchain;
     const std::shared_ptr<const Database> m_database;
+    const std::shared_ptr<TransactionRequests> m_transactionRequests;
+    const std::shared_ptr<BlockDownloader> m_blockDownloader;
     Connection* m_connection = nullptr;
 
     mutable Logger m_logger;
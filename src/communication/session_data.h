@@ -1,19 +1,45 @@
 #pragma once
 
 #include <blockchain/block/block_header.h>
+#include <blockchain/block/pending_block.h>
 
 namespace logpass {
 
+// transactions request sent to peer, responses come in the same order as requests
+struct TransactionsRequest {
+    size_t size = 0;
+    chrono::steady_clock::time_point time;
+    uint64_t deliveredSize = 0; // size of transactions delivered before request was sent
+};
+
 struct SessionData {
     BlockHeader_cptr lastBlockHeader = nullptr;
     chrono::steady_clock::time_point lastBlockHeaderTime;
     bool requestingBlock = false;
-    bool requestingTransactions = false;
+    // requested block which waits for parts downloaded by other sessions
+    PendingBlock_ptr waitingBlock = nullptr;
+    // parts of block requested by other session are downloaded
+    bool helpingBlock = false;
     bool sharedPendingTransactions = false;
     bool waitingForNewBlock = false;
     Hash lastRecivedBlockHash;
     std::set<TransactionId> newTransactionIds;
     std::set<TransactionId> recivedNewTransactionIds;
+    // pipelined transactions requests
+    std::deque<TransactionsRequest> transactionsRequests;
+    size_t requestingTransactionsSize = 0;
+    uint64_t deliveredTransactionsSize = 0;
+    chrono::microseconds transactionsRtt = chrono::microseconds(0);
+    double transactionsBandwidth = 0; // in bytes per second
+    // transactions reconciliation
+    bool reconcilingTransactions = false;
+    std::set<TransactionId> reconciliationTransactionIds;
+    size_t remoteReconciliationSetSize = 0;
+    double reconciliationDifferenceRatio = 0.25;
+    size_t reconciliations = 0;
+    size_t failedReconciliations = 0;
+    // chunks of block transaction ids rebuilt from transactions sent by peer with wrong hash
+    size_t mismatchedTransactionIdsChunks = 0;
 };
 
 }
@@ -0,0 +1,49 @@
+#include "pch.h"
+
+#include "transaction_requests.h"
+
+namespace logpass {
+
+bool TransactionRequests::request(const TransactionId& transactionId, const MinerId& minerId)
+{
+    auto now = chrono::steady_clock::now();
+    std::lock_guard lock(m_mutex);
+    auto [it, inserted] = m_requests.emplace(transactionId, Request{ .minerId = minerId, .time = now });
+    if (inserted) {
+        return true;
+    }
+    if (it->second.minerId != minerId && it->second.time + REQUEST_TIMEOUT > now) {
+        return false;
+    }
+    it->second = Request{ .minerId = minerId, .time = now };
+    return true;
+}
+
+void TransactionRequests::finish(const std::vector<TransactionId>& transactionIds, const MinerId& minerId)
+{
+    std::lock_guard lock(m_mutex);
+    for (auto& transactionId : transactionIds) {
+        auto it = m_requests.find(transactionId);
+        if (it != m_requests.end() && it->second.minerId == minerId) {
+            m_requests.erase(it);
+        }
+    }
+}
+
+void TransactionRequests::cancel(const MinerId& minerId)
+{
+    std::lock_guard lock(m_mutex);
+    std::erase_if(m_requests, [&](auto& request) {
+        return request.second.minerId == minerId;
+    });
+}
+
+json TransactionRequests::getDebugInfo() const
+{
+    std::lock_guard lock(m_mutex);
+    return {
+        {"requested_transactions", m_requests.size()}
+    };
+}
+
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+namespace logpass {
+
+// tracks transactions requested from peers, so missing transaction is requested only from one of peers
+// which announced it at the same time, thread-safe
+class TransactionRequests {
+public:
+    // time after which transaction can be requested from another peer
+    static constexpr chrono::seconds REQUEST_TIMEOUT = chrono::seconds(5);
+
+    TransactionRequests() = default;
+    TransactionRequests(const TransactionRequests&) = delete;
+    TransactionRequests& operator=(const TransactionRequests&) = delete;
+
+    // returns true and marks transaction as requested from given miner if it's not requested from other miner
+    bool request(const TransactionId& transactionId, const MinerId& minerId);
+
+    // removes requests of given transactions made to given miner
+    void finish(const std::vector<TransactionId>& transactionIds, const MinerId& minerId);
+
+    // removes all requests made to given miner
+    void cancel(const MinerId& minerId);
+
+    json getDebugInfo() const;
+
+private:
+    struct Request {
+        MinerId minerId;
+        chrono::steady_clock::time_point time;
+    };
+
+    mutable std::mutex m_mutex;
+    std::map<TransactionId, Request> m_requests;
+};
+
+}
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <crypto/short_transaction_ids.h>
+
+namespace logpass {
+
+// invertible bloom lookup table of short transaction ids, not thread-safe
+// after subtracting sketch of other set it can be decoded to ids which are in only one of sets,
+// decoding usually succeeds when difference is smaller than 2/3 of cells
+class TransactionSketch {
+    struct Cell {
+        uint32_t count = 0;
+        uint64_t keySum = 0;
+        uint32_t checkSum = 0;
+
+        void serialize(Serializer& s)
+        {
+            s(count);
+            s(keySum);
+            s(checkSum);
+        }
+
+        bool isEmpty() const
+        {
+            return count == 0 && keySum == 0 && checkSum == 0;
+        }
+    };
+
+public:
+    static constexpr size_t HASH_FUNCTIONS = 3;
+    static constexpr size_t MIN_CELLS = 8 * HASH_FUNCTIONS;
+    static constexpr size_t MAX_CELLS = 8192 * HASH_FUNCTIONS;
+
+    TransactionSketch() = default;
+    TransactionSketch(size_t cells)
+    {
+        cells = std::clamp(cells, MIN_CELLS, MAX_CELLS);
+        m_cells.resize((cells + HASH_FUNCTIONS - 1) / HASH_FUNCTIONS * HASH_FUNCTIONS);
+    }
+
+    // returns number of cells required to decode given difference
+    static size_t getCells(size_t expectedDifference)
+    {
+        return std::clamp(expectedDifference * 3 / 2 + MIN_CELLS, MIN_CELLS, MAX_CELLS);
+    }
+
+    void add(uint64_t shortTransactionId)
+    {
+        update(m_cells, shortTransactionId, 1);
+    }
+
+    void subtract(const TransactionSketch& other)
+    {
+        ASSERT(m_cells.size() == other.m_cells.size());
+        for (size_t i = 0; i < m_cells.size(); ++i) {
+            m_cells[i].count -= other.m_cells[i].count;
+            m_cells[i].keySum ^= other.m_cells[i].keySum;
+            m_cells[i].checkSum ^= other.m_cells[i].checkSum;
+        }
+    }
+
+    // decodes difference, returns false if it's too big to be decoded
+    bool decode(std::vector<uint64_t>& added, std::vector<uint64_t>& removed) const
+    {
+        std::vector<Cell> cells = m_cells;
+        bool updated = true;
+        while (updated) {
+            updated = false;
+            for (auto& cell : cells) {
+                if (!isPure(cell)) {
+                    continue;
+                }
+                if (added.size() + removed.size() >= cells.size()) {
+                    return false;
+                }
+                uint64_t shortTransactionId = cell.keySum;
+                if (cell.count == 1) {
+                    added.push_back(shortTransactionId);
+                    update(cells, shortTransactionId, -1);
+                } else {
+                    removed.push_back(shortTransactionId);
+                    update(cells, shortTransactionId, 1);
+                }
+                updated = true;
+            }
+        }
+        return std::all_of(cells.begin(), cells.end(), [](auto& cell) { return cell.isEmpty(); });
+    }
+
+    void serialize(Serializer& s)
+    {
+        s(m_cells);
+    }
+
+    bool isValid() const
+    {
+        return m_cells.size() >= MIN_CELLS && m_cells.size() <= MAX_CELLS && m_cells.size() % HASH_FUNCTIONS == 0;
+    }
+
+    size_t size() const
+    {
+        return m_cells.size();
+    }
+
+private:
+    static uint32_t calculateCheckSum(uint64_t shortTransactionId)
+    {
+        return (uint32_t)ShortTransactionIds::mix(shortTransactionId ^ 0x5bd1e9955bd1e995ULL);
+    }
+
+    static bool isPure(const Cell& cell)
+    {
+        return (cell.count == 1 || cell.count == std::numeric_limits<uint32_t>::max()) &&
+            cell.keySum <= ShortTransactionIds::MASK && cell.checkSum == calculateCheckSum(cell.keySum);
+    }
+
+    static void update(std::vector<Cell>& cells, uint64_t shortTransactionId, int32_t count)
+    {
+        // every hash function has own part of cells, so each id is always in HASH_FUNCTIONS different cells
+        size_t partSize = cells.size() / HASH_FUNCTIONS;
+        uint32_t checkSum = calculateCheckSum(shortTransactionId);
+        for (size_t i = 0; i < HASH_FUNCTIONS; ++i) {
+            auto& cell = cells[i * partSize + ShortTransactionIds::mix(shortTransactionId + i + 1) % partSize];
+            cell.count += (uint32_t)count;
+            cell.keySum ^= shortTransactionId;
+            cell.checkSum ^= checkSum;
+        }
+    }
+
+    std::vector<Cell> m_cells;
+};
+
+}
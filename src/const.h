@@ -48,7 +48,7 @@ const size_t kStoragePrefixMaxAllowedUsers = 10;
 const size_t kStorageEntryMaxValueLength = 65000;
 
 // network
-const uint8_t kNetworkProtocolVersion = 0x01;
+const uint8_t kNetworkProtocolVersion = 0x02;
 
 const size_t kNetworkMaxPacketSize = 4 * 1024 * 1024; // 4 MB
 const size_t kNetworkConnectionTimeout = 15; // in seconds
@@ -4,6 +4,13 @@
 
 namespace logpass {
 
+// asio uses app data of SSL_CTX, so certificate is stored in separate index
+static int getCertificateIndex()
+{
+    static const int index = SSL_CTX_get_ex_new_index(0, nullptr, nullptr, nullptr, nullptr);
+    return index;
+}
+
 Certificate::Certificate(const PrivateKey& privateKey) : m_context(boost::asio::ssl::context::tlsv13)
 {
     m_pkey = privateKey.m_pkey;
@@ -25,6 +32,15 @@ Certificate::Certificate(const PrivateKey& privateKey) : m_context(boost::asio::
     SSL_CTX_use_certificate(m_context.native_handle(), m_x509);
 
     m_context.set_verify_mode(boost::asio::ssl::verify_peer | boost::asio::ssl::verify_fail_if_no_peer_cert);
+
+    // server issues stateless tickets, client sessions are stored by onNewSession instead of openssl cache
+    // session id context is required to resume sessions when peer certificate is verified
+    static const std::string_view sessionIdContext = "logpass";
+    SSL_CTX_set_session_id_context(m_context.native_handle(), (const uint8_t*)sessionIdContext.data(),
+                                   sessionIdContext.size());
+    SSL_CTX_set_ex_data(m_context.native_handle(), getCertificateIndex(), this);
+    SSL_CTX_set_session_cache_mode(m_context.native_handle(), SSL_SESS_CACHE_BOTH | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+    SSL_CTX_sess_set_new_cb(m_context.native_handle(), &Certificate::onNewSession);
 }
 
 Certificate::~Certificate()
@@ -32,4 +48,62 @@ Certificate::~Certificate()
     X509_free(m_x509);
 }
 
+std::shared_ptr<SSL_SESSION> Certificate::takeSession(const MinerId& minerId)
+{
+    std::lock_guard lock(m_sessionsMutex);
+    auto it = m_sessions.find(minerId);
+    if (it == m_sessions.end()) {
+        return nullptr;
+    }
+    auto session = std::move(it->second);
+    m_sessions.erase(it);
+    if (!SSL_SESSION_is_resumable(session.get())) {
+        return nullptr;
+    }
+    return session;
+}
+
+MinerId Certificate::getMinerId(X509* cert)
+{
+    if (!cert) {
+        return MinerId();
+    }
+
+    EVP_PKEY* key = X509_get0_pubkey(cert);
+    if (!key || EVP_PKEY_base_id(key) != EVP_PKEY_ED25519 || X509_verify(cert, key) != 1) {
+        return MinerId();
+    }
+
+    MinerId minerId;
+    size_t len = minerId.size();
+    if (EVP_PKEY_get_raw_public_key(key, minerId.data(), &len) != 1 || len != minerId.size()) {
+        return MinerId();
+    }
+    return minerId;
+}
+
+int Certificate::onNewSession(SSL* ssl, SSL_SESSION* session)
+{
+    // only client keeps sessions, tickets issued by server are stateless
+    auto certificate = static_cast<Certificate*>(SSL_CTX_get_ex_data(SSL_get_SSL_CTX(ssl), getCertificateIndex()));
+    if (SSL_is_server(ssl) || !certificate) {
+        return 0;
+    }
+
+    // certificate of peer is a part of session, so it's always stored for miner which was verified
+    MinerId minerId = getMinerId(SSL_SESSION_get0_peer(session));
+    if (!minerId.isValid()) {
+        return 0;
+    }
+
+    std::lock_guard lock(certificate->m_sessionsMutex);
+    auto& sessions = certificate->m_sessions;
+    if (sessions.size() >= MAX_SESSIONS && !sessions.contains(minerId)) {
+        sessions.erase(sessions.begin());
+    }
+    // session of connection is marked as not resumable when connection is closed without tls shutdown, so copy is kept
+    sessions[minerId] = std::shared_ptr<SSL_SESSION>(SSL_SESSION_dup(session), SSL_SESSION_free);
+    return 0;
+}
+
 }
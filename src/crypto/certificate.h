@@ -1,11 +1,17 @@
 #pragma once
 
+#include "miner_id.h"
 #include "private_key.h"
 
 namespace logpass {
 
+// tls context with self-signed certificate of miner, also keeps tls 1.3 session tickets received from other miners,
+// so reconnecting to them doesn't require full handshake, thread-safe
 class Certificate {
 public:
+    // max number of cached sessions
+    static constexpr size_t MAX_SESSIONS = 1024;
+
     Certificate(const PrivateKey& privateKey);
     ~Certificate();
 
@@ -14,10 +20,21 @@ public:
         return m_context;
     }
 
+    // returns cached session of given miner and removes it from cache, tickets are used only once
+    std::shared_ptr<SSL_SESSION> takeSession(const MinerId& minerId);
+
+    // extracts miner id from certificate of peer, returns invalid miner id if certificate is invalid
+    static MinerId getMinerId(X509* cert);
+
 private:
+    static int onNewSession(SSL* ssl, SSL_SESSION* session);
+
     boost::asio::ssl::context m_context;
     std::shared_ptr<EVP_PKEY> m_pkey;
     X509* m_x509;
+
+    std::mutex m_sessionsMutex;
+    std::map<MinerId, std::shared_ptr<SSL_SESSION>> m_sessions;
 };
 
 }
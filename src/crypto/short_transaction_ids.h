@@ -0,0 +1,115 @@
+#pragma once
+
+#include "transaction_id.h"
+
+namespace logpass {
+
+// 6 byte transaction id used by compact blocks and transactions reconciliation
+using ShortTransactionId = std::array<uint8_t, 6>;
+
+// calculates salted short transaction ids and maps them back to known transaction ids, not thread-safe
+// salt is chosen by peer which requests short ids, so sender can't craft colliding short ids
+class ShortTransactionIds {
+public:
+    // short ids are 48 bit values
+    static constexpr uint64_t MASK = (1ULL << 48) - 1;
+
+    ShortTransactionIds(uint64_t salt) : m_salt(salt) {}
+
+    static uint64_t generateSalt()
+    {
+        thread_local std::mt19937_64 generator(std::random_device{}());
+        return generator();
+    }
+
+    static ShortTransactionId calculate(uint64_t salt, const TransactionId& transactionId)
+    {
+        return toShortTransactionId(calculateValue(salt, transactionId));
+    }
+
+    // returns short id as integer
+    static uint64_t calculateValue(uint64_t salt, const TransactionId& transactionId)
+    {
+        uint64_t value = mix(salt);
+        for (size_t i = 0; i < transactionId.size(); i += 8) {
+            uint64_t word = 0;
+            for (size_t j = i; j < std::min<size_t>(i + 8, transactionId.size()); ++j) {
+                word |= (uint64_t)transactionId.data()[j] << ((j - i) * 8);
+            }
+            value = mix(value ^ word);
+        }
+        return value & MASK;
+    }
+
+    // splitmix64 finalizer
+    static uint64_t mix(uint64_t value)
+    {
+        value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+        return value ^ (value >> 31);
+    }
+
+    static ShortTransactionId toShortTransactionId(uint64_t value)
+    {
+        ShortTransactionId shortTransactionId;
+        for (size_t i = 0; i < shortTransactionId.size(); ++i) {
+            shortTransactionId[i] = (uint8_t)(value >> (i * 8));
+        }
+        return shortTransactionId;
+    }
+
+    static uint64_t fromShortTransactionId(const ShortTransactionId& shortTransactionId)
+    {
+        uint64_t value = 0;
+        for (size_t i = 0; i < shortTransactionId.size(); ++i) {
+            value |= (uint64_t)shortTransactionId[i] << (i * 8);
+        }
+        return value;
+    }
+
+    // adds known transaction ids, colliding short ids are removed from index
+    template<typename TransactionIds>
+    void addTransactionIds(const TransactionIds& transactionIds)
+    {
+        for (auto& transactionId : transactionIds) {
+            uint64_t value = calculateValue(m_salt, transactionId);
+            if (m_collisions.contains(value)) {
+                continue;
+            }
+            auto [it, inserted] = m_transactionIds.emplace(value, transactionId);
+            if (!inserted && it->second != transactionId) {
+                m_collisions.insert(value);
+            }
+        }
+        for (uint64_t value : m_collisions) {
+            m_transactionIds.erase(value);
+        }
+    }
+
+    // returns transaction id with given short id, nullptr if it's unknown or ambiguous
+    const TransactionId* getTransactionId(uint64_t value) const
+    {
+        auto it = m_transactionIds.find(value);
+        if (it == m_transactionIds.end()) {
+            return nullptr;
+        }
+        return &it->second;
+    }
+
+    const TransactionId* getTransactionId(const ShortTransactionId& shortTransactionId) const
+    {
+        return getTransactionId(fromShortTransactionId(shortTransactionId));
+    }
+
+    uint64_t getSalt() const
+    {
+        return m_salt;
+    }
+
+private:
+    const uint64_t m_salt;
+    std::map<uint64_t, TransactionId> m_transactionIds;
+    std::set<uint64_t> m_collisions;
+};
+
+}
@@ -7,8 +7,10 @@ namespace logpass {
 namespace database {
 
 BaseDatabase::BaseDatabase(const DatabaseOptions& options, const std::shared_ptr<Filesystem>& filesystem) :
-    EventLoopThread("database"), m_options(options), m_filesystem(filesystem)
+    EventLoopThread("database"), m_options(options), m_filesystem(filesystem),
+    m_workersGuard(asio::make_work_guard(m_workersContext))
 {
+    ASSERT(m_options.threads > 0);
     m_logger.add_attribute("Class", boost::log::attributes::constant<std::string>("Database"));
     m_logger.add_attribute("ID", boost::log::attributes::constant<std::string>(
         m_filesystem->getDatabaseDir().string()));
@@ -41,6 +43,13 @@ void BaseDatabase::start(std::vector<rocksdb::ColumnFamilyDescriptor> columns)
         std::terminate();
     }
 
+    for (size_t i = 0; i < m_options.threads; ++i) {
+        m_workers.push_back(std::thread([this] {
+            SET_THREAD_NAME("database_worker");
+            m_workersContext.run();
+        }));
+    }
+
     EventLoopThread::start();
 }
 
@@ -51,6 +60,11 @@ void BaseDatabase::stop()
         m_future.get();
     }
     EventLoopThread::stop(); // in this case, thread::stop should be called first
+    m_workersGuard.reset();
+    for (auto& worker : m_workers) {
+        worker.join();
+    }
+    m_workers.clear();
     for (rocksdb::ColumnFamilyHandle* handle : m_handles) {
         m_db->DestroyColumnFamilyHandle(handle);
     }
@@ -85,22 +99,33 @@ void BaseDatabase::clear()
 
 void BaseDatabase::preload(uint32_t blockId)
 {
+    std::vector<std::function<void(void)>> tasks;
     for (auto& column : columns()) {
-        column->preload(blockId);
+        tasks.push_back([column, blockId] {
+            column->preload(blockId);
+        });
     }
+    execute(tasks);
 }
 
 void BaseDatabase::commit(uint32_t blockId)
 {
     LOG_CLASS(debug) << "Commit";
 
-    // prepare commit for database
+    // prepare commit for database, every column writes to own batch
     rocksdb::WriteBatch batch;
     {
         PerformanceTimer timer("Creating batch", &m_logger);
-        for (auto& column : columns()) {
-            column->prepare(blockId, batch);
+        auto columns = this->columns();
+        std::vector<rocksdb::WriteBatch> batches(columns.size());
+        std::vector<std::function<void(void)>> tasks;
+        for (size_t i = 0; i < columns.size(); ++i) {
+            tasks.push_back([column = columns[i], blockId, &batch = batches[i]] {
+                column->prepare(blockId, batch);
+            });
         }
+        execute(tasks);
+        batch = mergeBatches(batches);
     }
 
     // finish last commit before doing next
@@ -187,6 +212,63 @@ void BaseDatabase::commit(uint32_t blockId)
     });
 }
 
+void BaseDatabase::execute(const std::vector<std::function<void(void)>>& tasks)
+{
+    if (tasks.empty()) {
+        return;
+    }
+
+    std::promise<void> promise;
+    std::atomic<size_t> finishedTasks = 0;
+    std::exception_ptr exception;
+    std::mutex exceptionMutex;
+    for (auto& task : tasks) {
+        asio::post(m_workersContext, [&] {
+            try {
+                task();
+            } catch (...) {
+                std::lock_guard lock(exceptionMutex);
+                if (!exception) {
+                    exception = std::current_exception();
+                }
+            }
+            if (finishedTasks.fetch_add(1) == tasks.size() - 1) {
+                promise.set_value();
+            }
+        });
+    }
+    promise.get_future().wait();
+
+    if (exception) {
+        std::rethrow_exception(exception);
+    }
+}
+
+rocksdb::WriteBatch BaseDatabase::mergeBatches(const std::vector<rocksdb::WriteBatch>& batches)
+{
+    // write batch data is 12 bytes header (8 bytes sequence, 4 bytes count) followed by records
+    constexpr size_t HEADER_SIZE = 12;
+
+    size_t size = HEADER_SIZE;
+    uint32_t count = 0;
+    for (auto& batch : batches) {
+        ASSERT(batch.GetDataSize() >= HEADER_SIZE);
+        size += batch.GetDataSize() - HEADER_SIZE;
+        count += batch.Count();
+    }
+
+    std::string data;
+    data.reserve(size);
+    data.resize(HEADER_SIZE, 0);
+    for (auto& batch : batches) {
+        // records of batch, without its header
+        data.append(batch.Data(), HEADER_SIZE, std::string::npos);
+    }
+    boost::endian::store_little_u32((unsigned char*)data.data() + 8, count);
+
+    return rocksdb::WriteBatch(std::move(data));
+}
+
 bool BaseDatabase::rollback(uint32_t blocks)
 {
     for (auto& column : columns()) {
@@ -325,6 +407,9 @@ json BaseDatabase::getDebugInfo() const
             }
         }
     }
+    for (auto& column : columns()) {
+        j["columns"][column->getName()].update(column->getDebugInfo());
+    }
 
     std::vector<json> json_threads;
     std::vector<rocksdb::ThreadStatus> threads;
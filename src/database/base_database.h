@@ -25,6 +25,12 @@ protected:
     // returns list of columns
     virtual std::vector<Column*> columns() const = 0;
 
+    // executes tasks on worker threads, blocks till all of them are done, rethrows first exception
+    void execute(const std::vector<std::function<void(void)>>& tasks);
+
+    // merges write batches into single batch, so they can be written atomically
+    static rocksdb::WriteBatch mergeBatches(const std::vector<rocksdb::WriteBatch>& batches);
+
 public:
     // clears temporary chances
     void clear();
@@ -49,6 +55,11 @@ protected:
     std::vector<rocksdb::ColumnFamilyHandle*> m_handles;
     std::promise<void> m_promise;
     std::future<void> m_future;
+
+    // workers used to preload and prepare columns in parallel
+    asio::io_context m_workersContext;
+    asio::executor_work_guard<asio::io_context::executor_type> m_workersGuard;
+    std::vector<std::thread> m_workers;
 };
 
 }
@@ -68,9 +68,7 @@ BlockHeader_cptr BlocksColumn::getNextBlockHeader(uint32_t blockId, bool confirm
 
 
     rocksdb::Iterator* it = m_db->NewIterator(rocksdb::ReadOptions(), m_handle);
-    Serializer key;
-    key.put<uint32_t>(boost::endian::endian_reverse(blockId + 1));
-    it->Seek(key);
+    it->Seek(Key<uint32_t>(boost::endian::endian_reverse(blockId + 1)));
     if (!it->Valid()) {
         delete it;
         return nullptr;
@@ -137,6 +135,64 @@ BlockTransactionIds_cptr BlocksColumn::getBlockTransactionIds(uint32_t blockId,
     return blockTransactionIds;
 }
 
+bool BlocksColumn::Iterator::next(BlockHeader_cptr& header, BlockBody_cptr& body,
+                                  std::vector<BlockTransactionIds_cptr>& blockTransactionIds)
+{
+    // keys of block are ordered: header (block id), body (block id, 'B'), transaction ids (block id, 'T', chunk)
+    auto getBlockId = [](const rocksdb::Slice& key) {
+        uint32_t blockIdBE;
+        std::memcpy(&blockIdBE, key.data(), sizeof(blockIdBE));
+        return boost::endian::endian_reverse(blockIdBE);
+    };
+
+    for (; m_iterator->Valid(); m_iterator->Next()) {
+        if (m_iterator->key().size() == sizeof(uint32_t)) {
+            break;
+        }
+    }
+    if (!m_iterator->Valid()) {
+        return false;
+    }
+
+    uint32_t blockId = getBlockId(m_iterator->key());
+    if (blockId > m_lastBlockId) {
+        return false;
+    }
+
+    Serializer headerSerializer(m_iterator->value());
+    BlockHeader_ptr blockHeader = std::make_shared<BlockHeader>();
+    headerSerializer(blockHeader);
+    header = blockHeader;
+    body = nullptr;
+    blockTransactionIds.clear();
+
+    for (m_iterator->Next(); m_iterator->Valid(); m_iterator->Next()) {
+        rocksdb::Slice key = m_iterator->key();
+        if (key.size() <= sizeof(uint32_t) || getBlockId(key) != blockId) {
+            break;
+        }
+        Serializer s(m_iterator->value());
+        if (key[sizeof(uint32_t)] == 'B') {
+            BlockBody_ptr blockBody = std::make_shared<BlockBody>();
+            s(blockBody);
+            body = blockBody;
+        } else if (key[sizeof(uint32_t)] == 'T') {
+            BlockTransactionIds_ptr transactionIds = std::make_shared<BlockTransactionIds>();
+            s(transactionIds);
+            blockTransactionIds.push_back(transactionIds);
+        }
+    }
+    return true;
+}
+
+std::unique_ptr<BlocksColumn::Iterator> BlocksColumn::getBlocksIterator(uint32_t firstBlockId,
+                                                                        uint32_t lastBlockId) const
+{
+    rocksdb::Iterator* it = m_db->NewIterator(rocksdb::ReadOptions(), m_handle);
+    it->Seek(Key<uint32_t>(boost::endian::endian_reverse(firstBlockId)));
+    return std::make_unique<Iterator>(it, lastBlockId);
+}
+
 std::map<uint32_t, std::pair<BlockHeader_cptr, BlockBody_cptr>> BlocksColumn::getLatestBlocks(bool confirmed) const
 {
     std::shared_lock lock(m_mutex);
@@ -23,6 +23,22 @@ class BlocksColumn : public StatefulColumn<BlocksColumnState> {
 public:
     constexpr static size_t LATEST_BLOCKS_SIZE = kMinersQueueSize + kDatabaseRolbackableBlocks;
 
+    // iterates over blocks saved in database in order of their ids, it reads from snapshot taken when it was
+    // created, must be destroyed before database
+    class Iterator {
+    public:
+        Iterator(rocksdb::Iterator* iterator, uint32_t lastBlockId) : m_iterator(iterator), m_lastBlockId(lastBlockId)
+        {}
+
+        // reads next block, returns false when there are no more blocks
+        bool next(BlockHeader_cptr& header, BlockBody_cptr& body,
+                  std::vector<BlockTransactionIds_cptr>& blockTransactionIds);
+
+    private:
+        std::unique_ptr<rocksdb::Iterator> m_iterator;
+        const uint32_t m_lastBlockId;
+    };
+
     using StatefulColumn::StatefulColumn;
 
     // returns name of the column
@@ -43,6 +59,10 @@ public:
     // returns block transaction ids with given id and chunk, may return nullptr
     BlockTransactionIds_cptr getBlockTransactionIds(uint32_t blockId, uint8_t chunk, bool confirmed) const;
 
+    // returns iterator over blocks saved in database with ids from firstBlockId to lastBlockId, blocks which
+    // are not commited yet are not included
+    std::unique_ptr<Iterator> getBlocksIterator(uint32_t firstBlockId, uint32_t lastBlockId) const;
+
     // returns latest blocks
     std::map<uint32_t, std::pair<BlockHeader_cptr, BlockBody_cptr>> getLatestBlocks(bool confirmed) const;
     // returns latest block header
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "key.h"
+
 namespace logpass {
 namespace database {
 
@@ -51,6 +53,12 @@ public:
         return getMetaData().name;
     }
 
+    // returns additional debug info about column
+    virtual json getDebugInfo() const
+    {
+        return json::object();
+    }
+
 protected:
     class AppendMergeOperator : public rocksdb::AssociativeMergeOperator {
         bool Merge(const rocksdb::Slice& key, const rocksdb::Slice* existing_value,
@@ -68,26 +76,32 @@ protected:
     };
 
     // returns value from database, may return nullptr
+    // returned serializer is a view over pinned value, it's not copied
     Serializer_ptr get(const rocksdb::Slice& key) const
     {
-        std::string value;
-        auto status = m_db->Get(rocksdb::ReadOptions(), m_handle, key, &value);
+        auto value = std::make_shared<rocksdb::PinnableSlice>();
+        auto status = m_db->Get(rocksdb::ReadOptions(), m_handle, key, value.get());
         if (!status.ok()) {
             return nullptr;
         }
-        return std::make_shared<Serializer>(value);
+        return std::make_shared<Serializer>(std::const_pointer_cast<const rocksdb::PinnableSlice>(value));
     }
 
     // returns multiple values from database
+    // returned serializers are views over pinned values, they share ownership of them
     std::vector<Serializer_ptr> multiGet(const std::vector<rocksdb::Slice>& keys) const
     {
-        std::vector<std::string> values;
-        auto statuses = m_db->MultiGet(rocksdb::ReadOptions(),
-                                       std::vector<rocksdb::ColumnFamilyHandle*>(keys.size(), m_handle), keys, &values);
-        std::vector<Serializer_ptr> serializers(values.size(), nullptr);
+        if (keys.empty()) {
+            return {};
+        }
+        auto values = std::make_shared<std::vector<rocksdb::PinnableSlice>>(keys.size());
+        std::vector<rocksdb::Status> statuses(keys.size());
+        m_db->MultiGet(rocksdb::ReadOptions(), m_handle, keys.size(), keys.data(), values->data(), statuses.data());
+        std::vector<Serializer_ptr> serializers(keys.size(), nullptr);
         for (size_t i = 0; i < statuses.size(); ++i) {
             if (statuses[i].ok()) {
-                serializers[i] = std::make_shared<Serializer>(values[i]);
+                std::shared_ptr<const rocksdb::PinnableSlice> value(values, &(*values)[i]);
+                serializers[i] = std::make_shared<Serializer>(value);
             }
         }
         return serializers;
@@ -99,13 +113,18 @@ protected:
         return get((rocksdb::Slice)key);
     }
 
+    // returns value from database, may return nullptr
+    template<typename... Parts>
+    Serializer_ptr get(const Key<Parts...>& key) const
+    {
+        return get((rocksdb::Slice)key);
+    }
+
     // returns value from database, may return nullptr
     template<typename K>
     Serializer_ptr get(const K& key) const
     {
-        Serializer s;
-        s(key);
-        return get(s);
+        return get(Key<K>(key));
     };
 
     // returns multi value from database, may return nullptr
@@ -123,23 +142,94 @@ protected:
     template<typename K1, typename K2>
     Serializer_ptr get(const K1& key1, const K2& key2) const
     {
-        Serializer s;
-        s(key1);
-        s(key2);
-        return get(s);
+        return get(Key<K1, K2>(key1, key2));
     };
 
     // returns value from database, may return nullptr
     template<typename K1, typename K2, typename K3>
-    Serializer_ptr get(const K1& key1, const K2& key2, const K2& key3) const
+    Serializer_ptr get(const K1& key1, const K2& key2, const K3& key3) const
     {
-        Serializer s;
-        s(key1);
-        s(key2);
-        s(key3);
-        return get(s);
+        return get(Key<K1, K2, K3>(key1, key2, key3));
     };
 
+    // returns up to count entries of history kept in pages of pageSize entries appended with AppendMergeOperator,
+    // key of page is keyPrefix followed by big endian page number and entries are indexed in order of adding,
+    // reading starts from entry with given index and goes to newer entries, or to older ones when reverse is set,
+    // all pages are read by single iterator, unconfirmedPages are added to committed pages if they are not there yet
+    template<typename T, typename... Parts>
+    std::vector<T> getPagedEntries(const Key<Parts...>& keyPrefix, uint64_t index, size_t count, bool reverse,
+                                   size_t pageSize, const std::map<uint32_t, std::vector<T>>& unconfirmedPages) const
+    {
+        std::vector<T> entries;
+        if (count == 0) {
+            return entries;
+        }
+
+        auto getPageKey = [&](uint32_t page) {
+            Key<Parts..., uint32_t> key(keyPrefix);
+            key.put(boost::endian::endian_reverse(page));
+            return key;
+        };
+
+        uint32_t page = (uint32_t)(index / pageSize);
+        std::unique_ptr<rocksdb::Iterator> it(m_db->NewIterator(rocksdb::ReadOptions(), m_handle));
+        if (reverse) {
+            it->SeekForPrev(getPageKey(page));
+        } else {
+            it->Seek(getPageKey(page));
+        }
+
+        for (bool firstPage = true; entries.size() < count; firstPage = false) {
+            std::vector<T> pageEntries;
+            bool found = false;
+            if (it->Valid() && it->key() == (rocksdb::Slice)getPageKey(page)) {
+                // value is valid until iterator is moved, so it's not copied
+                Serializer s(it->value().data(), it->value().size(), nullptr);
+                ASSERT(s.size() % T::SIZE == 0);
+                pageEntries.resize(s.size() / T::SIZE);
+                for (auto& entry : pageEntries) {
+                    s(entry);
+                }
+                found = true;
+                if (reverse) {
+                    it->Prev();
+                } else {
+                    it->Next();
+                }
+            }
+            auto unconfirmedIt = unconfirmedPages.find(page);
+            if (unconfirmedIt != unconfirmedPages.end() && !unconfirmedIt->second.empty()) {
+                auto& unconfirmedEntries = unconfirmedIt->second;
+                // check if unconfirmed entries were already committed
+                if (std::find(pageEntries.begin(), pageEntries.end(), unconfirmedEntries.front()) ==
+                    pageEntries.end()) {
+                    pageEntries.insert(pageEntries.end(), unconfirmedEntries.begin(), unconfirmedEntries.end());
+                }
+                found = true;
+            }
+            if (!found) {
+                break;
+            }
+
+            size_t offset = firstPage ? index % pageSize : (reverse ? pageSize - 1 : 0);
+            if (reverse) {
+                for (size_t i = std::min(offset + 1, pageEntries.size()); i > 0 && entries.size() < count; --i) {
+                    entries.push_back(pageEntries[i - 1]);
+                }
+                if (page == 0) {
+                    break;
+                }
+                page -= 1;
+            } else {
+                for (size_t i = offset; i < pageEntries.size() && entries.size() < count; ++i) {
+                    entries.push_back(pageEntries[i]);
+                }
+                page += 1;
+            }
+        }
+        return entries;
+    }
+
     // puts value in batch
     void put(rocksdb::WriteBatch& batch, const rocksdb::Slice& key, const rocksdb::Slice& value) const
     {
@@ -152,35 +242,33 @@ protected:
         put(batch, (rocksdb::Slice)key, value);
     }
 
+    // puts value in batch
+    template<typename... Parts>
+    void put(rocksdb::WriteBatch& batch, const Key<Parts...>& key, const rocksdb::Slice& value) const
+    {
+        put(batch, (rocksdb::Slice)key, value);
+    }
+
     // puts value in batch
     template<typename K>
     void put(rocksdb::WriteBatch& batch, const K& key, const rocksdb::Slice& value) const
     {
-        Serializer s;
-        s(key);
-        put(batch, s, value);
+        put(batch, Key<K>(key), value);
     };
 
     // puts value in batch
     template<typename K1, typename K2>
     void put(rocksdb::WriteBatch& batch, const K1& key1, const K2& key2, const rocksdb::Slice& value) const
     {
-        Serializer s;
-        s(key1);
-        s(key2);
-        put(batch, s, value);
+        put(batch, Key<K1, K2>(key1, key2), value);
     };
 
     // puts value in batch
     template<typename K1, typename K2, typename K3>
-    void put(rocksdb::WriteBatch& batch, const K1& key1, const K2& key2, const K2& key3,
+    void put(rocksdb::WriteBatch& batch, const K1& key1, const K2& key2, const K3& key3,
              const rocksdb::Slice& value) const
     {
-        Serializer s;
-        s(key1);
-        s(key2);
-        s(key3);
-        put(batch, s, value);
+        put(batch, Key<K1, K2, K3>(key1, key2, key3), value);
     };
 
     rocksdb::DB* m_db;
@@ -0,0 +1,106 @@
+#pragma once
+
+namespace logpass {
+namespace database {
+
+// key part with string, serialized as uint8_t length followed by up to MaxLength characters
+template<size_t MaxLength>
+struct KeyString {
+    static_assert(MaxLength <= std::numeric_limits<uint8_t>::max());
+    static constexpr size_t MAX_SIZE = 1 + MaxLength;
+};
+
+// returns max size in bytes of key part
+template<typename T>
+constexpr size_t getKeyPartSize()
+{
+    if constexpr (std::is_integral_v<T>) {
+        return sizeof(T);
+    } else if constexpr (is_uint8_array<T>) {
+        return T::SIZE;
+    } else {
+        return T::MAX_SIZE;
+    }
+}
+
+template<typename T>
+struct KeyPartValue {
+    using type = T;
+};
+
+template<size_t MaxLength>
+struct KeyPartValue<KeyString<MaxLength>> {
+    using type = std::string_view;
+};
+
+// database key kept in inline buffer with size computed from types of its parts, used instead of Serializer
+// to avoid heap allocation for every lookup, parts are encoded in the same way as by Serializer
+template<typename... Parts>
+class Key {
+public:
+    static constexpr size_t MAX_SIZE = (getKeyPartSize<Parts>() + ... + 0);
+
+    Key() = default;
+
+    // creates key from all parts
+    explicit Key(const typename KeyPartValue<Parts>::type&... values) requires (sizeof...(Parts) > 0)
+    {
+        (put(values), ...);
+    }
+
+    // creates key starting with given shorter key, rest of parts can be added with put
+    template<typename... PrefixParts>
+    explicit Key(const Key<PrefixParts...>& prefix)
+    {
+        static_assert(Key<PrefixParts...>::MAX_SIZE <= MAX_SIZE);
+        write(prefix.data(), prefix.size());
+    }
+
+    template<typename T> requires std::is_integral_v<T>
+    void put(T value)
+    {
+        write(&value, sizeof(value));
+    }
+
+    template<typename T> requires is_uint8_array<T>
+    void put(const T& value)
+    {
+        write(value.data(), T::SIZE);
+    }
+
+    void put(std::string_view value)
+    {
+        ASSERT(value.size() <= std::numeric_limits<uint8_t>::max());
+        put<uint8_t>((uint8_t)value.size());
+        write(value.data(), value.size());
+    }
+
+    const char* data() const
+    {
+        return (const char*)m_data.data();
+    }
+
+    size_t size() const
+    {
+        return m_size;
+    }
+
+    operator const rocksdb::Slice() const
+    {
+        return rocksdb::Slice(data(), m_size);
+    }
+
+private:
+    void write(const void* data, size_t size)
+    {
+        ASSERT(m_size + size <= MAX_SIZE);
+        memcpy(m_data.data() + m_size, data, size);
+        m_size += size;
+    }
+
+    std::array<uint8_t, MAX_SIZE> m_data;
+    size_t m_size = 0;
+};
+
+}
+}
@@ -20,11 +20,18 @@ Miner_cptr MinersColumn::getMiner(const MinerId& minerId, bool confirmed) const
         }
     }
 
+    if (auto miner = m_cache.get(minerId)) {
+        return miner;
+    }
+
+    uint64_t generation = m_cache.getGeneration();
     Serializer_ptr s = get<MinerId>(minerId);
     if (!s) {
         return nullptr;
     }
-    return Miner::load(*s, state(confirmed).blockId);
+    auto miner = Miner::load(*s, state(confirmed).blockId);
+    m_cache.put(minerId, miner, s->size(), generation);
+    return miner;
 }
 
 Miner_cptr MinersColumn::getRandomMiner(bool confirmed) const
@@ -139,6 +146,7 @@ void MinersColumn::load()
     std::unique_lock lock(m_mutex);
     ASSERT(m_miners.empty());
     StatefulColumn::load();
+    m_cache.clear();
 }
 
 void MinersColumn::prepare(uint32_t blockId, rocksdb::WriteBatch& batch)
@@ -157,6 +165,7 @@ void MinersColumn::commit()
 {
     std::unique_lock lock(m_mutex);
     StatefulColumn::commit();
+    m_cache.erase(m_miners | views::keys);
     m_miners.clear();
 }
 
@@ -167,5 +176,12 @@ void MinersColumn::clear()
     m_miners.clear();
 }
 
+json MinersColumn::getDebugInfo() const
+{
+    return {
+        {"cache", m_cache.getDebugInfo()}
+    };
+}
+
 }
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "object_cache.h"
 #include "stateful_column.h"
 #include <models/miner/miner.h>
 
@@ -28,6 +29,7 @@ public:
     constexpr static size_t TOP_MINERS_SIZE = kMinersQueueSize * 2;
     constexpr static size_t MINER_ENDPOINTS_SIZE = 10'000; // can be max 2 times bigger
     constexpr static size_t MINER_ENDPOINTS_MINIMUM_STAKE = kTotalNumberOfTokens / MINER_ENDPOINTS_SIZE;
+    constexpr static size_t CACHE_SIZE = 32 * 1024 * 1024;
 
     using StatefulColumn::StatefulColumn;
 
@@ -53,9 +55,13 @@ public:
     void commit() override;
     void clear() override;
 
+    json getDebugInfo() const override;
+
 private:
     // changed miners
     std::map<MinerId, Miner_cptr> m_miners;
+    // decoded confirmed miners
+    mutable ObjectCache<MinerId, Miner_cptr> m_cache{ CACHE_SIZE };
 };
 
 }
@@ -0,0 +1,148 @@
+#pragma once
+
+namespace logpass {
+namespace database {
+
+// bounded, sharded LRU cache of immutable decoded objects from confirmed database
+// every invalidation increases generation, values read before invalidation are not accepted by put
+template<typename K, typename V, size_t SHARDS = 16>
+class ObjectCache {
+    static_assert(SHARDS > 0, "ObjectCache must have at least one shard");
+
+    // estimated memory used by cache entry, excluding object itself
+    constexpr static size_t ENTRY_OVERHEAD = sizeof(K) * 2 + sizeof(V) + 64;
+
+public:
+    ObjectCache(size_t maxMemoryUsage) : m_maxShardMemoryUsage(std::max<size_t>(1, maxMemoryUsage / SHARDS)) {}
+    ObjectCache(const ObjectCache&) = delete;
+    ObjectCache& operator = (const ObjectCache&) = delete;
+
+    // returns generation, must be taken before reading object from database
+    uint64_t getGeneration() const
+    {
+        return m_generation.load();
+    }
+
+    // returns cached object or nullptr
+    V get(const K& key) const
+    {
+        auto& shard = getShard(key);
+        std::lock_guard lock(shard.mutex);
+        auto it = shard.entries.find(key);
+        if (it == shard.entries.end()) {
+            m_misses += 1;
+            return nullptr;
+        }
+        m_hits += 1;
+        shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+        return it->second->value;
+    }
+
+    // puts object to cache, ignored if cache has been invalidated after given generation
+    void put(const K& key, const V& value, size_t size, uint64_t generation)
+    {
+        auto& shard = getShard(key);
+        std::lock_guard lock(shard.mutex);
+        if (generation != m_generation.load()) {
+            return;
+        }
+        size += ENTRY_OVERHEAD;
+        if (size > m_maxShardMemoryUsage) {
+            return;
+        }
+        auto it = shard.entries.find(key);
+        if (it != shard.entries.end()) {
+            shard.memoryUsage -= it->second->size;
+            shard.lru.erase(it->second);
+            shard.entries.erase(it);
+        }
+        shard.lru.push_front(Entry{ .key = key, .value = value, .size = size });
+        shard.entries.emplace(key, shard.lru.begin());
+        shard.memoryUsage += size;
+        while (shard.memoryUsage > m_maxShardMemoryUsage) {
+            auto& entry = shard.lru.back();
+            shard.memoryUsage -= entry.size;
+            shard.entries.erase(entry.key);
+            shard.lru.pop_back();
+        }
+    }
+
+    // removes objects with given keys from cache
+    template<typename Keys>
+    void erase(const Keys& keys)
+    {
+        m_generation += 1;
+        for (auto& key : keys) {
+            auto& shard = getShard(key);
+            std::lock_guard lock(shard.mutex);
+            auto it = shard.entries.find(key);
+            if (it == shard.entries.end()) {
+                continue;
+            }
+            shard.memoryUsage -= it->second->size;
+            shard.lru.erase(it->second);
+            shard.entries.erase(it);
+        }
+    }
+
+    // removes all objects from cache
+    void clear()
+    {
+        m_generation += 1;
+        for (auto& shard : m_shards) {
+            std::lock_guard lock(shard.mutex);
+            shard.entries.clear();
+            shard.lru.clear();
+            shard.memoryUsage = 0;
+        }
+    }
+
+    json getDebugInfo() const
+    {
+        size_t entries = 0, memoryUsage = 0;
+        for (auto& shard : m_shards) {
+            std::lock_guard lock(shard.mutex);
+            entries += shard.entries.size();
+            memoryUsage += shard.memoryUsage;
+        }
+        uint64_t hits = m_hits.load(), misses = m_misses.load();
+        return {
+            {"entries", entries},
+            {"memory_usage", memoryUsage},
+            {"max_memory_usage", m_maxShardMemoryUsage * SHARDS},
+            {"hits", hits},
+            {"misses", misses},
+            {"hit_rate", hits + misses > 0 ? (double)hits / (hits + misses) : 0.0},
+            {"generation", m_generation.load()}
+        };
+    }
+
+private:
+    struct Entry {
+        K key;
+        V value;
+        size_t size;
+    };
+
+    struct Shard {
+        std::list<Entry> lru;
+        std::map<K, typename std::list<Entry>::iterator> entries;
+        size_t memoryUsage = 0;
+        mutable std::mutex mutex;
+    };
+
+    Shard& getShard(const K& key) const
+    {
+        std::string_view bytes((const char*)key.data(), key.size() * sizeof(*key.data()));
+        return m_shards[std::hash<std::string_view>{}(bytes) % SHARDS];
+    }
+
+    const size_t m_maxShardMemoryUsage;
+    mutable std::array<Shard, SHARDS> m_shards;
+    std::atomic<uint64_t> m_generation = 0;
+    mutable std::atomic<uint64_t> m_hits = 0;
+    mutable std::atomic<uint64_t> m_misses = 0;
+};
+
+}
+}
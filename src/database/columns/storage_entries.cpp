@@ -14,7 +14,7 @@ rocksdb::ColumnFamilyOptions StorageEntriesColumn::getOptions()
 StorageEntry_cptr StorageEntriesColumn::getEntry(const std::string& prefix, const std::string& key,
                                                  bool confirmed) const
 {
-    if (prefix.empty() || key.empty())
+    if (prefix.empty() || key.empty() || prefix.size() > kStoragePrefixMaxLength || key.size() > MAX_KEY_LENGTH)
         return nullptr;
 
     if (!confirmed) {
@@ -27,11 +27,7 @@ StorageEntry_cptr StorageEntriesColumn::getEntry(const std::string& prefix, cons
         }
     }
 
-    Serializer sKey;
-    sKey.serialize<uint8_t>(prefix);
-    sKey.serialize<uint8_t>(key);
-
-    Serializer_ptr s = get(sKey);
+    Serializer_ptr s = get(EntryKey(prefix, key));
     if (!s)
         return nullptr;
     auto entry = std::make_shared<StorageEntry>();
@@ -57,15 +53,11 @@ uint64_t StorageEntriesColumn::getEntriesCount(bool confirmed) const
 std::vector<TransactionId> StorageEntriesColumn::getTransasctionsForPrefix(const std::string& prefix, uint32_t page,
                                                                            bool confirmed) const
 {
-    if (prefix.empty())
+    if (prefix.empty() || prefix.size() > kStoragePrefixMaxLength)
         return {};
 
     std::vector<TransactionId> prefixHistory;
-    Serializer sKey;
-    sKey.serialize<uint8_t>(prefix);
-    sKey.put<uint8_t>(0x00);
-    sKey.put<uint32_t>(boost::endian::endian_reverse(page));
-    auto s = get(sKey);
+    auto s = get(PrefixHistoryKey(prefix, 0x00, boost::endian::endian_reverse(page)));
     if (s) {
         ASSERT(s->size() % TransactionId::SIZE == 0);
         size_t entries = s->size() / TransactionId::SIZE;
@@ -95,6 +87,25 @@ std::vector<TransactionId> StorageEntriesColumn::getTransasctionsForPrefix(const
     return prefixHistory;
 }
 
+std::vector<TransactionId> StorageEntriesColumn::getTransasctionsForPrefix(const std::string& prefix, uint64_t index,
+                                                                           size_t count, bool reverse,
+                                                                           bool confirmed) const
+{
+    if (prefix.empty() || prefix.size() > kStoragePrefixMaxLength)
+        return {};
+
+    std::map<uint32_t, std::vector<TransactionId>> unconfirmedPages;
+    if (!confirmed) {
+        std::shared_lock lock(m_mutex);
+        auto it = m_prefixHistory.find(prefix);
+        if (it != m_prefixHistory.end())
+            unconfirmedPages = it->second;
+    }
+
+    return getPagedEntries(Key<KeyString<kStoragePrefixMaxLength>, uint8_t>(prefix, 0x00), index, count, reverse,
+                           PAGE_SIZE, unconfirmedPages);
+}
+
 void StorageEntriesColumn::load()
 {
     std::unique_lock lock(m_mutex);
@@ -109,20 +120,16 @@ void StorageEntriesColumn::prepare(uint32_t blockId, rocksdb::WriteBatch& batch)
 
     for (auto& [prefix, entries] : m_entries) {
         for (auto& [key, entry] : entries) {
-            Serializer sKey, sValue;
-            sKey.serialize<uint8_t>(prefix);
-            sKey.serialize<uint8_t>(key);
+            Serializer sValue;
             sValue(entry);
-            put(batch, sKey, sValue);
+            put(batch, EntryKey(prefix, key), sValue);
         }
     }
 
     for (auto& [prefix, pages] : m_prefixHistory) {
         for (auto& [page, transactionIds] : pages) {
-            Serializer sKey, sValue;
-            sKey.serialize<uint8_t>(prefix);
-            sKey.put<uint8_t>(0);
-            sKey.put<uint32_t>(boost::endian::endian_reverse(page));
+            PrefixHistoryKey sKey(prefix, 0, boost::endian::endian_reverse(page));
+            Serializer sValue;
             for (auto& transactionId : transactionIds) {
                 sValue(transactionId);
             }
@@ -20,6 +20,11 @@ struct StorageEntriesColumnState : public ColumnState {
 class StorageEntriesColumn : public StatefulColumn<StorageEntriesColumnState> {
 public:
     constexpr static size_t PAGE_SIZE = 100;
+    // keys of entries are serialized with uint8_t length
+    constexpr static size_t MAX_KEY_LENGTH = std::numeric_limits<uint8_t>::max();
+
+    using EntryKey = Key<KeyString<kStoragePrefixMaxLength>, KeyString<MAX_KEY_LENGTH>>;
+    using PrefixHistoryKey = Key<KeyString<kStoragePrefixMaxLength>, uint8_t, uint32_t>;
 
     using StatefulColumn::StatefulColumn;
 
@@ -38,6 +43,9 @@ public:
 
     std::vector<TransactionId> getTransasctionsForPrefix(const std::string& prefix, uint32_t page,
                                                          bool confirmed) const;
+    // returns up to count transactions starting from entry with given index, towards older entries if reverse is set
+    std::vector<TransactionId> getTransasctionsForPrefix(const std::string& prefix, uint64_t index, size_t count,
+                                                         bool reverse, bool confirmed) const;
 
     void load() override;
     void prepare(uint32_t blockId, rocksdb::WriteBatch& batch) override;
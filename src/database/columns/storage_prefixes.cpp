@@ -19,12 +19,19 @@ Prefix_cptr StoragePrefixesColumn::getPrefix(const std::string& prefixId, bool c
             return it->second;
     }
 
-    Serializer sKey;
-    sKey.serialize<uint8_t>(prefixId);
-    Serializer_ptr s = get(sKey);
+    if (auto prefix = m_cache.get(prefixId))
+        return prefix;
+
+    if (prefixId.size() > kStoragePrefixMaxLength)
+        return nullptr;
+
+    uint64_t generation = m_cache.getGeneration();
+    Serializer_ptr s = get(Key<KeyString<kStoragePrefixMaxLength>>(prefixId));
     if (!s)
         return nullptr;
-    return Prefix::load(*s);
+    auto prefix = Prefix::load(*s);
+    m_cache.put(prefixId, prefix, s->size(), generation);
+    return prefix;
 }
 
 void StoragePrefixesColumn::addPrefix(const Prefix_cptr& prefix)
@@ -53,6 +60,7 @@ void StoragePrefixesColumn::load()
     std::unique_lock lock(m_mutex);
     ASSERT(m_prefixes.empty());
     StatefulColumn::load();
+    m_cache.clear();
 }
 
 void StoragePrefixesColumn::prepare(uint32_t blockId, rocksdb::WriteBatch& batch)
@@ -61,10 +69,9 @@ void StoragePrefixesColumn::prepare(uint32_t blockId, rocksdb::WriteBatch& batch
     StatefulColumn::prepare(blockId, batch);
 
     for (auto& [prefixId, prefix] : m_prefixes) {
-        Serializer sKey, sVal;
-        sKey.serialize<uint8_t>(prefixId);
+        Serializer sVal;
         sVal(prefix);
-        batch.Put(m_handle, sKey, sVal);
+        batch.Put(m_handle, Key<KeyString<kStoragePrefixMaxLength>>(prefixId), sVal);
     }
 }
 
@@ -72,6 +79,7 @@ void StoragePrefixesColumn::commit()
 {
     std::unique_lock lock(m_mutex);
     StatefulColumn::commit();
+    m_cache.erase(m_prefixes | views::keys);
     m_prefixes.clear();
 }
 
@@ -82,5 +90,12 @@ void StoragePrefixesColumn::clear()
     m_prefixes.clear();
 }
 
+json StoragePrefixesColumn::getDebugInfo() const
+{
+    return {
+        {"cache", m_cache.getDebugInfo()}
+    };
+}
+
 }
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "object_cache.h"
 #include "stateful_column.h"
 #include <models/storage/prefix.h>
 
@@ -19,6 +20,8 @@ struct StoragePrefixesColumnState : public ColumnState {
 // keeps storage prefixes
 class StoragePrefixesColumn : public StatefulColumn<StoragePrefixesColumnState> {
 public:
+    constexpr static size_t CACHE_SIZE = 32 * 1024 * 1024;
+
     using StatefulColumn::StatefulColumn;
 
     static std::string getName()
@@ -41,8 +44,12 @@ public:
     void commit() override;
     void clear() override;
 
+    json getDebugInfo() const override;
+
 private:
     std::map<std::string, Prefix_cptr> m_prefixes;
+    // decoded confirmed prefixes
+    mutable ObjectCache<std::string, Prefix_cptr> m_cache{ CACHE_SIZE };
 };
 
 }
@@ -26,8 +26,21 @@ bool TransactionHashesColumn::hasTransactionHash(uint32_t transactionBlockId, co
         }
     }
 
+    {
+        std::shared_lock lock(m_mutex);
+        auto it = m_filter.find(transactionBlockId);
+        if (it == m_filter.end() || !std::binary_search(it->second.begin(), it->second.end(), getFingerprint(hash))) {
+            return false;
+        }
+    }
+
     auto s = get(boost::endian::endian_reverse(transactionBlockId), hash);
-    return s != nullptr;
+    if (!s) {
+        m_filterFalsePositives += 1;
+        return false;
+    }
+    m_filterHits += 1;
+    return true;
 }
 
 void TransactionHashesColumn::addTransactionHashHash(uint32_t transactionBlockId, const Hash& hash)
@@ -41,6 +54,20 @@ void TransactionHashesColumn::load()
 {
     std::unique_lock lock(m_mutex);
     StatefulColumn::load();
+
+    m_filter.clear();
+    m_filterSize = 0;
+    std::map<uint32_t, std::vector<uint64_t>> fingerprints;
+    std::unique_ptr<rocksdb::Iterator> it(m_db->NewIterator(rocksdb::ReadOptions(), m_handle));
+    for (it->Seek(rocksdb::Slice("\0"s)); it->Valid(); it->Next()) {
+        Serializer key(it->key().data(), it->key().size(), nullptr);
+        uint32_t transactionBlockId = boost::endian::endian_reverse(key.get<uint32_t>());
+        fingerprints[transactionBlockId].push_back(getFingerprint(key.get<Hash>()));
+    }
+    for (auto& [transactionBlockId, blockFingerprints] : fingerprints) {
+        addToFilter(transactionBlockId, blockFingerprints);
+    }
+    truncateFilter(state(true).blockId);
 }
 
 void TransactionHashesColumn::prepare(uint32_t blockId, rocksdb::WriteBatch& batch)
@@ -56,9 +83,8 @@ void TransactionHashesColumn::prepare(uint32_t blockId, rocksdb::WriteBatch& bat
     }
 
     if (blockId > kTransactionMaxBlockIdDifference) {
-        Serializer last_key;
-        last_key.put<uint32_t>(boost::endian::endian_reverse(blockId - kTransactionMaxBlockIdDifference));
-        batch.DeleteRange(m_handle, rocksdb::Slice("\0"s), last_key); // "\0" to skip state which is ""
+        Key<uint32_t> lastKey(boost::endian::endian_reverse(blockId - kTransactionMaxBlockIdDifference));
+        batch.DeleteRange(m_handle, rocksdb::Slice("\0"s), lastKey); // "\0" to skip state which is ""
     }
 }
 
@@ -66,6 +92,15 @@ void TransactionHashesColumn::commit()
 {
     std::unique_lock lock(m_mutex);
     StatefulColumn::commit();
+    for (auto& [transactionBlockId, hashes] : m_hashes) {
+        std::vector<uint64_t> fingerprints;
+        fingerprints.reserve(hashes.size());
+        for (auto& hash : hashes) {
+            fingerprints.push_back(getFingerprint(hash));
+        }
+        addToFilter(transactionBlockId, fingerprints);
+    }
+    truncateFilter(state(true).blockId);
     m_hashes.clear();
 }
 
@@ -76,5 +111,49 @@ void TransactionHashesColumn::clear()
     m_hashes.clear();
 }
 
+json TransactionHashesColumn::getDebugInfo() const
+{
+    std::shared_lock lock(m_mutex);
+    return {
+        {"filter", {
+            {"blocks", m_filter.size()},
+            {"entries", m_filterSize},
+            {"memory_usage", m_filterSize * sizeof(uint64_t)},
+            {"hits", m_filterHits.load()},
+            {"false_positives", m_filterFalsePositives.load()}
+        }}
+    };
+}
+
+uint64_t TransactionHashesColumn::getFingerprint(const Hash& hash)
+{
+    uint64_t fingerprint;
+    memcpy(&fingerprint, hash.data(), sizeof(fingerprint));
+    return fingerprint;
+}
+
+void TransactionHashesColumn::addToFilter(uint32_t transactionBlockId, const std::vector<uint64_t>& fingerprints)
+{
+    auto& blockFingerprints = m_filter[transactionBlockId];
+    size_t oldSize = blockFingerprints.size();
+    blockFingerprints.insert(blockFingerprints.end(), fingerprints.begin(), fingerprints.end());
+    std::sort(blockFingerprints.begin() + oldSize, blockFingerprints.end());
+    std::inplace_merge(blockFingerprints.begin(), blockFingerprints.begin() + oldSize, blockFingerprints.end());
+    m_filterSize += fingerprints.size();
+}
+
+void TransactionHashesColumn::truncateFilter(uint32_t blockId)
+{
+    // same range as deleted from database in prepare
+    if (blockId <= kTransactionMaxBlockIdDifference) {
+        return;
+    }
+    auto end = m_filter.lower_bound(blockId - kTransactionMaxBlockIdDifference);
+    for (auto it = m_filter.begin(); it != end; ++it) {
+        m_filterSize -= it->second.size();
+    }
+    m_filter.erase(m_filter.begin(), end);
+}
+
 }
 }
@@ -30,8 +30,23 @@ public:
     void commit() override;
     void clear() override;
 
+    json getDebugInfo() const override;
+
 private:
+    // returns fingerprint of hash used by in-memory filter
+    static uint64_t getFingerprint(const Hash& hash);
+    // adds fingerprints to in-memory filter, m_mutex unique lock must be aquired when calling
+    void addToFilter(uint32_t transactionBlockId, const std::vector<uint64_t>& fingerprints);
+    // removes blocks older than kTransactionMaxBlockIdDifference from in-memory filter, requires unique lock
+    void truncateFilter(uint32_t blockId);
+
     std::map<uint32_t, std::set<Hash>> m_hashes;
+    // sorted fingerprints of confirmed hashes for last kTransactionMaxBlockIdDifference blocks
+    // positive result must be confirmed by database
+    std::map<uint32_t, std::vector<uint64_t>> m_filter;
+    size_t m_filterSize = 0;
+    mutable std::atomic<uint64_t> m_filterHits = 0;
+    mutable std::atomic<uint64_t> m_filterFalsePositives = 0;
 };
 
 }
@@ -43,6 +43,35 @@ std::map<TransactionId, Transaction_cptr> TransactionsColumn::getTransactions(
     return transactions;
 }
 
+std::vector<std::pair<Transaction_cptr, uint32_t>> TransactionsColumn::getTransactionsWithBlockIds(
+    const std::vector<TransactionId>& transactionIds, bool confirmed) const
+{
+    std::vector<std::pair<Transaction_cptr, uint32_t>> transactions(transactionIds.size(), { nullptr, 0 });
+    std::vector<TransactionId> missingTransactionIds;
+    std::vector<size_t> positions;
+    {
+        std::shared_lock lock(m_mutex);
+        for (size_t i = 0; i < transactionIds.size(); ++i) {
+            auto it = confirmed ? m_transactions.end() : m_transactions.find(transactionIds[i]);
+            if (it != m_transactions.end()) {
+                transactions[i] = { it->second.first, 0 };
+            } else {
+                missingTransactionIds.push_back(transactionIds[i]);
+                positions.push_back(i);
+            }
+        }
+    }
+
+    auto results = multiGet(missingTransactionIds);
+    for (size_t i = 0; i < results.size(); ++i) {
+        if (results[i]) {
+            uint32_t blockId = results[i]->get<uint32_t>();
+            transactions[positions[i]] = { Transaction::load(*results[i]), blockId };
+        }
+    }
+    return transactions;
+}
+
 void TransactionsColumn::addTransaction(const Transaction_cptr& transaction, uint32_t blockId)
 {
     ASSERT(!getTransaction(transaction->getId(), false).first);
@@ -34,6 +34,9 @@ public:
 
     std::pair<Transaction_cptr, uint32_t> getTransaction(const TransactionId& transactionId, bool confirmed) const;
     std::map<TransactionId, Transaction_cptr> getTransactions(const std::vector<TransactionId>& transactionIds);
+    // the same as getTransaction for multiple transactions, results are in order of transaction ids
+    std::vector<std::pair<Transaction_cptr, uint32_t>> getTransactionsWithBlockIds(
+        const std::vector<TransactionId>& transactionIds, bool confirmed) const;
     void addTransaction(const Transaction_cptr& transaction, uint32_t blockId);
 
     uint64_t getTransactionsCount(bool confirmed) const;
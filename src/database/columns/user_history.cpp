@@ -48,6 +48,21 @@ std::vector<UserHistory> UserHistoryColumn::getUserHistory(const UserId& userId,
     return userHistory;
 }
 
+std::vector<UserHistory> UserHistoryColumn::getUserHistory(const UserId& userId, uint64_t index, size_t count,
+                                                           bool reverse, bool confirmed) const
+{
+    std::map<uint32_t, std::vector<UserHistory>> unconfirmedPages;
+    if (!confirmed) {
+        std::shared_lock lock(m_mutex);
+        auto it = m_transactions.find(userId);
+        if (it != m_transactions.end()) {
+            unconfirmedPages = it->second;
+        }
+    }
+
+    return getPagedEntries(Key<UserId>(userId), index, count, reverse, PAGE_SIZE, unconfirmedPages);
+}
+
 void UserHistoryColumn::addUserHistory(const UserId& userId, uint32_t page, const UserHistory& history)
 {
     std::unique_lock lock(m_mutex);
@@ -68,9 +83,8 @@ void UserHistoryColumn::prepare(uint32_t blockId, rocksdb::WriteBatch& batch)
 
     for (auto& [userId, transactions] : m_transactions) {
         for (auto& [page, history] : transactions) {
-            Serializer key, value;
-            key(userId);
-            key.put<uint32_t>(boost::endian::endian_reverse(page));
+            Key<UserId, uint32_t> key(userId, boost::endian::endian_reverse(page));
+            Serializer value;
             for (auto& entry : history) {
                 value(entry);
             }
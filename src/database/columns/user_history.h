@@ -13,6 +13,8 @@ struct UserHistoryColumnState : public ColumnState {
 // keeps history of user transactions
 class UserHistoryColumn : public StatefulColumn<UserHistoryColumnState> {
 public:
+    constexpr static size_t PAGE_SIZE = 100;
+
     using StatefulColumn::StatefulColumn;
 
     static std::string getName()
@@ -23,6 +25,9 @@ public:
     static rocksdb::ColumnFamilyOptions getOptions();
 
     std::vector<UserHistory> getUserHistory(const UserId& userId, uint32_t page, bool confirmed) const;
+    // returns up to count entries starting from entry with given index, towards older entries if reverse is set
+    std::vector<UserHistory> getUserHistory(const UserId& userId, uint64_t index, size_t count, bool reverse,
+                                            bool confirmed) const;
 
     void addUserHistory(const UserId& userId, uint32_t page, const UserHistory& history);
 
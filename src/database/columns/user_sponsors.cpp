@@ -48,6 +48,21 @@ std::vector<UserSponsor> UserSponsorsColumn::getUserSponsors(const UserId& userI
     return userSponsor;
 }
 
+std::vector<UserSponsor> UserSponsorsColumn::getUserSponsors(const UserId& userId, uint64_t index, size_t count,
+                                                             bool reverse, bool confirmed) const
+{
+    std::map<uint32_t, std::vector<UserSponsor>> unconfirmedPages;
+    if (!confirmed) {
+        std::shared_lock lock(m_mutex);
+        auto it = m_sponsors.find(userId);
+        if (it != m_sponsors.end()) {
+            unconfirmedPages = it->second;
+        }
+    }
+
+    return getPagedEntries(Key<UserId>(userId), index, count, reverse, PAGE_SIZE, unconfirmedPages);
+}
+
 void UserSponsorsColumn::addUserSponsor(const UserId& userId, uint32_t page, const UserSponsor& sponsor)
 {
     std::unique_lock lock(m_mutex);
@@ -68,9 +83,8 @@ void UserSponsorsColumn::prepare(uint32_t blockId, rocksdb::WriteBatch& batch)
 
     for (auto& [userId, entries] : m_sponsors) {
         for (auto& [page, sponsors] : entries) {
-            Serializer key, value;
-            key(userId);
-            key.put<uint32_t>(boost::endian::endian_reverse(page));
+            Key<UserId, uint32_t> key(userId, boost::endian::endian_reverse(page));
+            Serializer value;
             for (auto& entry : sponsors) {
                 value(entry);
             }
@@ -26,6 +26,9 @@ public:
 
     void addUserSponsor(const UserId& userId, uint32_t page, const UserSponsor& sponsor);
     std::vector<UserSponsor> getUserSponsors(const UserId& userId, uint32_t page, bool confirmed) const;
+    // returns up to count entries starting from entry with given index, towards older entries if reverse is set
+    std::vector<UserSponsor> getUserSponsors(const UserId& userId, uint64_t index, size_t count, bool reverse,
+                                             bool confirmed) const;
 
     void load() override;
     void prepare(uint32_t blockId, rocksdb::WriteBatch& batch) override;
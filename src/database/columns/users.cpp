@@ -20,11 +20,55 @@ User_cptr UsersColumn::getUser(const UserId& userId, bool confirmed) const
         }
     }
 
-    Serializer_ptr s = get<UserId>(userId);
-    if (!s) {
-        return nullptr;
+    User_cptr user = m_cache.get(userId);
+    if (!user) {
+        uint64_t generation = m_cache.getGeneration();
+        Serializer_ptr s = get<UserId>(userId);
+        if (!s) {
+            return nullptr;
+        }
+        user = User::load(*s);
+        m_cache.put(userId, user, s->size(), generation);
     }
-    return User::load(*s, state(confirmed).blockId);
+    return User::load(user, state(confirmed).blockId);
+}
+
+std::vector<User_cptr> UsersColumn::getUsers(const std::vector<UserId>& userIds, bool confirmed) const
+{
+    std::vector<User_cptr> users(userIds.size(), nullptr);
+    std::vector<UserId> missingUserIds;
+    std::vector<size_t> positions;
+    uint32_t blockId;
+    {
+        std::shared_lock lock(m_mutex);
+        blockId = state(confirmed).blockId;
+        for (size_t i = 0; i < userIds.size(); ++i) {
+            if (!confirmed) {
+                auto it = m_users.find(userIds[i]);
+                if (it != m_users.end()) {
+                    users[i] = it->second;
+                    continue;
+                }
+            }
+            if (auto user = m_cache.get(userIds[i])) {
+                users[i] = User::load(user, blockId);
+            } else {
+                missingUserIds.push_back(userIds[i]);
+                positions.push_back(i);
+            }
+        }
+    }
+
+    uint64_t generation = m_cache.getGeneration();
+    auto results = multiGet(missingUserIds);
+    for (size_t i = 0; i < results.size(); ++i) {
+        if (results[i]) {
+            auto user = User::load(*results[i]);
+            m_cache.put(missingUserIds[i], user, results[i]->size(), generation);
+            users[positions[i]] = User::load(user, blockId);
+        }
+    }
+    return users;
 }
 
 User_cptr UsersColumn::getRandomUser(bool confirmed) const
@@ -97,6 +141,7 @@ void UsersColumn::load()
     std::unique_lock lock(m_mutex);
     ASSERT(m_users.empty());
     StatefulColumn::load();
+    m_cache.clear();
 }
 
 void UsersColumn::preload(uint32_t blockId)
@@ -108,24 +153,32 @@ void UsersColumn::preload(uint32_t blockId)
         m_usersToPreload.clear();
     }
 
+    std::map<UserId, User_cptr> missingUsers;
     std::vector<UserId> missingUserIds;
     for (auto& userId : usersToPreload) {
-        if (!m_users.contains(userId)) {
+        if (m_users.contains(userId)) {
+            continue;
+        }
+        if (auto user = m_cache.get(userId)) {
+            missingUsers.emplace(userId, User::load(user, blockId));
+        } else {
             missingUserIds.emplace_back(userId);
         }
     }
 
-    if (missingUserIds.empty()) {
+    if (missingUserIds.empty() && missingUsers.empty()) {
         return;
     }
 
-    std::map<UserId, User_cptr> missingUsers;
+    uint64_t generation = m_cache.getGeneration();
     auto results = multiGet(missingUserIds);
     for (size_t i = 0; i < results.size(); ++i) {
         if (!results[i]) {
             missingUsers.emplace(missingUserIds[i], nullptr);
         } else {
-            missingUsers.emplace(missingUserIds[i], User::load(*results[i], blockId));
+            auto user = User::load(*results[i]);
+            m_cache.put(missingUserIds[i], user, results[i]->size(), generation);
+            missingUsers.emplace(missingUserIds[i], User::load(user, blockId));
         }
     }
 
@@ -152,6 +205,13 @@ void UsersColumn::commit()
 {
     std::unique_lock lock(m_mutex);
     StatefulColumn::commit();
+    std::vector<UserId> updatedUserIds;
+    for (auto& [userId, user] : m_users) {
+        if (user && user->committedIn == state().blockId) {
+            updatedUserIds.push_back(userId);
+        }
+    }
+    m_cache.erase(updatedUserIds);
     m_users.clear();
     m_usersToPreload.clear();
 }
@@ -164,5 +224,12 @@ void UsersColumn::clear()
     m_usersToPreload.clear();
 }
 
+json UsersColumn::getDebugInfo() const
+{
+    return {
+        {"cache", m_cache.getDebugInfo()}
+    };
+}
+
 }
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "object_cache.h"
 #include "stateful_column.h"
 #include <models/user/user.h>
 
@@ -21,6 +22,8 @@ struct UsersColumnState : public ColumnState {
 // keeps users
 class UsersColumn : public StatefulColumn<UsersColumnState> {
 public:
+    constexpr static size_t CACHE_SIZE = 128 * 1024 * 1024;
+
     using StatefulColumn::StatefulColumn;
 
     static std::string getName()
@@ -31,6 +34,8 @@ public:
     static rocksdb::ColumnFamilyOptions getOptions();
 
     User_cptr getUser(const UserId& userId, bool confirmed) const;
+    // the same as getUser for multiple users, results are in order of user ids
+    std::vector<User_cptr> getUsers(const std::vector<UserId>& userIds, bool confirmed) const;
     User_cptr getRandomUser(bool confirmed) const;
     void addUser(const User_cptr& user);
     void updateUser(const User_cptr& user);
@@ -44,11 +49,15 @@ public:
     void commit() override;
     void clear() override;
 
+    json getDebugInfo() const override;
+
 private:
     // changed users
     std::map<UserId, User_cptr> m_users;
     // users to preload
     std::set<UserId> m_usersToPreload;
+    // decoded confirmed users, without executed pending updates
+    mutable ObjectCache<UserId, User_cptr> m_cache{ CACHE_SIZE };
 };
 
 }
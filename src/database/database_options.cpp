@@ -10,7 +10,9 @@ po::options_description DatabaseOptions::getOptionsDescription()
 
     options.add_options()
         ("max-open-files", po::value<size_t>()->default_value(32768), "number of max opened files by database")
-        ("cache-size", po::value<size_t>()->default_value(8192), "max cache size in MBs for database");
+        ("cache-size", po::value<size_t>()->default_value(8192), "max cache size in MBs for database")
+        ("database-threads", po::value<size_t>()->default_value(4),
+         "number of threads used by database to preload and prepare columns");
 
     return options;
 }
@@ -20,5 +22,6 @@ DatabaseOptions DatabaseOptions::loadOptions(po::variables_map& vm)
     DatabaseOptions options;
     options.maxOpenFiles = vm["max-open-files"].as<size_t>();
     options.cacheSize = vm["cache-size"].as<size_t>();
+    options.threads = vm["database-threads"].as<size_t>();
     return options;
 }
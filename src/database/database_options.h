@@ -3,6 +3,7 @@
 struct DatabaseOptions {
     size_t maxOpenFiles = 32768;
     size_t cacheSize = 8192;
+    size_t threads = 4;
 
     static program_options::options_description getOptionsDescription();
     static DatabaseOptions loadOptions(program_options::variables_map& optionsVariableMap);
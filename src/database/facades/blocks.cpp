@@ -4,6 +4,21 @@
 namespace logpass {
 namespace database {
 
+Block_cptr BlocksFacade::Iterator::next()
+{
+    BlockHeader_cptr header;
+    BlockBody_cptr body;
+    std::vector<BlockTransactionIds_cptr> blockTransactionIds;
+    if (!m_iterator->next(header, body, blockTransactionIds)) {
+        return nullptr;
+    }
+    auto block = makeBlock(m_transactions, header, body, blockTransactionIds);
+    if (!block) {
+        THROW_EXCEPTION(CorruptedBlockException("Corrupted block "s + std::to_string(header->getId())));
+    }
+    return block;
+}
+
 Block_cptr BlocksFacade::getBlock(uint32_t blockId) const
 {
     auto header = m_blocks->getBlockHeader(blockId, m_confirmed);
@@ -11,25 +26,48 @@ Block_cptr BlocksFacade::getBlock(uint32_t blockId) const
         return nullptr;
     }
     auto body = m_blocks->getBlockBody(blockId, m_confirmed);
-    if (!body || header->getBodyHash() != body->getHash()) {
+    if (!body) {
         return nullptr;
     }
     std::vector<BlockTransactionIds_cptr> blockTransactionIds;
-    std::vector<Hash> transactionIdsHashes = body->getHashes();
-    for (size_t index = 0; Hash& hash : transactionIdsHashes) {
-        auto transactionIds = m_blocks->getBlockTransactionIds(blockId, index++, m_confirmed);
-        if (!transactionIds || transactionIds->getHash() != hash) {
+    for (uint8_t index = 0; index < body->getHashes().size(); ++index) {
+        auto transactionIds = m_blocks->getBlockTransactionIds(blockId, index, m_confirmed);
+        if (!transactionIds) {
             return nullptr;
         }
         blockTransactionIds.push_back(transactionIds);
     }
+    return makeBlock(m_transactions, header, body, blockTransactionIds);
+}
+
+std::unique_ptr<BlocksFacade::Iterator> BlocksFacade::getBlocksIterator(uint32_t firstBlockId,
+                                                                        uint32_t lastBlockId) const
+{
+    return std::make_unique<Iterator>(m_transactions, m_blocks->getBlocksIterator(firstBlockId, lastBlockId));
+}
+
+Block_cptr BlocksFacade::makeBlock(TransactionsColumn* transactions, const BlockHeader_cptr& header,
+                                   const BlockBody_cptr& body,
+                                   const std::vector<BlockTransactionIds_cptr>& blockTransactionIds)
+{
+    if (!body || header->getBodyHash() != body->getHash()) {
+        return nullptr;
+    }
+    std::vector<Hash> transactionIdsHashes = body->getHashes();
+    if (transactionIdsHashes.size() != blockTransactionIds.size()) {
+        return nullptr;
+    }
+    for (size_t index = 0; index < transactionIdsHashes.size(); ++index) {
+        if (blockTransactionIds[index]->getHash() != transactionIdsHashes[index]) {
+            return nullptr;
+        }
+    }
     std::vector<TransactionId> transactionIds;
     transactionIds.reserve(body->getTransactions());
     for (auto& chunk : blockTransactionIds) {
         transactionIds.insert(transactionIds.end(), chunk->begin(), chunk->end());
     }
-    std::map<TransactionId, Transaction_cptr> transactions = m_transactions->getTransactions(transactionIds);
-    return std::make_shared<Block>(header, body, blockTransactionIds, transactions);
+    return std::make_shared<Block>(header, body, blockTransactionIds, transactions->getTransactions(transactionIds));
 }
 
 BlockHeader_cptr BlocksFacade::getBlockHeader(uint32_t blockId) const
@@ -9,8 +9,29 @@
 namespace logpass {
 namespace database {
 
+// thrown when block saved in database can't be loaded
+class CorruptedBlockException : public Exception {
+    using Exception::Exception;
+};
+
 class BlocksFacade : public Facade {
 public:
+    // iterates over blocks saved in database, transactions are read separately for every block
+    class Iterator {
+    public:
+        Iterator(TransactionsColumn* transactions, std::unique_ptr<BlocksColumn::Iterator>&& iterator) :
+            m_transactions(transactions), m_iterator(std::move(iterator))
+        {}
+
+        // returns next block or nullptr when there are no more blocks, throws CorruptedBlockException when block
+        // can't be loaded
+        Block_cptr next();
+
+    private:
+        TransactionsColumn* m_transactions;
+        std::unique_ptr<BlocksColumn::Iterator> m_iterator;
+    };
+
     BlocksFacade(BlocksColumn* blocks, TransactionsColumn* transactions, bool confirmed) :
         m_blocks(blocks), m_transactions(transactions), m_confirmed(confirmed) {}
 
@@ -30,6 +51,10 @@ public:
     // returns block transaction ids with given id and chunk, may return nullptr
     BlockTransactionIds_cptr getBlockTransactionIds(uint32_t blockId, uint8_t chunk) const;
 
+    // returns iterator over blocks with ids from firstBlockId to lastBlockId, only blocks saved in database are
+    // included, so unconfirmed blocks are skipped
+    std::unique_ptr<Iterator> getBlocksIterator(uint32_t firstBlockId, uint32_t lastBlockId) const;
+
     // returns latest block headers and bodies 
     std::map<uint32_t, std::pair<BlockHeader_cptr, BlockBody_cptr>> getLatestBlocks() const;
     // returns latest block header
@@ -44,6 +69,11 @@ public:
     void addBlock(const Block_cptr& block);
 
 private:
+    // returns block with transactions or nullptr if block parts don't match
+    static Block_cptr makeBlock(TransactionsColumn* transactions, const BlockHeader_cptr& header,
+                                const BlockBody_cptr& body,
+                                const std::vector<BlockTransactionIds_cptr>& blockTransactionIds);
+
     BlocksColumn* m_blocks;
     TransactionsColumn* m_transactions;
     bool m_confirmed;
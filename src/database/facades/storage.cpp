@@ -44,5 +44,11 @@ std::vector<TransactionId> StorageFacade::getTransasctionsForPrefix(const std::s
     return m_entries->getTransasctionsForPrefix(prefix, page, m_confirmed);
 }
 
+std::vector<TransactionId> StorageFacade::getTransasctionsForPrefix(const std::string& prefix, uint64_t index,
+                                                                    size_t count, bool reverse) const
+{
+    return m_entries->getTransasctionsForPrefix(prefix, index, count, reverse, m_confirmed);
+}
+
 }
 }
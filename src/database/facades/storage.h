@@ -35,6 +35,9 @@ public:
     uint64_t getEntriesCount() const;
 
     std::vector<TransactionId> getTransasctionsForPrefix(const std::string& prefix, uint32_t page) const;
+    // returns up to count transactions starting from entry with given index, towards older entries if reverse is set
+    std::vector<TransactionId> getTransasctionsForPrefix(const std::string& prefix, uint64_t index, size_t count,
+                                                         bool reverse) const;
 
 private:
     StorageEntriesColumn* m_entries;
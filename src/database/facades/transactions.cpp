@@ -15,6 +15,12 @@ std::pair<Transaction_cptr, uint32_t> TransactionsFacade::getTransactionWithBloc
     return m_transactions->getTransaction(transactionId, m_confirmed);
 }
 
+std::vector<std::pair<Transaction_cptr, uint32_t>> TransactionsFacade::getTransactionsWithBlockIds(
+    const std::vector<TransactionId>& transactionIds) const
+{
+    return m_transactions->getTransactionsWithBlockIds(transactionIds, m_confirmed);
+}
+
 bool TransactionsFacade::hasTransaction(const TransactionId& transactionId) const
 {
     return m_transactions->getTransaction(transactionId, m_confirmed).first != nullptr;
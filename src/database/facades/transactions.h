@@ -24,6 +24,8 @@ public:
 
     Transaction_cptr getTransaction(const TransactionId& transactionId) const;
     std::pair<Transaction_cptr, uint32_t> getTransactionWithBlockId(const TransactionId& transactionId) const;
+    std::vector<std::pair<Transaction_cptr, uint32_t>> getTransactionsWithBlockIds(
+        const std::vector<TransactionId>& transactionIds) const;
 
     bool hasTransaction(const TransactionId& transactionId) const;
 
@@ -9,6 +9,11 @@ User_cptr UsersFacade::getUser(const UserId& userId) const
     return m_users->getUser(userId, m_confirmed);
 }
 
+std::vector<User_cptr> UsersFacade::getUsers(const std::vector<UserId>& userIds) const
+{
+    return m_users->getUsers(userIds, m_confirmed);
+}
+
 User_cptr UsersFacade::getRandomUser() const
 {
     return m_users->getRandomUser(m_confirmed);
@@ -48,6 +53,12 @@ std::vector<UserHistory> UsersFacade::getUserHistory(const UserId& userId, uint3
     return m_userHistory->getUserHistory(userId, page, m_confirmed);
 }
 
+std::vector<UserHistory> UsersFacade::getUserHistory(const UserId& userId, uint64_t index, size_t count,
+                                                     bool reverse) const
+{
+    return m_userHistory->getUserHistory(userId, index, count, reverse, m_confirmed);
+}
+
 void UsersFacade::addUserHistory(const UserId& userId, uint32_t page, const UserHistory& history)
 {
     m_userHistory->addUserHistory(userId, page, history);
@@ -58,6 +69,12 @@ std::vector<UserSponsor> UsersFacade::getUserSponsors(const UserId& userId, uint
     return m_userSponsors->getUserSponsors(userId, page, m_confirmed);
 }
 
+std::vector<UserSponsor> UsersFacade::getUserSponsors(const UserId& userId, uint64_t index, size_t count,
+                                                      bool reverse) const
+{
+    return m_userSponsors->getUserSponsors(userId, index, count, reverse, m_confirmed);
+}
+
 void UsersFacade::addUserSponsor(const UserId& userId, uint32_t page, const UserSponsor& history)
 {
     m_userSponsors->addUserSponsor(userId, page, history);
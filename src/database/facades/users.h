@@ -26,6 +26,7 @@ public:
     {}
 
     User_cptr getUser(const UserId& userId) const;
+    std::vector<User_cptr> getUsers(const std::vector<UserId>& userIds) const;
     User_cptr getRandomUser() const;
     void addUser(const User_cptr& user);
     void updateUser(const User_cptr& user);
@@ -37,10 +38,14 @@ public:
 
     // user history
     std::vector<UserHistory> getUserHistory(const UserId& userId, uint32_t page) const;
+    // returns up to count entries starting from entry with given index, towards older entries if reverse is set
+    std::vector<UserHistory> getUserHistory(const UserId& userId, uint64_t index, size_t count, bool reverse) const;
     void addUserHistory(const UserId& userId, uint32_t page, const UserHistory& history);
 
     // user sponsors
     std::vector<UserSponsor> getUserSponsors(const UserId& userId, uint32_t page) const;
+    // returns up to count entries starting from entry with given index, towards older entries if reverse is set
+    std::vector<UserSponsor> getUserSponsors(const UserId& userId, uint64_t index, size_t count, bool reverse) const;
     void addUserSponsor(const UserId& userId, uint32_t page, const UserSponsor& history);
 
     // user updates
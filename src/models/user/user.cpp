@@ -27,6 +27,16 @@ User_cptr User::load(Serializer& s, uint32_t blockId)
     return user;
 }
 
+User_cptr User::load(const User_cptr& user, uint32_t blockId)
+{
+    if (!user->pendingUpdate || blockId < user->pendingUpdate->blockId) {
+        return user;
+    }
+    User_ptr updatedUser(new User(*user));
+    updatedUser->executePendingUpdate(blockId);
+    return updatedUser;
+}
+
 User_ptr User::clone(uint32_t blockId) const
 {
     User_ptr user = std::shared_ptr<User>(new User(*this));
@@ -59,6 +59,8 @@ public:
 
     // loads user
     static User_cptr load(Serializer& s, uint32_t blockId = 0);
+    // returns loaded user as it is in given block, executes pending update if needed
+    static User_cptr load(const User_cptr& user, uint32_t blockId);
 
     // creates next iteration of user
     User_ptr clone(uint32_t blockId) const;
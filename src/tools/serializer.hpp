@@ -63,6 +63,18 @@ public:
         m_reader = true;
     }
 
+    // creates non-owning reader over data, owner keeps data alive as long as serializer exists
+    Serializer(const char* data, size_t size, const std::shared_ptr<const void>& owner) :
+        m_view((const uint8_t*)data), m_viewSize(size), m_viewOwner(owner)
+    {
+        m_reader = true;
+    }
+
+    // creates non-owning reader over pinned database value (without copying it)
+    Serializer(const std::shared_ptr<const rocksdb::PinnableSlice>& slice) :
+        Serializer(slice->data(), slice->size(), slice)
+    {}
+
     Serializer(std::istream& ifs, const std::string& file = "") : m_file(file)
     {
         m_reader = true;
@@ -94,8 +106,13 @@ public:
         m_data = std::move(s.m_data);
         m_pos = s.m_pos;
         m_file = std::move(s.m_file);
+        m_view = s.m_view;
+        m_viewSize = s.m_viewSize;
+        m_viewOwner = std::move(s.m_viewOwner);
         s.m_data.clear();
         s.m_pos = 0;
+        s.m_view = nullptr;
+        s.m_viewSize = 0;
     }
 
     // creates serializer from base64/base64url data
@@ -173,16 +190,23 @@ public:
     bool reader() const { return m_reader; }
     // new data is being written to serializer
     bool writer() const { return !m_reader; }
-    size_t size() const { return reader() ? m_data.size() : m_pos; }
+    size_t size() const { return reader() ? dataSize() : m_pos; }
     size_t pos() const { return m_pos; }
     std::string file() const { return m_file; }
     bool eof() const { return reader() && pos() == size(); }
 
-    uint8_t* buffer() { return m_data.data(); }
-    const uint8_t* const buffer() const { return m_data.data(); }
+    // returns true if serializer doesn't own its data
+    bool view() const { return m_view != nullptr; }
 
-    const uint8_t* const begin() const { return m_data.data(); }
-    const uint8_t* const end() const { return m_data.data() + size(); }
+    uint8_t* buffer()
+    {
+        BOOST_ASSERT(!view());
+        return m_data.data();
+    }
+    const uint8_t* const buffer() const { return data(); }
+
+    const uint8_t* const begin() const { return data(); }
+    const uint8_t* const end() const { return data() + size(); }
 
     std::vector<uint8_t> dump() const { return std::vector<uint8_t>(begin(), end()); }
 
@@ -385,7 +409,7 @@ public:
         S size = (S)str.size();
         serialize<S>(size);
         if (reader()) {
-            if (m_pos + size > m_data.size()) {
+            if (m_pos + size > dataSize()) {
                 THROW_SERIALIZER_EXCEPTION("Serialzer::serialize string, pos + string_size > size");
             }
             str.resize(size);
@@ -602,7 +626,7 @@ public:
         }
         size_t size = v.size() - offset;
         if (reader()) {
-            if (m_pos + size * sizeof(T) > m_data.size()) {
+            if (m_pos + size * sizeof(T) > dataSize()) {
                 THROW_SERIALIZER_EXCEPTION("Serialzer::serialize array, pos + array_size > size");
             }
             read(v.data() + offset, size * sizeof(T));
@@ -741,9 +765,10 @@ public:
         if (reader()) {
             s.resize(size);
             s.m_pos = size;
-        }
-        for (uint32_t i = 0; i < size; ++i) {
-            serialize(s.m_data[i]);
+            read(s.m_data.data(), size);
+        } else {
+            // serialized serializer may be a view
+            write(s.data(), size);
         }
     }
 
@@ -801,7 +826,7 @@ public:
 
     std::string base64() const
     {
-        return base64url::encode(m_data.data(), size());
+        return base64url::encode(data(), size());
     }
 
     void putCompressedData(const Serializer& s)
@@ -871,10 +896,10 @@ private:
         if (!reader()) {
             THROW_SERIALIZER_EXCEPTION("Serialzer::read, can be used only by reader");
         }
-        if (m_pos + sizeof(T) > m_data.size()) {
+        if (m_pos + sizeof(T) > dataSize()) {
             THROW_SERIALIZER_EXCEPTION("Serialzer::read, pos + object_size > size");
         }
-        memcpy(&param, &m_data[m_pos], sizeof(T));
+        memcpy(&param, data() + m_pos, sizeof(T));
         m_pos += sizeof(T);
     }
 
@@ -883,10 +908,10 @@ private:
         if (size == 0) {
             return;
         }
-        if (m_pos + size > m_data.size()) {
-            THROW_SERIALIZER_EXCEPTION("Serialzer::read, pos + size > m_data.size()");
+        if (m_pos + size > dataSize()) {
+            THROW_SERIALIZER_EXCEPTION("Serialzer::read, pos + size > size");
         }
-        memcpy(data, &m_data[m_pos], size);
+        memcpy(data, this->data() + m_pos, size);
         m_pos += size;
     }
 
@@ -915,8 +940,19 @@ private:
         m_pos += size;
     }
 
+    const uint8_t* data() const
+    {
+        return m_view ? m_view : m_data.data();
+    }
+
+    size_t dataSize() const
+    {
+        return m_view ? m_viewSize : m_data.size();
+    }
+
     void resize(size_t minimum_size)
     {
+        BOOST_ASSERT(!view());
         if (m_data.capacity() < minimum_size) {
             size_t new_size = std::max(minimum_size, m_data.size() * 2);
             m_data.reserve(new_size);
@@ -928,6 +964,10 @@ private:
     std::vector<uint8_t> m_data;
     size_t m_pos = 0;
     std::string m_file;
+    // used by non-owning reader
+    const uint8_t* m_view = nullptr;
+    size_t m_viewSize = 0;
+    std::shared_ptr<const void> m_viewOwner;
 };
 
 }
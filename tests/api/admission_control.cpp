@@ -0,0 +1,130 @@
+#include "pch.h"
+
+#include <boost/test/unit_test.hpp>
+#include <api/admission_control.h>
+
+using namespace logpass;
+
+BOOST_AUTO_TEST_SUITE(admission_control);
+
+using Result = AdmissionControl::Result;
+
+BOOST_AUTO_TEST_CASE(rate_limits)
+{
+    AdmissionControl admission(10, 2);
+    auto now = chrono::steady_clock::now();
+    UserId user1(PrivateKey::generate().publicKey());
+    UserId user2(PrivateKey::generate().publicKey());
+    // users are charged when transactions are verified
+    auto admitAndCharge = [&](const std::string& address, const std::vector<UserId>& userIds) {
+        auto result = admission.admit(address, userIds, 1000, 1000, now);
+        if (result == Result::ADMITTED) {
+            admission.chargeUsers(userIds, now);
+        }
+        return result;
+    };
+
+    // user bucket holds 2 * BURST_SECONDS transactions
+    std::vector<UserId> userIds(2 * AdmissionControl::BURST_SECONDS, user1);
+    BOOST_TEST((admitAndCharge("1.1.1.1", userIds) == Result::ADMITTED));
+    BOOST_TEST((admitAndCharge("1.1.1.1", { user1 }) == Result::USER_RATE_LIMITED));
+    BOOST_TEST((admitAndCharge("1.1.1.1", { user2 }) == Result::ADMITTED));
+
+    // rejected batch doesn't take tokens
+    BOOST_TEST((admitAndCharge("1.1.1.1", { user2, user1 }) == Result::USER_RATE_LIMITED));
+    BOOST_TEST((admitAndCharge("2.2.2.2", { user2 }) == Result::ADMITTED));
+
+    // tokens are refilled with time
+    now += chrono::milliseconds(500);
+    BOOST_TEST((admitAndCharge("1.1.1.1", { user1 }) == Result::ADMITTED));
+    BOOST_TEST((admitAndCharge("1.1.1.1", { user1 }) == Result::USER_RATE_LIMITED));
+
+    // address bucket holds 10 * BURST_SECONDS transactions
+    std::vector<UserId> otherUserIds;
+    for (auto& key : PrivateKey::generate(10 * AdmissionControl::BURST_SECONDS)) {
+        otherUserIds.push_back(UserId(key.publicKey()));
+    }
+    BOOST_TEST((admission.admit("4.4.4.4", otherUserIds, 1000, 1000, now) == Result::ADMITTED));
+    BOOST_TEST((admission.admit("4.4.4.4", { user2 }, 1000, 1000, now) == Result::ADDRESS_RATE_LIMITED));
+    BOOST_TEST((admission.admit("3.3.3.3", { user2 }, 1000, 1000, now) == Result::ADMITTED));
+
+    auto info = admission.getDebugInfo();
+    BOOST_TEST(info["rejected"]["user_rate"] == 3);
+    BOOST_TEST(info["rejected"]["address_rate"] == 1);
+    BOOST_TEST(info["admitted"] == 12 * AdmissionControl::BURST_SECONDS + 4);
+}
+
+BOOST_AUTO_TEST_CASE(in_flight)
+{
+    AdmissionControl admission(0, 0);
+    UserId user(PrivateKey::generate().publicKey());
+    std::vector<UserId> userIds(3, user);
+
+    BOOST_TEST((admission.admit("1.1.1.1", userIds, 5, 1000) == Result::ADMITTED));
+    BOOST_TEST((admission.admit("1.1.1.1", userIds, 5, 1000) == Result::TOO_MANY_IN_FLIGHT));
+    BOOST_TEST(admission.getInFlight() == 3);
+    admission.release(1);
+    BOOST_TEST((admission.admit("1.1.1.1", userIds, 5, 1000) == Result::ADMITTED));
+    BOOST_TEST(admission.getInFlight() == 5);
+    admission.release(5);
+    BOOST_TEST(admission.getInFlight() == 0);
+    BOOST_TEST(admission.getDebugInfo()["rejected"]["in_flight"] == 1);
+}
+
+BOOST_AUTO_TEST_CASE(batch_above_capacity)
+{
+    AdmissionControl admission(10, 2);
+    BOOST_TEST(admission.getAddressCapacity() == 10 * AdmissionControl::BURST_SECONDS);
+    BOOST_TEST(admission.getUserCapacity() == 2 * AdmissionControl::BURST_SECONDS);
+
+    // batch bigger than bucket is rejected on idle node and doesn't take tokens
+    std::vector<UserId> userIds;
+    for (auto& key : PrivateKey::generate(10 * AdmissionControl::BURST_SECONDS + 1)) {
+        userIds.push_back(UserId(key.publicKey()));
+    }
+    BOOST_TEST((admission.admit("1.1.1.1", userIds, 1000, 1000) == Result::EXCEEDS_CAPACITY));
+    userIds.pop_back();
+    BOOST_TEST((admission.admit("1.1.1.1", userIds, 1000, 1000) == Result::ADMITTED));
+
+    UserId user(PrivateKey::generate().publicKey());
+    std::vector<UserId> sameUserIds(2 * AdmissionControl::BURST_SECONDS + 1, user);
+    BOOST_TEST((admission.admit("2.2.2.2", sameUserIds, 1000, 1000) == Result::EXCEEDS_CAPACITY));
+    sameUserIds.pop_back();
+    BOOST_TEST((admission.admit("2.2.2.2", sameUserIds, 1000, 1000) == Result::ADMITTED));
+
+    // without limits any batch fits
+    AdmissionControl unlimited(0, 0);
+    std::vector<UserId> bigBatch(1000, user);
+    BOOST_TEST((unlimited.admit("1.1.1.1", bigBatch, 1000, 1000) == Result::ADMITTED));
+
+    // batch bigger than pending transactions limit is rejected even without rate limits
+    BOOST_TEST((unlimited.admit("1.1.1.1", bigBatch, 1000, 999) == Result::EXCEEDS_CAPACITY));
+    BOOST_TEST((admission.admit("3.3.3.3", { user, user }, 1000, 1) == Result::EXCEEDS_CAPACITY));
+
+    BOOST_TEST(unlimited.getDebugInfo()["rejected"]["capacity"] == 1);
+    BOOST_TEST(admission.getDebugInfo()["rejected"]["capacity"] == 3);
+    BOOST_TEST(admission.getInFlight() == 12 * AdmissionControl::BURST_SECONDS);
+}
+
+BOOST_AUTO_TEST_CASE(forged_user_ids)
+{
+    AdmissionControl admission(10, 2);
+    auto now = chrono::steady_clock::now();
+    UserId victim(PrivateKey::generate().publicKey());
+
+    // transactions with forged user id fail signature verification, so user is not charged for them
+    for (size_t address = 0; address < 100; ++address) {
+        std::vector<UserId> userIds(2 * AdmissionControl::BURST_SECONDS, victim);
+        BOOST_TEST((admission.admit(std::to_string(address), userIds, 1000, 1000, now) == Result::ADMITTED));
+        admission.release(userIds.size());
+    }
+
+    // real user is not throttled
+    std::vector<UserId> userIds(2 * AdmissionControl::BURST_SECONDS, victim);
+    BOOST_TEST((admission.admit("1.1.1.1", userIds, 1000, 1000, now) == Result::ADMITTED));
+    admission.chargeUsers(userIds, now);
+    BOOST_TEST((admission.admit("1.1.1.1", { victim }, 1000, 1000, now) == Result::USER_RATE_LIMITED));
+    BOOST_TEST(admission.getDebugInfo()["rejected"]["user_rate"] == 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,33 @@
+#include "pch.h"
+
+#include <boost/test/unit_test.hpp>
+#include <api/api_server.h>
+
+using namespace logpass;
+
+BOOST_AUTO_TEST_SUITE(api_server);
+
+using Format = ApiServer::Format;
+
+BOOST_AUTO_TEST_CASE(accepted_format)
+{
+    BOOST_TEST((ApiServer::getAcceptedFormat("") == Format::JSON));
+    BOOST_TEST((ApiServer::getAcceptedFormat("text/html") == Format::JSON));
+    BOOST_TEST((ApiServer::getAcceptedFormat("application/cbor") == Format::CBOR));
+    BOOST_TEST((ApiServer::getAcceptedFormat("application/x-msgpack") == Format::MSGPACK));
+    BOOST_TEST((ApiServer::getAcceptedFormat("text/html, application/octet-stream") == Format::BINARY));
+
+    // format with highest quality is chosen, not the first supported one
+    BOOST_TEST((ApiServer::getAcceptedFormat("application/json, application/octet-stream;q=0.1") == Format::JSON));
+    BOOST_TEST((ApiServer::getAcceptedFormat("application/json;q=0.5, application/cbor") == Format::CBOR));
+    BOOST_TEST((ApiServer::getAcceptedFormat("application/msgpack; charset=utf-8; q=0.8, */*;q=0.2") ==
+                Format::MSGPACK));
+
+    // on equal quality first listed format is chosen
+    BOOST_TEST((ApiServer::getAcceptedFormat("application/cbor, application/msgpack") == Format::CBOR));
+
+    // formats with zero quality are not accepted
+    BOOST_TEST((ApiServer::getAcceptedFormat("application/octet-stream;q=0") == Format::JSON));
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -324,6 +324,64 @@ BOOST_AUTO_TEST_CASE(create_and_update_prefixes)
     BOOST_TEST_REQUIRE(db->confirmed().storage.getPrefixesCount() == prefixIds.size());
 }
 
+BOOST_AUTO_TEST_CASE(post_transactions_batch)
+{
+    auto keys = PrivateKey::generate(3);
+    uint32_t blockId = blockchain->getLatestBlockId();
+    std::vector<Transaction_cptr> transactions;
+    std::vector<UserId> userIds;
+    for (auto& key : keys) {
+        transactions.push_back(CreateUserTransaction::create(key.publicKey(), blockId)->
+                               setUserId(blockchain->getUserId())->sign({ blockchain->getMinerKey() }));
+        userIds.push_back(UserId(key.publicKey()));
+    }
+    // signed by wrong key
+    transactions.push_back(CreateUserTransaction::create(PublicKey::generateRandom(), blockId)->
+                           setUserId(blockchain->getUserId())->sign({ keys[0] }));
+
+    auto post = [&] {
+        auto p = std::make_shared<std::promise<std::shared_ptr<std::vector<PostTransactionResult>>>>();
+        blockchain->postTransactions(transactions, (PostTransactionsCallback)[p](auto results) {
+            p->set_value(results);
+        });
+        auto f = p->get_future();
+        BOOST_TEST_REQUIRE((f.wait_for(chrono::seconds(3)) == std::future_status::ready));
+        return f.get();
+    };
+
+    auto results = post();
+    BOOST_TEST_REQUIRE(results->size() == transactions.size());
+    for (size_t i = 0; i < keys.size(); ++i) {
+        BOOST_TEST_REQUIRE((*results)[i]);
+        BOOST_TEST_REQUIRE((*results)[i].getTransactionId() == transactions[i]->getId());
+    }
+    BOOST_TEST_REQUIRE((*results)[keys.size()].getStatus() == "SIGNATURE_ERROR");
+    // already executed transactions are accepted again
+    results = post();
+    for (size_t i = 0; i < keys.size(); ++i) {
+        BOOST_TEST_REQUIRE((*results)[i]);
+    }
+
+    auto users = db->unconfirmed().users.getUsers(userIds);
+    BOOST_TEST_REQUIRE(users.size() == userIds.size());
+    for (size_t i = 0; i < userIds.size(); ++i) {
+        BOOST_TEST_REQUIRE(users[i]);
+        BOOST_TEST_REQUIRE(users[i]->getId() == userIds[i]);
+    }
+    BOOST_TEST_REQUIRE(!db->confirmed().users.getUsers(userIds)[0]);
+
+    std::vector<TransactionId> transactionIds = { transactions[0]->getId(), transactions[3]->getId() };
+    auto transactionsWithBlockIds = blockchain->getTransactionsWithBlockIds(transactionIds);
+    BOOST_TEST_REQUIRE(transactionsWithBlockIds[0].first);
+    BOOST_TEST_REQUIRE(transactionsWithBlockIds[0].second == 0);
+    BOOST_TEST_REQUIRE(!transactionsWithBlockIds[1].first);
+
+    BOOST_TEST_REQUIRE(blockchain->mineAndAddBlock());
+    transactionsWithBlockIds = blockchain->getTransactionsWithBlockIds(transactionIds);
+    BOOST_TEST_REQUIRE(transactionsWithBlockIds[0].first);
+    BOOST_TEST_REQUIRE(transactionsWithBlockIds[0].second == blockchain->getLatestBlockId());
+}
+
 BOOST_AUTO_TEST_CASE(events_basic)
 {
     std::promise<Block_cptr> blockPromise;
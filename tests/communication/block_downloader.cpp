@@ -0,0 +1,80 @@
+#include "pch.h"
+
+#include <boost/test/unit_test.hpp>
+#include <blockchain/block/block.h>
+#include <blockchain/transactions/create_user.h>
+#include <communication/block_downloader.h>
+
+using namespace logpass;
+
+BOOST_AUTO_TEST_SUITE(block_downloader);
+
+BOOST_AUTO_TEST_CASE(assignments)
+{
+    auto key = PrivateKey::generate();
+    auto miner1 = MinerId(PrivateKey::generate().publicKey());
+    auto miner2 = MinerId(PrivateKey::generate().publicKey());
+
+    std::vector<Transaction_cptr> transactions = {
+        CreateUserTransaction::create(1, -1, key.publicKey(), 4)->setUserId(key.publicKey())->sign({ key }),
+        CreateUserTransaction::create(2, -1, key.publicKey(), 4)->setUserId(key.publicKey())->sign({ key }),
+    };
+    MinersQueue nextMiners = { MinerId(key.publicKey()) };
+    auto block = Block::create(2, 2, nextMiners, transactions, Hash(), key);
+    auto pendingBlock = std::make_shared<PendingBlock>(block->getBlockHeader(), key.publicKey(),
+                                                       [](PendingBlock_ptr) {});
+
+    BlockDownloader downloader;
+    downloader.addPendingBlock(pendingBlock);
+
+    // block without body can't be split
+    BOOST_TEST(!downloader.assign(pendingBlock, miner1, true));
+    BOOST_TEST_REQUIRE(pendingBlock->addBlockBody(block->getBlockBody()) == PendingBlock::AddResult::CORRECT);
+
+    auto assignment1 = downloader.assign(pendingBlock, miner1, true);
+    BOOST_TEST_REQUIRE(assignment1.has_value());
+    BOOST_TEST(assignment1->status == PendingBlock::Status::MISSING_TRANSACTION_IDS);
+    BOOST_TEST(assignment1->transactionIdsHashes.size() == 1);
+
+    // helper gets only not assigned parts
+    BOOST_TEST(!downloader.assign(pendingBlock->getDepth(), miner2));
+    // endgame assigns the same part to other miner, but not to the same one
+    BOOST_TEST(!downloader.assign(pendingBlock, miner1, true));
+    auto assignment2 = downloader.assign(pendingBlock, miner2, true);
+    BOOST_TEST_REQUIRE(assignment2.has_value());
+    BOOST_TEST((assignment2->transactionIdsHashes == assignment1->transactionIdsHashes));
+
+    // failed miner isn't used as helper of that block anymore
+    downloader.finish(*assignment1, miner1, 0, chrono::milliseconds(10), false);
+    downloader.cancel(miner2);
+    BOOST_TEST(!downloader.assign(pendingBlock->getDepth(), miner1));
+    BOOST_TEST(!downloader.assign(pendingBlock->getDepth() - 1, miner2));
+    BOOST_TEST(downloader.assign(pendingBlock->getDepth(), miner2).has_value());
+
+    // downloaded transaction ids make transactions downloadable
+    BOOST_TEST_REQUIRE(pendingBlock->addBlockTransactionIds(block->getBlockTransactionIds()[0]) ==
+                       PendingBlock::AddResult::CORRECT);
+    auto assignment3 = downloader.assign(pendingBlock, miner1, true);
+    BOOST_TEST_REQUIRE(assignment3.has_value());
+    BOOST_TEST(assignment3->status == PendingBlock::Status::MISSING_TRANSACTIONS);
+    BOOST_TEST(assignment3->transactionIds.size() == transactions.size());
+}
+
+BOOST_AUTO_TEST_CASE(max_pending_blocks)
+{
+    auto key = PrivateKey::generate();
+    auto miner = MinerId(PrivateKey::generate().publicKey());
+    MinersQueue nextMiners = { MinerId(key.publicKey()) };
+    auto block = Block::create(2, 2, nextMiners, {}, Hash(), key);
+
+    // blocks added by assign are limited in the same way as added ones
+    BlockDownloader downloader;
+    for (size_t i = 0; i < BlockDownloader::MAX_PENDING_BLOCKS + 2; ++i) {
+        auto pendingBlock = std::make_shared<PendingBlock>(block->getBlockHeader(), key.publicKey(),
+                                                           [](PendingBlock_ptr) {});
+        BOOST_TEST(!downloader.assign(pendingBlock, miner, true));
+    }
+    BOOST_TEST(downloader.getDebugInfo()["pending_blocks"].size() == BlockDownloader::MAX_PENDING_BLOCKS);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
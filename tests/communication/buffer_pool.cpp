@@ -0,0 +1,63 @@
+#include "pch.h"
+
+#include <boost/test/unit_test.hpp>
+#include <communication/connection/buffer_pool.h>
+
+using namespace logpass;
+
+BOOST_AUTO_TEST_SUITE(buffer_pool);
+
+BOOST_AUTO_TEST_CASE(reuse)
+{
+    BufferPool pool(1024 * 1024);
+    uint8_t* data = nullptr;
+    {
+        auto buffer = pool.get(100 * 1024);
+        BOOST_TEST_REQUIRE(buffer);
+        BOOST_TEST(buffer.size() == 128 * 1024);
+        data = buffer.data();
+        BOOST_TEST(pool.getDebugInfo()["borrowed_buffers"] == 1);
+    }
+    BOOST_TEST(pool.getDebugInfo()["borrowed_buffers"] == 0);
+    BOOST_TEST(pool.getDebugInfo()["free_bytes"] == 128 * 1024);
+
+    // buffer of the same class is reused
+    auto buffer = pool.get(70 * 1024);
+    BOOST_TEST(buffer.data() == data);
+    BOOST_TEST(pool.getDebugInfo()["reuses"] == 1);
+    BOOST_TEST(pool.getDebugInfo()["allocations"] == 1);
+
+    // buffer of other class is allocated
+    auto buffer2 = pool.get(200 * 1024);
+    BOOST_TEST(buffer2.size() == 256 * 1024);
+    BOOST_TEST(pool.getDebugInfo()["allocations"] == 2);
+
+    // moved buffer is returned to pool only once
+    BufferPool::Buffer buffer3 = std::move(buffer2);
+    BOOST_TEST(!buffer2);
+    buffer3 = BufferPool::Buffer();
+    BOOST_TEST(pool.getDebugInfo()["borrowed_buffers"] == 1);
+}
+
+BOOST_AUTO_TEST_CASE(limits)
+{
+    BufferPool pool(1024 * 1024);
+
+    // buffers bigger than the biggest class are not kept
+    {
+        auto buffer = pool.get(2 * 1024 * 1024);
+        BOOST_TEST(buffer.size() == 2 * 1024 * 1024);
+    }
+    BOOST_TEST(pool.getDebugInfo()["free_bytes"] == 0);
+
+    // only MAX_FREE_BUFFERS are kept in every class
+    {
+        std::vector<BufferPool::Buffer> buffers;
+        for (size_t i = 0; i < BufferPool::MAX_FREE_BUFFERS + 2; ++i) {
+            buffers.push_back(pool.get(BufferPool::MIN_CLASS_SIZE));
+        }
+    }
+    BOOST_TEST(pool.getDebugInfo()["free_bytes"] == BufferPool::MAX_FREE_BUFFERS * BufferPool::MIN_CLASS_SIZE);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
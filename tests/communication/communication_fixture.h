@@ -1,6 +1,7 @@
 #pragma once
 
 #include <communication/communication_test.h>
+#include <communication/connection/simulated_network.h>
 #include <blockchain/blockchain_fixture.h>
 
 namespace logpass {
@@ -99,6 +100,8 @@ struct CommunicationFixture {
         for (size_t i = 0; i < size; ++i) {
             communicationOptions.host = "127.0.0.1";
             communicationOptions.port = m_port + i;
+            communicationOptions.simulatedNetwork = simulatedNetwork;
+            endpoints.emplace_back(communicationOptions.host, communicationOptions.port);
             size_t idx = communications.size();
             auto blockchain = std::dynamic_pointer_cast<Blockchain>((std::shared_ptr<BlockchainTest>)blockchains[idx]);
             communications.push_back(SharedThread<CommunicationTest>(communicationOptions, blockchain, databases[idx]));
@@ -263,6 +266,9 @@ struct CommunicationFixture {
     }
 
     uint16_t m_port = 30050;
+    // if set before adding instances, they are connected by simulated network instead of tcp
+    std::shared_ptr<SimulatedNetwork> simulatedNetwork;
+    std::vector<Endpoint> endpoints;
     std::vector<std::shared_ptr<BlockchainFixture>> fixtures;
     std::vector<std::shared_ptr<Database>> databases;
     std::vector<std::shared_ptr<BlockchainTest>> blockchains;
@@ -2,7 +2,10 @@
 
 #include <boost/test/unit_test.hpp>
 #include <communication/connection/secure_connection.h>
+#include <communication/connection/simulated_connection.h>
 #include <communication/connection_manager.h>
+#include <communication/packets/get_block_header.h>
+#include <communication/packets/new_transactions.h>
 
 using namespace logpass;
 
@@ -76,4 +79,111 @@ BOOST_AUTO_TEST_CASE(basic)
     context.run_for(chrono::seconds(1));
 }
 
+BOOST_AUTO_TEST_CASE(session_resumption)
+{
+    auto keys = PrivateKey::generate(2);
+    auto serverCertificate = std::make_shared<Certificate>(keys[1]);
+    auto clientCertificate = std::make_shared<Certificate>(keys[0]);
+    ConnectionCallbacks callbacks{
+        [&](auto connection) { return; },
+        [&](auto connection, auto minerId) { return true; },
+        [&](auto connection) { return true; },
+        [&](auto connection, auto packet) { return true; }
+    };
+    asio::io_context context;
+    asio::ip::tcp::acceptor acceptor(context);
+    boost::asio::ip::tcp::endpoint endpoint(boost::asio::ip::make_address("127.0.0.1"), 30041);
+    acceptor.open(endpoint.protocol());
+    acceptor.set_option(boost::asio::ip::tcp::acceptor::reuse_address(true));
+    acceptor.bind(endpoint);
+    acceptor.listen(100);
+
+    std::vector<std::shared_ptr<SecureConnection>> clients, servers;
+    for (size_t i = 0; i < 3; ++i) {
+        acceptor.async_accept([&](boost::system::error_code ec, auto socket) {
+            BOOST_TEST_REQUIRE(!ec);
+            auto connection = std::make_shared<SecureConnection>(context, std::move(socket), serverCertificate,
+                                                                 keys[1].publicKey(), MinerId(), callbacks);
+            connection->start();
+            servers.push_back(connection);
+        });
+        auto connection = std::make_shared<SecureConnection>(context, asio::ip::tcp::socket(context),
+                                                             clientCertificate, keys[0].publicKey(),
+                                                             keys[1].publicKey(), callbacks);
+        connection->start(Endpoint("127.0.0.1", 30041));
+        clients.push_back(connection);
+        context.run_for(chrono::seconds(1));
+        BOOST_TEST_REQUIRE(servers.size() == i + 1);
+        BOOST_TEST_REQUIRE(clients[i]->isAccepted());
+        BOOST_TEST_REQUIRE(servers[i]->isAccepted());
+        BOOST_TEST(servers[i]->getMinerId() == MinerId(keys[0].publicKey()));
+        // first connection gets session ticket, next ones resume it
+        BOOST_TEST(clients[i]->isSessionResumed() == (i > 0));
+        BOOST_TEST(servers[i]->isSessionResumed() == (i > 0));
+        clients[i]->close();
+        servers[i]->close();
+        context.run_for(chrono::milliseconds(100));
+    }
+    acceptor.close();
+}
+
+BOOST_AUTO_TEST_CASE(send_priorities)
+{
+    auto keys = PrivateKey::generate(2);
+    asio::io_context context;
+    Endpoint firstEndpoint("127.0.0.1", 1), secondEndpoint("127.0.0.1", 2);
+    auto network = std::make_shared<SimulatedNetwork>(1, SimulatedLink{ .bandwidth = 4 * 1024 * 1024 });
+
+    std::vector<uint8_t> receivedPackets;
+    ConnectionCallbacks callbacks{
+        [&](auto connection) { return; },
+        [&](auto connection, auto minerId) { return true; },
+        [&](auto connection) { return true; },
+        [&](auto connection, auto packet) {
+            receivedPackets.push_back(packet->getType());
+            return true;
+        }
+    };
+    std::shared_ptr<SimulatedConnection> c2;
+    network->listen(secondEndpoint, [&](auto remote, auto endpoint) {
+        c2 = std::make_shared<SimulatedConnection>(context, network, secondEndpoint, keys[1].publicKey(), MinerId(),
+                                                   callbacks);
+        c2->setRemote(remote, endpoint);
+        asio::post(c2->getStrand(), [&] { c2->start(); });
+        return c2;
+    });
+    auto c1 = std::make_shared<SimulatedConnection>(context, network, firstEndpoint, keys[0].publicKey(),
+                                                    keys[1].publicKey(), callbacks);
+    asio::post(c1->getStrand(), [&] { c1->start(secondEndpoint); });
+    context.run_for(chrono::milliseconds(500));
+    BOOST_TEST_REQUIRE(c2);
+    BOOST_TEST_REQUIRE(c1->isAccepted());
+
+    // gossip above limit of its queue is dropped, block header request is sent before it
+    asio::post(c1->getStrand(), [&] {
+        for (size_t i = 0; i < 160; ++i) {
+            std::set<TransactionId> transactionIds;
+            for (size_t j = 0; j < 1000; ++j) {
+                transactionIds.insert(TransactionId(1, 1, 100, Hash::generateRandom()));
+            }
+            c1->send(NewTransactionsPacket::create(transactionIds));
+        }
+        c1->send(GetBlockHeaderPacket::create({ { 1, Hash::generateRandom() } }));
+    });
+    context.run_for(chrono::seconds(3));
+
+    BOOST_TEST_REQUIRE(!c1->isClosed());
+    BOOST_TEST_REQUIRE(!receivedPackets.empty());
+    BOOST_TEST(receivedPackets.front() == GetBlockHeaderPacket::TYPE);
+    BOOST_TEST(receivedPackets.size() < 161);
+    auto debugInfo = c1->getDebugInfo();
+    BOOST_TEST(debugInfo["send_queues"][(size_t)PacketPriority::TRANSACTIONS]["dropped_messages"] ==
+               161 - receivedPackets.size());
+
+    c1->close();
+    c2->close();
+    context.run_for(chrono::milliseconds(500));
+    network->unlisten(secondEndpoint);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -23,8 +23,8 @@ public:
     void start() override {};
     void start(const Endpoint& endpoint) override {};
 
-    void read() override {};
-    void write(const Serializer_cptr& msg) override {};
+    void readSome(const asio::mutable_buffer& buffer) override {};
+    void write(const std::vector<asio::const_buffer>& buffers) override {};
 };
 
 /*
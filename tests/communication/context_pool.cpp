@@ -0,0 +1,46 @@
+#include "pch.h"
+
+#include <boost/test/unit_test.hpp>
+#include <communication/context_pool.h>
+
+using namespace logpass;
+
+BOOST_AUTO_TEST_SUITE(context_pool);
+
+BOOST_AUTO_TEST_CASE(basic)
+{
+    ContextPool pool(3);
+    BOOST_TEST_REQUIRE(pool.getSize() == 3);
+    pool.start();
+
+    std::mutex mutex;
+    std::set<std::thread::id> threads;
+    std::atomic<size_t> executedTasks = 0;
+    for (size_t i = 0; i < 30; ++i) {
+        asio::post(pool.getContext(), [&] {
+            std::lock_guard lock(mutex);
+            threads.insert(std::this_thread::get_id());
+            executedTasks += 1;
+        });
+    }
+
+    // stop waits for all posted tasks
+    pool.stop();
+    BOOST_TEST(executedTasks == 30);
+    BOOST_TEST(threads.size() == 3);
+    BOOST_TEST(!threads.contains(std::this_thread::get_id()));
+}
+
+BOOST_AUTO_TEST_CASE(round_robin)
+{
+    ContextPool pool(2);
+    auto& context1 = pool.getContext();
+    auto& context2 = pool.getContext();
+    BOOST_TEST(&context1 != &context2);
+    BOOST_TEST(&pool.getContext() == &context1);
+    BOOST_TEST(&pool.getContext() == &context2);
+    pool.start();
+    pool.stop();
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,56 @@
+#include "pch.h"
+
+#include <boost/test/unit_test.hpp>
+#include <blockchain/transactions/create_user.h>
+#include <communication/packets/get_block_transactions.h>
+
+using namespace logpass;
+
+BOOST_AUTO_TEST_SUITE(get_block_transactions);
+
+BOOST_AUTO_TEST_CASE(merge_chunks)
+{
+    auto key = PrivateKey::generate();
+    std::vector<Transaction_cptr> transactions;
+    for (uint32_t i = 1; i <= 4; ++i) {
+        transactions.push_back(CreateUserTransaction::create(i, -1, key.publicKey(), 4)->setUserId(key.publicKey())
+                               ->sign({ key }));
+    }
+    std::vector<TransactionId> ids;
+    for (auto& transaction : transactions) {
+        ids.push_back(transaction->getId());
+    }
+    BlockTransactionIds transactionIds1(std::vector<TransactionId>{ ids[0], ids[1] });
+    BlockTransactionIds transactionIds2(std::vector<TransactionId>{ ids[2], ids[3] });
+
+    // first transaction of each chunk is known locally, second one is received
+    std::vector<GetBlockTransactionsPacket::Chunk> chunks = {
+        { .index = 0, .hash = transactionIds1.getHash(), .transactionIds = { ids[0], TransactionId() },
+          .positions = { 1 } },
+        { .index = 1, .hash = transactionIds2.getHash(), .transactionIds = { ids[2], TransactionId() },
+          .positions = { 1 } }
+    };
+    auto merged = GetBlockTransactionsPacket::mergeChunks(chunks, { transactions[1], transactions[3] });
+    BOOST_TEST_REQUIRE(merged.blockTransactionIds.size() == 2);
+    BOOST_TEST(merged.blockTransactionIds[1]->getHash() == transactionIds2.getHash());
+    BOOST_TEST(merged.transactions.size() == 2);
+    BOOST_TEST(merged.mismatchedChunks.empty());
+
+    // short id matched wrong local transaction in first chunk, its transactions are not used
+    chunks[0].transactionIds = { ids[2], TransactionId() };
+    chunks[1].transactionIds = { ids[2], TransactionId() };
+    merged = GetBlockTransactionsPacket::mergeChunks(chunks, { transactions[1], transactions[3] });
+    BOOST_TEST_REQUIRE(merged.blockTransactionIds.size() == 1);
+    BOOST_TEST(merged.blockTransactionIds[0]->getHash() == transactionIds2.getHash());
+    BOOST_TEST_REQUIRE(merged.transactions.size() == 1);
+    BOOST_TEST(merged.transactions[0] == transactions[3]);
+    BOOST_TEST((merged.mismatchedChunks == std::vector<uint32_t>{ 0 }));
+
+    // wrong received transaction
+    chunks[0].transactionIds = { ids[0], TransactionId() };
+    merged = GetBlockTransactionsPacket::mergeChunks(chunks, { transactions[3], transactions[3] });
+    BOOST_TEST(merged.blockTransactionIds.size() == 1);
+    BOOST_TEST((merged.mismatchedChunks == std::vector<uint32_t>{ 0 }));
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,71 @@
+#include "pch.h"
+
+#include <boost/test/unit_test.hpp>
+#include <communication/connection/simulated_network.h>
+
+using namespace logpass;
+
+BOOST_AUTO_TEST_SUITE(simulated_network);
+
+BOOST_AUTO_TEST_CASE(transmit)
+{
+    Endpoint first("127.0.0.1", 1), second("127.0.0.1", 2);
+    SimulatedNetwork network(1, SimulatedLink{ .latency = chrono::milliseconds(100), .bandwidth = 1000 });
+
+    // data is delivered after it's sent and latency passes
+    auto now = chrono::steady_clock::now();
+    auto transmission = network.transmit(first, second, 100);
+    BOOST_TEST_REQUIRE(transmission.has_value());
+    BOOST_TEST((transmission->sent - now >= chrono::milliseconds(100)));
+    BOOST_TEST((transmission->delivered - transmission->sent == chrono::milliseconds(100)));
+
+    // next data waits for previous one
+    auto nextTransmission = network.transmit(first, second, 100);
+    BOOST_TEST_REQUIRE(nextTransmission.has_value());
+    BOOST_TEST((nextTransmission->sent - transmission->sent >= chrono::milliseconds(100)));
+
+    // other direction has own bandwidth
+    network.setLink(second, first, SimulatedLink{ .latency = chrono::milliseconds(10) });
+    auto backTransmission = network.transmit(second, first, 1'000'000);
+    BOOST_TEST_REQUIRE(backTransmission.has_value());
+    BOOST_TEST((backTransmission->delivered < transmission->delivered));
+}
+
+BOOST_AUTO_TEST_CASE(jitter)
+{
+    Endpoint first("127.0.0.1", 1), second("127.0.0.1", 2);
+    SimulatedLink link{ .latency = chrono::milliseconds(10), .jitter = chrono::milliseconds(50) };
+    SimulatedNetwork network(1, link);
+
+    // delays never reorder data of link
+    auto lastDelivered = chrono::steady_clock::time_point();
+    for (size_t i = 0; i < 100; ++i) {
+        auto transmission = network.transmit(first, second, 10);
+        BOOST_TEST_REQUIRE(transmission.has_value());
+        BOOST_TEST((transmission->delivered >= lastDelivered));
+        BOOST_TEST((transmission->delivered - transmission->sent <= link.latency + link.jitter));
+        lastDelivered = transmission->delivered;
+    }
+}
+
+BOOST_AUTO_TEST_CASE(partitions)
+{
+    Endpoint first("127.0.0.1", 1), second("127.0.0.1", 2), third("127.0.0.1", 3);
+    SimulatedNetwork network;
+
+    network.partition({ { first, second } });
+    BOOST_TEST(network.canCommunicate(first, second));
+    BOOST_TEST(!network.canCommunicate(first, third));
+    BOOST_TEST(!network.transmit(third, second, 10).has_value());
+    BOOST_TEST(network.transmit(second, first, 10).has_value());
+    BOOST_TEST(network.getDebugInfo()["dropped_bytes"] == 10);
+
+    // there's no listener
+    BOOST_TEST(network.connect(nullptr, first, second) == nullptr);
+
+    network.heal();
+    BOOST_TEST(network.canCommunicate(first, third));
+    BOOST_TEST(network.transmit(third, second, 10).has_value());
+}
+
+BOOST_AUTO_TEST_SUITE_END();
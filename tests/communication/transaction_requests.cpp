@@ -0,0 +1,36 @@
+#include "pch.h"
+
+#include <boost/test/unit_test.hpp>
+#include <communication/transaction_requests.h>
+
+using namespace logpass;
+
+BOOST_AUTO_TEST_SUITE(transaction_requests);
+
+BOOST_AUTO_TEST_CASE(basic)
+{
+    auto miner1 = MinerId(PrivateKey::generate().publicKey());
+    auto miner2 = MinerId(PrivateKey::generate().publicKey());
+    auto transactionId1 = TransactionId(1, 1, 100, Hash::generateRandom());
+    auto transactionId2 = TransactionId(1, 2, 100, Hash::generateRandom());
+
+    TransactionRequests requests;
+    BOOST_TEST(requests.request(transactionId1, miner1));
+    BOOST_TEST(requests.request(transactionId1, miner1));
+    BOOST_TEST(!requests.request(transactionId1, miner2));
+    BOOST_TEST(requests.request(transactionId2, miner2));
+
+    // finished request of other miner doesn't remove request
+    requests.finish({ transactionId1 }, miner2);
+    BOOST_TEST(!requests.request(transactionId1, miner2));
+    requests.finish({ transactionId1 }, miner1);
+    BOOST_TEST(requests.request(transactionId1, miner2));
+
+    // disconnected miner releases all its requests
+    requests.cancel(miner2);
+    BOOST_TEST(requests.request(transactionId1, miner1));
+    BOOST_TEST(requests.request(transactionId2, miner1));
+    BOOST_TEST(requests.getDebugInfo()["requested_transactions"] == 2);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
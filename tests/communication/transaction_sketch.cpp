@@ -0,0 +1,69 @@
+#include "pch.h"
+
+#include <boost/test/unit_test.hpp>
+#include <communication/transaction_sketch.h>
+
+using namespace logpass;
+
+BOOST_AUTO_TEST_SUITE(transaction_sketch);
+
+BOOST_AUTO_TEST_CASE(difference)
+{
+    uint64_t salt = ShortTransactionIds::generateSalt();
+    std::vector<uint64_t> common, local, remote;
+    for (uint32_t i = 0; i < 2000; ++i) {
+        auto shortTransactionId = ShortTransactionIds::calculateValue(salt, TransactionId(1, i, 100,
+                                                                                          Hash::generateRandom()));
+        if (i < 50) {
+            local.push_back(shortTransactionId);
+        } else if (i < 80) {
+            remote.push_back(shortTransactionId);
+        } else {
+            common.push_back(shortTransactionId);
+        }
+    }
+
+    TransactionSketch localSketch(TransactionSketch::getCells(local.size() + remote.size()));
+    TransactionSketch remoteSketch(localSketch.size());
+    BOOST_TEST_REQUIRE(localSketch.isValid());
+    for (auto shortTransactionId : common) {
+        localSketch.add(shortTransactionId);
+        remoteSketch.add(shortTransactionId);
+    }
+    for (auto shortTransactionId : local) {
+        localSketch.add(shortTransactionId);
+    }
+    for (auto shortTransactionId : remote) {
+        remoteSketch.add(shortTransactionId);
+    }
+
+    // sketch must survive serialization
+    Serializer s;
+    s(remoteSketch);
+    s.switchToReader();
+    TransactionSketch receivedSketch;
+    s(receivedSketch);
+    BOOST_TEST_REQUIRE(receivedSketch.size() == remoteSketch.size());
+
+    receivedSketch.subtract(localSketch);
+    std::vector<uint64_t> added, removed;
+    BOOST_TEST_REQUIRE(receivedSketch.decode(added, removed));
+    std::sort(added.begin(), added.end());
+    std::sort(removed.begin(), removed.end());
+    std::sort(local.begin(), local.end());
+    std::sort(remote.begin(), remote.end());
+    BOOST_TEST(added == remote);
+    BOOST_TEST(removed == local);
+}
+
+BOOST_AUTO_TEST_CASE(too_big_difference)
+{
+    TransactionSketch sketch(TransactionSketch::MIN_CELLS);
+    for (uint64_t i = 0; i < 1000; ++i) {
+        sketch.add(i);
+    }
+    std::vector<uint64_t> added, removed;
+    BOOST_TEST(!sketch.decode(added, removed));
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,89 @@
+#include "pch.h"
+
+#include <boost/test/unit_test.hpp>
+#include <blockchain/pending_transactions.h>
+#include <blockchain/transactions/create_user.h>
+#include <crypto/short_transaction_ids.h>
+
+using namespace logpass;
+
+BOOST_AUTO_TEST_SUITE(short_transaction_ids);
+
+BOOST_AUTO_TEST_CASE(calculate)
+{
+    auto transactionId = TransactionId(1, 1, 100, Hash::generateRandom());
+    auto otherTransactionId = TransactionId(1, 2, 100, Hash::generateRandom());
+
+    // short id depends on salt
+    BOOST_TEST((ShortTransactionIds::calculate(1, transactionId) == ShortTransactionIds::calculate(1, transactionId)));
+    BOOST_TEST((ShortTransactionIds::calculate(1, transactionId) != ShortTransactionIds::calculate(2, transactionId)));
+    BOOST_TEST((ShortTransactionIds::calculate(1, transactionId) !=
+                ShortTransactionIds::calculate(1, otherTransactionId)));
+}
+
+BOOST_AUTO_TEST_CASE(lookup)
+{
+    uint64_t salt = ShortTransactionIds::generateSalt();
+    std::vector<TransactionId> transactionIds;
+    for (uint32_t i = 0; i < 1000; ++i) {
+        transactionIds.push_back(TransactionId(1, i, 100, Hash::generateRandom()));
+    }
+
+    ShortTransactionIds shortTransactionIds(salt);
+    shortTransactionIds.addTransactionIds(transactionIds);
+    // adding same ids again doesn't create collisions
+    shortTransactionIds.addTransactionIds(transactionIds);
+    BOOST_TEST(shortTransactionIds.getSalt() == salt);
+
+    for (auto& transactionId : transactionIds) {
+        auto found = shortTransactionIds.getTransactionId(ShortTransactionIds::calculate(salt, transactionId));
+        BOOST_TEST_REQUIRE(found != nullptr);
+        BOOST_TEST(*found == transactionId);
+    }
+
+    auto unknownTransactionId = TransactionId(1, 1000, 100, Hash::generateRandom());
+    BOOST_TEST(shortTransactionIds.getTransactionId(ShortTransactionIds::calculate(salt, unknownTransactionId)) ==
+               nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(pending_transactions_index)
+{
+    auto key = PrivateKey::generate();
+    std::vector<Transaction_cptr> transactions;
+    for (uint32_t i = 1; i <= 10; ++i) {
+        transactions.push_back(CreateUserTransaction::create(i, -1, key.publicKey(), 4)->setUserId(key.publicKey())
+                               ->sign({ key }));
+    }
+
+    PendingTransactions pendingTransactions;
+    pendingTransactions.addTransactions(std::vector<Transaction_cptr>(transactions.begin(), transactions.begin() + 5),
+                                        MinerId());
+    pendingTransactions.addExecutedTransactions(std::vector<Transaction_cptr>(transactions.begin() + 5,
+                                                                              transactions.end()));
+
+    // index and full scan with other salt give the same result
+    uint64_t salt = pendingTransactions.getShortTransactionIdsSalt();
+    for (uint64_t lookupSalt : { salt, salt + 1 }) {
+        std::set<uint64_t> shortTransactionIds;
+        for (auto& transaction : transactions) {
+            shortTransactionIds.insert(ShortTransactionIds::calculateValue(lookupSalt, transaction->getId()));
+        }
+        auto unknownTransactionId = TransactionId(1, 1000, 100, Hash::generateRandom());
+        shortTransactionIds.insert(ShortTransactionIds::calculateValue(lookupSalt, unknownTransactionId));
+
+        auto transactionIds = pendingTransactions.getTransactionIds(lookupSalt, shortTransactionIds);
+        BOOST_TEST_REQUIRE(transactionIds.size() == transactions.size());
+        for (auto& transaction : transactions) {
+            auto it = transactionIds.find(ShortTransactionIds::calculateValue(lookupSalt, transaction->getId()));
+            BOOST_TEST_REQUIRE((it != transactionIds.end()));
+            BOOST_TEST(it->second == transaction->getId());
+        }
+    }
+
+    // removed transactions are removed from index
+    uint64_t shortTransactionId = ShortTransactionIds::calculateValue(salt, transactions[0]->getId());
+    pendingTransactions.removeTransactions({ transactions[0]->getId() });
+    BOOST_TEST(pendingTransactions.getTransactionIds(salt, { shortTransactionId }).empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END();
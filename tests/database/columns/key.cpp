@@ -0,0 +1,50 @@
+#include "pch.h"
+
+#include <boost/test/unit_test.hpp>
+#include <database/columns/key.h>
+
+using namespace logpass;
+using namespace logpass::database;
+
+BOOST_AUTO_TEST_SUITE(columns);
+BOOST_AUTO_TEST_SUITE(key);
+
+BOOST_AUTO_TEST_CASE(max_size)
+{
+    static_assert(Key<uint32_t>::MAX_SIZE == 4);
+    static_assert(Key<uint32_t, uint8_t, uint8_t>::MAX_SIZE == 6);
+    static_assert(Key<UserId, uint32_t>::MAX_SIZE == UserId::SIZE + 4);
+    static_assert(Key<KeyString<16>, KeyString<255>>::MAX_SIZE == 17 + 256);
+}
+
+BOOST_AUTO_TEST_CASE(the_same_as_serializer)
+{
+    UserId userId(PublicKey::generateRandom());
+    uint32_t page = boost::endian::endian_reverse(12345u);
+
+    // keys must be the same as the ones already saved in database
+    Serializer s1;
+    s1(userId);
+    s1(page);
+    Key<UserId, uint32_t> key1(userId, page);
+    BOOST_TEST(std::string_view(s1) == std::string_view(key1.data(), key1.size()));
+
+    Serializer s2;
+    s2.serialize<uint8_t>("PREFIX"s);
+    s2.serialize<uint8_t>("key"s);
+    Key<KeyString<16>, KeyString<255>> key2("PREFIX", "key");
+    BOOST_TEST(std::string_view(s2) == std::string_view(key2.data(), key2.size()));
+
+    // key built from shorter key
+    Serializer s3;
+    s3.serialize<uint8_t>("PREFIX"s);
+    s3.put<uint8_t>(0);
+    s3.put<uint32_t>(page);
+    Key<KeyString<16>, uint8_t, uint32_t> key3(Key<KeyString<16>, uint8_t>("PREFIX", 0));
+    key3.put(page);
+    BOOST_TEST(std::string_view(s3) == std::string_view(key3.data(), key3.size()));
+    BOOST_TEST(((rocksdb::Slice)key3).size() == 1 + 6 + 1 + 4);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
+BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,113 @@
+#include "pch.h"
+
+#include <boost/test/unit_test.hpp>
+#include <database/columns/transaction_hashes.h>
+#include <database/database_fixture.h>
+
+using namespace logpass;
+using namespace logpass::database;
+
+class TransactionHashesColumnDatabase : public BaseDatabase {
+    friend class SharedThread<TransactionHashesColumnDatabase>;
+public:
+    using BaseDatabase::BaseDatabase;
+
+    void start() override
+    {
+        BaseDatabase::start({
+            { TransactionHashesColumn::getName(), TransactionHashesColumn::getOptions() }
+                            });
+        transactionHashes = std::make_unique<TransactionHashesColumn>(m_db, m_handles[0]);
+        load();
+    }
+
+    void stop() override
+    {
+        BaseDatabase::stop();
+    }
+
+    std::vector<Column*> columns() const override
+    {
+        return {
+            transactionHashes.get()
+        };
+    }
+
+    std::unique_ptr<TransactionHashesColumn> transactionHashes;
+};
+
+BOOST_AUTO_TEST_SUITE(columns);
+BOOST_FIXTURE_TEST_SUITE(transaction_hashes, DatabaseFixture<TransactionHashesColumnDatabase>);
+
+BOOST_AUTO_TEST_CASE(insert_and_lookup)
+{
+    Hash hash1 = Hash::generateRandom();
+    Hash hash2 = Hash::generateRandom();
+
+    db->transactionHashes->addTransactionHashHash(1, hash1);
+    BOOST_TEST_REQUIRE(db->transactionHashes->hasTransactionHash(1, hash1, false));
+    BOOST_TEST_REQUIRE(!db->transactionHashes->hasTransactionHash(1, hash1, true));
+    db->commit(1);
+    BOOST_TEST_REQUIRE(db->transactionHashes->hasTransactionHash(1, hash1, true));
+    BOOST_TEST_REQUIRE(db->transactionHashes->hasTransactionHash(1, hash1, false));
+    // hash is checked only in block of transaction
+    BOOST_TEST_REQUIRE(!db->transactionHashes->hasTransactionHash(2, hash1, true));
+    BOOST_TEST_REQUIRE(!db->transactionHashes->hasTransactionHash(1, hash2, true));
+
+    db->transactionHashes->addTransactionHashHash(1, hash2);
+    db->clear();
+    BOOST_TEST_REQUIRE(!db->transactionHashes->hasTransactionHash(1, hash2, false));
+
+    auto info = db->transactionHashes->getDebugInfo();
+    BOOST_TEST(info["filter"]["blocks"] == 1);
+    BOOST_TEST(info["filter"]["entries"] == 1);
+    BOOST_TEST(info["filter"]["hits"] == 2);
+}
+
+BOOST_AUTO_TEST_CASE(reload)
+{
+    std::vector<Hash> hashes;
+    for (uint32_t blockId = 1; blockId <= 3; ++blockId) {
+        hashes.push_back(Hash::generateRandom());
+        db->transactionHashes->addTransactionHashHash(blockId, hashes.back());
+        db->commit(blockId);
+    }
+
+    // filter is rebuilt from database
+    reinitialize();
+    for (uint32_t blockId = 1; blockId <= 3; ++blockId) {
+        BOOST_TEST_REQUIRE(db->transactionHashes->hasTransactionHash(blockId, hashes[blockId - 1], true));
+        BOOST_TEST_REQUIRE(!db->transactionHashes->hasTransactionHash(blockId, Hash::generateRandom(), true));
+    }
+    BOOST_TEST(db->transactionHashes->getDebugInfo()["filter"]["entries"] == 3);
+}
+
+BOOST_AUTO_TEST_CASE(rollback_truncation)
+{
+    Hash hash1 = Hash::generateRandom();
+    Hash hash2 = Hash::generateRandom();
+    uint32_t lastBlockId = kTransactionMaxBlockIdDifference + 2;
+
+    db->transactionHashes->addTransactionHashHash(1, hash1);
+    for (uint32_t blockId = 1; blockId <= lastBlockId; ++blockId) {
+        if (blockId == lastBlockId) {
+            db->transactionHashes->addTransactionHashHash(blockId, hash2);
+        }
+        db->commit(blockId);
+    }
+
+    // hashes older than kTransactionMaxBlockIdDifference are removed from filter and database
+    BOOST_TEST_REQUIRE(!db->transactionHashes->hasTransactionHash(1, hash1, true));
+    BOOST_TEST_REQUIRE(db->transactionHashes->hasTransactionHash(lastBlockId, hash2, true));
+    BOOST_TEST(db->transactionHashes->getDebugInfo()["filter"]["entries"] == 1);
+
+    // after rollback filter has the same hashes as database
+    BOOST_TEST_REQUIRE(db->rollback(1));
+    BOOST_TEST_REQUIRE(db->transactionHashes->hasTransactionHash(1, hash1, true));
+    BOOST_TEST_REQUIRE(!db->transactionHashes->hasTransactionHash(lastBlockId, hash2, true));
+    BOOST_TEST_REQUIRE(!db->transactionHashes->hasTransactionHash(lastBlockId, hash2, false));
+    BOOST_TEST(db->transactionHashes->getDebugInfo()["filter"]["entries"] == 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
+BOOST_AUTO_TEST_SUITE_END();
@@ -63,4 +63,35 @@ BOOST_AUTO_TEST_CASE(max_rollback)
     BOOST_TEST_REQUIRE(!db->rollback(1));
 }
 
+// exposes protected helpers of base database
+struct TestBaseDatabase : public database::BaseDatabase {
+    using database::BaseDatabase::mergeBatches;
+};
+
+BOOST_AUTO_TEST_CASE(merge_batches)
+{
+    struct Handler : public rocksdb::WriteBatch::Handler {
+        void Put(const rocksdb::Slice& key, const rocksdb::Slice& value) override
+        {
+            entries.emplace_back(key.ToString(), value.ToString());
+        }
+
+        std::vector<std::pair<std::string, std::string>> entries;
+    };
+
+    std::vector<rocksdb::WriteBatch> batches(3);
+    batches[0].Put("key1", "value1");
+    batches[0].Put("key2", "value2");
+    batches[2].Put("key3", "value3");
+
+    auto batch = TestBaseDatabase::mergeBatches(batches);
+    BOOST_TEST_REQUIRE(batch.Count() == 3);
+    Handler handler;
+    BOOST_TEST_REQUIRE(batch.Iterate(&handler).ok());
+    BOOST_TEST_REQUIRE(handler.entries.size() == 3);
+    BOOST_TEST((handler.entries[0] == std::make_pair("key1"s, "value1"s)));
+    BOOST_TEST((handler.entries[1] == std::make_pair("key2"s, "value2"s)));
+    BOOST_TEST((handler.entries[2] == std::make_pair("key3"s, "value3"s)));
+}
+
 BOOST_AUTO_TEST_SUITE_END();
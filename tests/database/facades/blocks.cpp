@@ -102,5 +102,43 @@ BOOST_AUTO_TEST_CASE(basic)
     BOOST_TEST_REQUIRE(db->blocks(true).getLatestBlocks().size() == 2);
 }
 
+BOOST_AUTO_TEST_CASE(iterator)
+{
+    auto key = PrivateKey::generate();
+    MinersQueue nextMiners = { MinerId(key.publicKey()) };
+    std::vector<Block_cptr> blocks;
+    for (uint32_t blockId = 1; blockId <= 5; ++blockId) {
+        std::vector<Transaction_cptr> transactions = {
+            CreateUserTransaction::create(PublicKey::generateRandom(), blockId)->setUserId(key.publicKey())->
+                setPublicKey(key.publicKey())->sign({ key })
+        };
+        auto block = Block::create(blockId, blockId, nextMiners, transactions,
+                                   blocks.empty() ? Hash() : blocks.back()->getHeaderHash(), key);
+        db->transactionsColumn->addTransaction(transactions[0], blockId);
+        db->blocks().addBlock(block);
+        db->commit(blockId);
+        blocks.push_back(block);
+    }
+    // not commited block is not included
+    db->blocks().addBlock(Block::create(6, 6, nextMiners, {}, blocks.back()->getHeaderHash(), key));
+
+    auto iterator = db->blocks().getBlocksIterator(2, 10);
+    for (uint32_t blockId = 2; blockId <= 5; ++blockId) {
+        auto block = iterator->next();
+        BOOST_TEST_REQUIRE(block);
+        BOOST_TEST_REQUIRE(block->getId() == blockId);
+        BOOST_TEST_REQUIRE(block->getHeaderHash() == blocks[blockId - 1]->getHeaderHash());
+        BOOST_TEST_REQUIRE(block->getTransactions() == 1);
+        BOOST_TEST_REQUIRE((*block->begin())->getId() == (*blocks[blockId - 1]->begin())->getId());
+    }
+    BOOST_TEST_REQUIRE(!iterator->next());
+
+    iterator = db->blocks().getBlocksIterator(1, 2);
+    BOOST_TEST_REQUIRE(iterator->next()->getId() == 1);
+    BOOST_TEST_REQUIRE(iterator->next()->getId() == 2);
+    BOOST_TEST_REQUIRE(!iterator->next());
+    iterator = nullptr;
+}
+
 BOOST_AUTO_TEST_SUITE_END();
 BOOST_AUTO_TEST_SUITE_END();
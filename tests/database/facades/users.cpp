@@ -90,5 +90,75 @@ BOOST_AUTO_TEST_CASE(basic)
     BOOST_REQUIRE(user->settings == userUpdate->settings);
 }
 
+BOOST_AUTO_TEST_CASE(cache)
+{
+    User_ptr firstUser = User::create(PublicKey::generateRandom(), UserId(), 1, 1000);
+    db->users().addUser(firstUser);
+    db->commit(1);
+    BOOST_TEST_REQUIRE(db->users(true).getUser(firstUser->id)->tokens == 1000);
+    BOOST_TEST_REQUIRE(db->users(true).getUser(firstUser->id) == db->users(true).getUser(firstUser->id));
+    auto user = db->users().getUser(firstUser->id)->clone(2);
+    user->tokens = 2000;
+    db->users().updateUser(user);
+    BOOST_TEST_REQUIRE(db->users(true).getUser(firstUser->id)->tokens == 1000);
+    db->commit(2);
+    BOOST_TEST_REQUIRE(db->users(true).getUser(firstUser->id)->tokens == 2000);
+    BOOST_TEST_REQUIRE(db->users().getUser(firstUser->id)->tokens == 2000);
+    BOOST_TEST_REQUIRE(db->rollback(1));
+    BOOST_TEST_REQUIRE(db->users(true).getUser(firstUser->id)->tokens == 1000);
+    BOOST_TEST_REQUIRE(db->getDebugInfo()["columns"][UsersColumn::getName()]["cache"]["hits"].get<uint64_t>() > 0);
+}
+
+BOOST_AUTO_TEST_CASE(history_cursor)
+{
+    UserId userId(PublicKey::generateRandom());
+    auto addHistory = [&](uint32_t from, uint32_t to) {
+        for (uint32_t i = from; i < to; ++i) {
+            db->users().addUserHistory(userId, i / UserHistoryColumn::PAGE_SIZE,
+                                       UserHistory(i + 1, UserHistoryType::UPDATE, TransactionId()));
+        }
+    };
+    // entries are identified by block id, which is index + 1
+    auto blockIds = [](const std::vector<UserHistory>& history) {
+        std::vector<uint32_t> ids;
+        for (auto& entry : history) {
+            ids.push_back(entry.blockId);
+        }
+        return ids;
+    };
+
+    addHistory(0, 150);
+    db->commit(1);
+    addHistory(150, 250);
+    db->commit(2);
+    addHistory(250, 260);
+
+    // across page boundaries
+    auto history = db->users(true).getUserHistory(userId, 95, 10, false);
+    BOOST_TEST(blockIds(history) == std::vector<uint32_t>({ 96, 97, 98, 99, 100, 101, 102, 103, 104, 105 }));
+    history = db->users(true).getUserHistory(userId, 203, 5, true);
+    BOOST_TEST(blockIds(history) == std::vector<uint32_t>({ 204, 203, 202, 201, 200 }));
+
+    // the newest entries
+    history = db->users(true).getUserHistory(userId, 249, 3, true);
+    BOOST_TEST(blockIds(history) == std::vector<uint32_t>({ 250, 249, 248 }));
+    history = db->users(true).getUserHistory(userId, 245, 100, false);
+    BOOST_TEST(history.size() == 5);
+
+    // unconfirmed entries are included only in unconfirmed state
+    history = db->users().getUserHistory(userId, 259, 12, true);
+    BOOST_TEST(history.size() == 12);
+    BOOST_TEST(history.front().blockId == 260);
+    BOOST_TEST(history.back().blockId == 249);
+    history = db->users().getUserHistory(userId, 245, 100, false);
+    BOOST_TEST(history.size() == 15);
+
+    // the oldest entries
+    history = db->users(true).getUserHistory(userId, 2, 10, true);
+    BOOST_TEST(blockIds(history) == std::vector<uint32_t>({ 3, 2, 1 }));
+    history = db->users(true).getUserHistory(userId, 0, 300, false);
+    BOOST_TEST(history.size() == 250);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
 BOOST_AUTO_TEST_SUITE_END();
@@ -315,4 +315,53 @@ BOOST_AUTO_TEST_CASE(uint64_array_with_offset)
     BOOST_TEST_REQUIRE(arr1[4] == arr2[4]);
 }
 
+BOOST_AUTO_TEST_CASE(view)
+{
+    Serializer s;
+    s.put<uint32_t>(0xAABBCCDD);
+    s.put<std::string>("test"s);
+    s.switchToReader();
+
+    auto value = std::make_shared<rocksdb::PinnableSlice>();
+    value->PinSelf((rocksdb::Slice)s);
+    Serializer view(std::const_pointer_cast<const rocksdb::PinnableSlice>(value));
+    value = nullptr;
+    BOOST_TEST_REQUIRE(view.view());
+    BOOST_TEST_REQUIRE(view.size() == s.size());
+    BOOST_TEST_REQUIRE(view.get<uint32_t>() == 0xAABBCCDD);
+    BOOST_TEST_REQUIRE(view.get<std::string>() == "test"s);
+    BOOST_TEST_REQUIRE(view.eof());
+    BOOST_REQUIRE_THROW(view.get<uint8_t>(), SerializerException);
+
+    Serializer view2(std::move(view));
+    BOOST_TEST_REQUIRE(view2.view());
+    view2.rewind();
+    BOOST_TEST_REQUIRE(view2.get<uint32_t>() == 0xAABBCCDD);
+}
+
+BOOST_AUTO_TEST_CASE(view_nested_in_writer)
+{
+    Serializer s;
+    s.put<uint32_t>(0xAABBCCDD);
+    s.put<std::string>("test"s);
+    s.switchToReader();
+
+    auto value = std::make_shared<rocksdb::PinnableSlice>();
+    value->PinSelf((rocksdb::Slice)s);
+    Serializer view(std::const_pointer_cast<const rocksdb::PinnableSlice>(value));
+    BOOST_TEST_REQUIRE(view.view());
+
+    Serializer writer;
+    writer(view);
+    writer.switchToReader();
+    Serializer nested;
+    writer(nested);
+    BOOST_TEST_REQUIRE(writer.eof());
+    BOOST_TEST_REQUIRE(!nested.view());
+    BOOST_TEST_REQUIRE(std::string_view(nested) == std::string_view(s));
+    nested.switchToReader();
+    BOOST_TEST_REQUIRE(nested.get<uint32_t>() == 0xAABBCCDD);
+    BOOST_TEST_REQUIRE(nested.get<std::string>() == "test"s);
+}
+
 BOOST_AUTO_TEST_SUITE_END();